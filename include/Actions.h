@@ -0,0 +1,25 @@
+#ifndef ACTIONS_H
+#define ACTIONS_H
+
+#include <vector>
+
+// Valores esperados (Ejemplo: motores encendidos o apagados según una regla)
+// Índices: 0 = Adelante, 1 = Atrás, 2 = Izquierda, 3 = Derecha
+extern const std::vector<std::vector<float>> targetOptions;
+
+/**
+ * @brief Devuelve el índice de la opción de `targetOptions` más cercana (distancia
+ *        euclidiana) a la salida de la red.
+ * @param input Salida de la red (4 valores, uno por motor).
+ * @param targetOptions Opciones candidatas.
+ * @return Índice de la opción más cercana, o -1 si la entrada no es válida.
+ */
+int findClosestMatch(const std::vector<float>& input, const std::vector<std::vector<float>>& targetOptions);
+
+/**
+ * @brief Versión sin vectores de `findClosestMatch` para el bucle principal.
+ * @param input Puntero a 4 floats (salida de la red).
+ */
+int findClosestMatch(const float* input, const std::vector<std::vector<float>>& targetOptions);
+
+#endif // ACTIONS_H
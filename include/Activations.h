@@ -0,0 +1,220 @@
+#ifndef ACTIVATIONS_H
+#define ACTIVATIONS_H
+
+#include <cmath>
+
+/**
+ * @brief Enumeración de funciones de activación disponibles.
+ */
+enum class ActivationFunction {
+    RELU,
+    SIGMOID,
+    TANH,
+    LINEAR
+};
+
+/**
+ * @brief Implementación de SIGMOID y TANH (RELU y LINEAR son siempre exactas).
+ *
+ * Error absoluto máximo frente a `std::exp` / `std::tanh`, medido en todo el eje real:
+ * - EXACT:    libm; solo el redondeo de float (~1e-7).
+ * - LUT:      tabla de 257 puntos en [0, 10] con interpolación lineal y simetría;
+ *             sigmoid 4.6e-5, tanh 9.1e-5.
+ * - RATIONAL: fracción continua de Lambert de 7º orden para tanh, saturada en |x| > 4.97;
+ *             sigmoid 4.9e-5, tanh 9.7e-5. Sin tablas ni divisiones extra.
+ * - HARD:     rectas saturadas, clamp(0.2x + 0.5, 0, 1) y clamp(x, -1, 1);
+ *             sigmoid 0.076, tanh 0.24. La más barata, pero cambia las salidas.
+ */
+enum class ActivationMode {
+    EXACT,
+    LUT,
+    RATIONAL,
+    HARD
+};
+
+const int SIGMOID_LUT_SIZE = 256;
+const float SIGMOID_LUT_RANGE = 10.0f;
+
+/** @brief sigmoid en [0, SIGMOID_LUT_RANGE], definida en Activations.cpp. */
+extern const float SIGMOID_LUT[SIGMOID_LUT_SIZE + 1];
+
+/**
+ * @brief Función ReLU (Rectified Linear Unit).
+ */
+static inline float relu(float x) {
+    return (x > 0.0f) ? x : 0.0f;
+}
+
+/**
+ * @brief Función Sigmoid.
+ */
+static inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+/**
+ * @brief Función Tanh.
+ */
+static inline float tanh_custom(float x) {
+    return std::tanh(x);
+}
+
+/**
+ * @brief Función Linear.
+ */
+static inline float linear(float x) {
+    return x;
+}
+
+/**
+ * @brief Sigmoid por tabla: sigmoid(-x) = 1 - sigmoid(x), así la tabla solo cubre x >= 0.
+ */
+static inline float sigmoid_lut(float x) {
+    float a = std::fabs(x);
+    float y = 1.0f;
+    if (a < SIGMOID_LUT_RANGE) {
+        float position = a * (SIGMOID_LUT_SIZE / SIGMOID_LUT_RANGE);
+        int i = static_cast<int>(position);
+        float frac = position - i;
+        y = SIGMOID_LUT[i] + frac * (SIGMOID_LUT[i + 1] - SIGMOID_LUT[i]);
+    }
+    return (x < 0.0f) ? 1.0f - y : y;
+}
+
+/**
+ * @brief Tanh por tabla: tanh(x) = 2 * sigmoid(2x) - 1.
+ */
+static inline float tanh_lut(float x) {
+    return 2.0f * sigmoid_lut(2.0f * x) - 1.0f;
+}
+
+/**
+ * @brief Tanh racional (fracción continua de Lambert truncada).
+ */
+static inline float tanh_rational(float x) {
+    if (x > 4.97f) return 1.0f;
+    if (x < -4.97f) return -1.0f;
+    float x2 = x * x;
+    float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+    float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+    return num / den;
+}
+
+/**
+ * @brief Sigmoid racional: sigmoid(x) = 0.5 + 0.5 * tanh(x / 2).
+ */
+static inline float sigmoid_rational(float x) {
+    return 0.5f + 0.5f * tanh_rational(0.5f * x);
+}
+
+static inline float hard_sigmoid(float x) {
+    float y = 0.2f * x + 0.5f;
+    return (y < 0.0f) ? 0.0f : (y > 1.0f) ? 1.0f : y;
+}
+
+static inline float hard_tanh(float x) {
+    return (x < -1.0f) ? -1.0f : (x > 1.0f) ? 1.0f : x;
+}
+
+/**
+ * @brief Helper para aplicar la función de activación según el enum.
+ *        Con `func` constante en tiempo de compilación el switch desaparece.
+ */
+static inline float applyActivation(float x, ActivationFunction func) {
+    switch (func) {
+        case ActivationFunction::RELU:
+            return relu(x);
+        case ActivationFunction::SIGMOID:
+            return sigmoid(x);
+        case ActivationFunction::TANH:
+            return tanh_custom(x);
+        case ActivationFunction::LINEAR:
+        default:
+            return linear(x);
+    }
+}
+
+/**
+ * @brief Como `applyActivation`, con la implementación elegida para SIGMOID y TANH.
+ */
+static inline float applyActivation(float x, ActivationFunction func, ActivationMode mode) {
+    if (func == ActivationFunction::SIGMOID) {
+        switch (mode) {
+            case ActivationMode::LUT:      return sigmoid_lut(x);
+            case ActivationMode::RATIONAL: return sigmoid_rational(x);
+            case ActivationMode::HARD:     return hard_sigmoid(x);
+            case ActivationMode::EXACT:
+            default:                       return sigmoid(x);
+        }
+    }
+    if (func == ActivationFunction::TANH) {
+        switch (mode) {
+            case ActivationMode::LUT:      return tanh_lut(x);
+            case ActivationMode::RATIONAL: return tanh_rational(x);
+            case ActivationMode::HARD:     return hard_tanh(x);
+            case ActivationMode::EXACT:
+            default:                       return tanh_custom(x);
+        }
+    }
+    return applyActivation(x, func);
+}
+
+/**
+ * @brief Aplica la activación a `n` valores. Los switch se resuelven una vez por
+ *        llamada, no por elemento.
+ */
+template <typename F>
+static inline void activateEach(float* x, int n, F f) {
+    for (int i = 0; i < n; i++) {
+        x[i] = f(x[i]);
+    }
+}
+
+static inline void applyActivation(float* x, int n, ActivationFunction func, ActivationMode mode) {
+    switch (func) {
+        case ActivationFunction::RELU:
+            activateEach(x, n, relu);
+            return;
+        case ActivationFunction::SIGMOID:
+            switch (mode) {
+                case ActivationMode::LUT:      activateEach(x, n, sigmoid_lut); return;
+                case ActivationMode::RATIONAL: activateEach(x, n, sigmoid_rational); return;
+                case ActivationMode::HARD:     activateEach(x, n, hard_sigmoid); return;
+                case ActivationMode::EXACT:
+                default:                       activateEach(x, n, sigmoid); return;
+            }
+        case ActivationFunction::TANH:
+            switch (mode) {
+                case ActivationMode::LUT:      activateEach(x, n, tanh_lut); return;
+                case ActivationMode::RATIONAL: activateEach(x, n, tanh_rational); return;
+                case ActivationMode::HARD:     activateEach(x, n, hard_tanh); return;
+                case ActivationMode::EXACT:
+                default:                       activateEach(x, n, tanh_custom); return;
+            }
+        case ActivationFunction::LINEAR:
+        default:
+            return;
+    }
+}
+
+/**
+ * @brief Derivada de la activación expresada en función de su salida `y = f(x)`.
+ *        Así la retropropagación solo necesita las activaciones ya guardadas.
+ *        Con un `ActivationMode` aproximado se usa la misma fórmula, evaluada
+ *        en la salida aproximada.
+ */
+static inline float activationDerivative(float y, ActivationFunction func) {
+    switch (func) {
+        case ActivationFunction::RELU:
+            return (y > 0.0f) ? 1.0f : 0.0f;
+        case ActivationFunction::SIGMOID:
+            return y * (1.0f - y);
+        case ActivationFunction::TANH:
+            return 1.0f - y * y;
+        case ActivationFunction::LINEAR:
+        default:
+            return 1.0f;
+    }
+}
+
+#endif // ACTIVATIONS_H
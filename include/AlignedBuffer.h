@@ -0,0 +1,109 @@
+#ifndef ALIGNED_BUFFER_H
+#define ALIGNED_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @class AlignedBuffer
+ * @brief Bloque de `T` de tamaño fijo, alineado a `Alignment` bytes (una línea de
+ *        caché y un registro AVX-512 con 64).
+ *
+ * - Copiar a un buffer del mismo tamaño reutiliza su memoria, así que los punteros
+ *   a `data()` siguen siendo válidos (p.ej. los de un `Trainer` a los gradientes).
+ * - `assign` solo reserva si cambia el tamaño.
+ * - Reserva `Alignment - 1` bytes de más y alinea el puntero a mano: el `new`
+ *   alineado es de C++17 y el ESP32 compila con gnu++11.
+ */
+template <typename T, size_t Alignment = 64>
+class AlignedBuffer {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer solo admite tipos triviales.");
+
+    AlignedBuffer() = default;
+
+    AlignedBuffer(size_t size, const T& value) { assign(size, value); }
+
+    AlignedBuffer(const AlignedBuffer& other) { *this = other; }
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept
+        : m_raw(other.m_raw), m_data(other.m_data), m_size(other.m_size) {
+        other.m_raw = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    ~AlignedBuffer() { reset(); }
+
+    AlignedBuffer& operator=(const AlignedBuffer& other) {
+        if (this != &other) {
+            resize(other.m_size);
+            std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        }
+        return *this;
+    }
+
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_raw = other.m_raw;
+            m_data = other.m_data;
+            m_size = other.m_size;
+            other.m_raw = nullptr;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    /** @brief `size` elementos con `value`. */
+    void assign(size_t size, const T& value) {
+        resize(size);
+        std::fill(m_data, m_data + m_size, value);
+    }
+
+    /** @brief Libera la memoria (el buffer queda vacío). */
+    void reset() {
+        delete[] m_raw;
+        m_raw = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /** @brief Bytes reservados, con la holgura de alineación. */
+    size_t bytes() const { return m_raw != nullptr ? m_size * sizeof(T) + Alignment - 1 : 0; }
+
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+private:
+    // Sin conservar el contenido: los llamadores siempre lo sobrescriben
+    void resize(size_t size) {
+        if (size == m_size) {
+            return;
+        }
+        reset();
+        if (size > 0) {
+            m_raw = new char[size * sizeof(T) + Alignment - 1];
+            uintptr_t address = reinterpret_cast<uintptr_t>(m_raw);
+            address = (address + Alignment - 1) & ~static_cast<uintptr_t>(Alignment - 1);
+            m_data = reinterpret_cast<T*>(address);
+            m_size = size;
+        }
+    }
+
+    static_assert((Alignment & (Alignment - 1)) == 0, "La alineación debe ser potencia de dos.");
+
+    char* m_raw = nullptr;  // Bloque reservado; `m_data` apunta dentro de él
+    T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+#endif // ALIGNED_BUFFER_H
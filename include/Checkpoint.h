@@ -0,0 +1,264 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+class NeuralNetwork;
+
+/**
+ * Registro de puntos de control (versión 1, little-endian). El almacenamiento tiene
+ * dos regiones iguales; cada una es un registro de solo añadido:
+ *
+ *   0  char[4]   magic "RNCK"
+ *   4  uint16    versión (1)
+ *   6  uint16    reservado (0)
+ *   8  uint32    generación (la región válida con la mayor es la actual)
+ *  12  uint32    número de parámetros
+ *  16  uint32    CRC-32 de los 16 bytes anteriores
+ *
+ * Después, registros con una cabecera de 12 bytes:
+ *
+ *   0  uint8     tipo (1 = base, 2 = delta XOR, 3 = delta cuantizado)
+ *   1  uint8[3]  reservado (0)
+ *   4  uint32    bytes de la carga útil
+ *   8  uint32    CRC-32 de la cabecera (con este campo a 0) y de la carga útil
+ *
+ * - Base: todos los parámetros en float, con el orden plano de `copyParameters`.
+ *   Es siempre el primer registro de la región, y sustituye a un delta cuando
+ *   este no ocuparía menos.
+ * - Delta XOR (sin pérdidas): varint con el número de parámetros cambiados y, por
+ *   cada uno, varint del salto de índice y varint del XOR de los bits del float.
+ * - Delta cuantizado: float con el paso, varint con el número de cambios y, por
+ *   cada uno, varint del salto de índice y varint zigzag de `round(diferencia / paso)`.
+ *
+ * Los bytes borrados valen 0xFF (como la flash). La restauración se detiene en el
+ * primer registro con CRC incorrecto, así que una escritura interrumpida solo
+ * pierde el último punto de control.
+ */
+static const char CHECKPOINT_MAGIC[4] = {'R', 'N', 'C', 'K'};
+static const uint16_t CHECKPOINT_VERSION = 1;
+
+/**
+ * @class CheckpointStorage
+ * @brief Medio de dos regiones con semántica de flash: solo se escribe sobre bytes
+ *        borrados (0xFF) y se borra por sectores.
+ */
+class CheckpointStorage {
+public:
+    virtual ~CheckpointStorage() = default;
+
+    /** @brief Bytes de cada región (0 si el medio no está disponible). */
+    virtual size_t regionSize() const = 0;
+
+    /** @brief Unidad de borrado; `regionSize()` es múltiplo de ella. */
+    virtual size_t sectorSize() const = 0;
+
+    virtual bool read(int region, size_t offset, void* data, size_t size) = 0;
+    virtual bool write(int region, size_t offset, const void* data, size_t size) = 0;
+    virtual bool eraseSector(int region, size_t sector) = 0;
+};
+
+/**
+ * @brief Duración de las operaciones de flash que imita `MemoryCheckpointStorage`.
+ *        Por defecto, valores típicos de la flash SPI del ESP32.
+ */
+struct FlashTiming {
+    unsigned long eraseSectorUs = 45000;  // Borrar un sector de 4 KB
+    unsigned long pageProgramUs = 700;    // Programar una página de 256 bytes (o parte)
+    // Consume el tiempo (p.ej. `delayMicroseconds` sobre el reloj simulado);
+    // nullptr = las operaciones no cuestan nada
+    void (*wait)(unsigned long us) = nullptr;
+};
+
+/**
+ * @class MemoryCheckpointStorage
+ * @brief Regiones en RAM: no sobreviven a un reinicio. Para el simulador y pruebas;
+ *        con `FlashTiming::wait`, cada borrado y escritura tarda lo que en la flash.
+ */
+class MemoryCheckpointStorage : public CheckpointStorage {
+public:
+    MemoryCheckpointStorage(size_t regionSize, size_t sectorSize = 4096,
+                            const FlashTiming& timing = FlashTiming());
+
+    size_t regionSize() const override { return m_regionSize; }
+    size_t sectorSize() const override { return m_sectorSize; }
+    bool read(int region, size_t offset, void* data, size_t size) override;
+    bool write(int region, size_t offset, const void* data, size_t size) override;
+    bool eraseSector(int region, size_t sector) override;
+
+private:
+    size_t m_regionSize;
+    size_t m_sectorSize;
+    FlashTiming m_timing;
+    std::vector<uint8_t> m_regions[2];
+};
+
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+/**
+ * @class FileCheckpointStorage
+ * @brief Cada región es un archivo de `regionSize` bytes (se crea borrado si no
+ *        existe). Cada escritura se vacía al sistema de archivos con `fflush`.
+ */
+class FileCheckpointStorage : public CheckpointStorage {
+public:
+    FileCheckpointStorage(const char* pathA, const char* pathB, size_t regionSize,
+                          size_t sectorSize = 4096);
+    ~FileCheckpointStorage();
+
+    FileCheckpointStorage(const FileCheckpointStorage&) = delete;
+    FileCheckpointStorage& operator=(const FileCheckpointStorage&) = delete;
+
+    size_t regionSize() const override { return m_regionSize; }
+    size_t sectorSize() const override { return m_sectorSize; }
+    bool read(int region, size_t offset, void* data, size_t size) override;
+    bool write(int region, size_t offset, const void* data, size_t size) override;
+    bool eraseSector(int region, size_t sector) override;
+
+private:
+    size_t m_regionSize;
+    size_t m_sectorSize;
+    FILE* m_files[2] = {nullptr, nullptr};
+};
+#endif
+
+#ifdef ESP_PLATFORM
+/**
+ * @class PartitionCheckpointStorage
+ * @brief Regiones en dos particiones de datos de la flash; las del vehículo están
+ *        en partitions.csv (`board_build.partitions` en platformio.ini):
+ *   ckpt_a, data, 0x41, 0x3F8000, 0x4000
+ *   ckpt_b, data, 0x41, 0x3FC000, 0x4000
+ * Si falta alguna, `regionSize()` es 0 y el registro queda desactivado (el
+ * vehículo arranca igual, con los pesos de `pesos_red_neuronal.h`); main.cpp lo
+ * avisa por el puerto serie al arrancar.
+ */
+class PartitionCheckpointStorage : public CheckpointStorage {
+public:
+    PartitionCheckpointStorage(const char* labelA, const char* labelB);
+
+    size_t regionSize() const override { return m_regionSize; }
+    size_t sectorSize() const override;
+    bool read(int region, size_t offset, void* data, size_t size) override;
+    bool write(int region, size_t offset, const void* data, size_t size) override;
+    bool eraseSector(int region, size_t sector) override;
+
+private:
+    const void* m_partitions[2] = {nullptr, nullptr};  // const esp_partition_t*
+    size_t m_regionSize = 0;
+};
+#endif
+
+/**
+ * @brief Codificación de los deltas.
+ */
+enum class DeltaEncoding {
+    XOR,       // Sin pérdidas: se restauran exactamente los mismos bits
+    QUANTIZED  // Diferencias en múltiplos de `quantStep`; error <= quantStep / 2 por parámetro
+};
+
+struct CheckpointConfig {
+    DeltaEncoding encoding = DeltaEncoding::XOR;
+    float quantStep = 1e-4f;        // Solo QUANTIZED
+    float compactThreshold = 0.5f;  // Fracción de la región usada que dispara la compactación
+    size_t chunkBytes = 512;        // Trabajo máximo de cada `compactStep`
+};
+
+struct CheckpointStats {
+    uint32_t checkpoints = 0;   // Puntos de control escritos (con algún cambio)
+    uint32_t deferred = 0;      // Pospuestos por una compactación en curso
+    uint32_t compactions = 0;   // Compactaciones completadas
+    uint64_t bytesWritten = 0;  // Total, incluidas cabeceras y compactaciones
+    size_t lastBytes = 0;       // Bytes del último punto de control
+};
+
+/**
+ * @class CheckpointLog
+ * @brief Persiste los parámetros aprendidos en línea como deltas respecto al último
+ *        estado guardado, en un registro de solo añadido con CRC.
+ *
+ * - `checkpoint` solo escribe los parámetros cambiados desde el estado que se
+ *   restauraría en ese momento (los errores de cuantización no se acumulan).
+ * - Cuando la región se llena más allá de `compactThreshold`, se prepara en la otra
+ *   región una base con el estado actual. `compactStep` avanza ese trabajo por
+ *   trozos (un sector borrado o `chunkBytes` escritos) para llamarlo en los ratos
+ *   libres de `loop()`; mientras tanto los puntos de control se posponen. La nueva
+ *   región solo pasa a ser la actual cuando su base está completa y su CRC es
+ *   válido, así que un corte de corriente en medio deja la anterior intacta.
+ * - Toda la memoria se reserva en el constructor.
+ */
+class CheckpointLog {
+public:
+    CheckpointLog(CheckpointStorage& storage, size_t parameterCount,
+                  const CheckpointConfig& config = CheckpointConfig());
+
+    /**
+     * @brief Carga en `network` el último estado guardado.
+     * @return false si no hay ninguna región válida (la red no se modifica).
+     */
+    bool restore(NeuralNetwork& network);
+
+    /**
+     * @brief Empieza un registro nuevo cuya base es el estado actual de `network`
+     *        (p.ej. en el primer arranque). Se completa con `compactStep`.
+     */
+    void reset(const NeuralNetwork& network);
+
+    /**
+     * @brief Añade un delta con los parámetros que cambiaron.
+     * @return false si se pospuso (compactación en curso o medio no disponible).
+     */
+    bool checkpoint(const NeuralNetwork& network);
+
+    /**
+     * @brief Avanza la compactación pendiente, si la hay.
+     * @return true si no queda trabajo pendiente.
+     */
+    bool compactStep();
+
+    /** @brief Hay una región válida en la que se pueden añadir deltas. */
+    bool ready() const { return m_active >= 0 && !m_compacting; }
+
+    /** @brief Bytes usados de la región actual. */
+    size_t usedBytes() const { return m_offset; }
+
+    const CheckpointStats& stats() const { return m_stats; }
+
+private:
+    enum RecordType : uint8_t { RECORD_BASE = 1, RECORD_XOR = 2, RECORD_QUANTIZED = 3 };
+    static const size_t HEADER_SIZE = 20;
+    static const size_t RECORD_HEADER_SIZE = 12;
+
+    bool readHeader(int region, uint32_t& generation);
+    bool readRecord(int region, size_t offset, uint8_t& type, size_t& payloadSize);
+    bool applyDelta(uint8_t type, const uint8_t* payload, size_t size);
+    size_t encodeDelta(const NeuralNetwork& network);
+    bool appendRecord(uint8_t type, size_t payloadSize);
+    void startCompaction();
+
+    CheckpointStorage& m_storage;
+    size_t m_parameterCount;
+    CheckpointConfig m_config;
+    CheckpointStats m_stats;
+
+    // Estado que devolvería `restore` ahora mismo
+    std::vector<float> m_persisted;
+    std::vector<float> m_current;
+    // Cabecera de registro + carga útil del peor caso
+    std::vector<uint8_t> m_record;
+
+    int m_active = -1;          // Región actual (-1 = ninguna)
+    uint32_t m_generation = 0;  // Generación de la región actual
+    size_t m_offset = 0;        // Siguiente byte libre de la región actual
+
+    // Compactación por pasos hacia la otra región
+    bool m_compacting = false;
+    int m_target = 0;
+    size_t m_nextSector = 0;     // Sectores ya borrados
+    size_t m_written = 0;        // Bytes de cabecera + base ya escritos
+    uint32_t m_baseCrc = 0;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,15 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, polinomio reflejado 0xEDB88320).
+ * @param data Bytes a procesar.
+ * @param size Número de bytes.
+ * @param crc CRC previo para calcularlo por partes (0 al empezar).
+ */
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+#endif // CRC32_H
@@ -3,12 +3,105 @@
 
 #include <Arduino.h>
 
+/**
+ * @class HCSR04
+ * @brief Sensor ultrasónico HC-SR04.
+ *
+ * Dos formas de medir:
+ * - `medirDistancia()`: bloqueante, espera el eco con `pulseIn` (hasta 30 ms).
+ * - Asíncrona: `begin()` registra una interrupción en el pin ECHO que marca los
+ *   flancos con `micros()`; `iniciarMedicion()` solo emite el pulso de disparo
+ *   (~12 us) y `actualizar()` comprueba el timeout. El resultado queda disponible
+ *   cuando `medicionLista()` es verdadero.
+ *
+ * Para varios sensores, `RangingScheduler` los dispara de uno en uno para que
+ * el eco de uno no lo reciba otro.
+ */
 class HCSR04 {
 private:
+    enum Estado : uint8_t { INACTIVO, ESPERANDO_SUBIDA, ESPERANDO_BAJADA, LISTO };
+
     int trigPin, echoPin;
+
+    // Compartidos con la interrupción
+    volatile Estado estado;
+    volatile unsigned long inicioEco;
+    volatile unsigned long finEco;
+    unsigned long inicioDisparo;
+    float ultimaDistancia;
+
+    static void IRAM_ATTR isrEco(void* arg);
+    static float distanciaDesdeDuracion(unsigned long duracion);
+
 public:
+    static const unsigned long TIMEOUT_US = 30000;
+
     HCSR04(int trigPin, int echoPin);
     float medirDistancia();
+
+    /**
+     * @brief Registra la interrupción del pin ECHO. Llamar desde setup(), no desde
+     *        un constructor global.
+     */
+    void begin();
+
+    /**
+     * @brief Emite el pulso de disparo. Devuelve false si hay una medición en curso.
+     */
+    bool iniciarMedicion();
+
+    /**
+     * @brief Cierra la medición si se superó el timeout sin eco. No bloquea.
+     */
+    void actualizar();
+
+    bool ocupado() const { return estado == ESPERANDO_SUBIDA || estado == ESPERANDO_BAJADA; }
+    bool medicionLista() const { return estado == LISTO; }
+
+    /**
+     * @brief Consume el resultado de la última medición asíncrona.
+     * @return Distancia en cm, o -1 si no hubo eco o está fuera de rango.
+     */
+    float leerDistancia();
+};
+
+/**
+ * @class RangingScheduler
+ * @brief Reparte las mediciones de varios HC-SR04 sin bloquear el bucle.
+ *
+ * Dispara los sensores en turno rotatorio: el siguiente no se dispara hasta que
+ * el anterior recibe su eco (o agota el timeout) y pasa un tiempo de guarda, así
+ * los ecos no se cruzan. `poll()` se llama en cada iteración de loop() y cuesta
+ * unos microsegundos; `distance(i)` devuelve la última lectura completa.
+ */
+class RangingScheduler {
+public:
+    static const int MAX_SENSORS = 4;
+
+    /**
+     * @param guardUs Espera entre el fin de una medición y el siguiente disparo.
+     */
+    RangingScheduler(HCSR04* const* sensors, int count, unsigned long guardUs = 5000);
+
+    void begin();
+    void poll();
+
+    float distance(int index) const { return m_distances[index]; }
+
+    /**
+     * @brief Número de rondas completas (todos los sensores medidos).
+     */
+    unsigned long cycles() const { return m_cycles; }
+
+private:
+    HCSR04* m_sensors[MAX_SENSORS];
+    float m_distances[MAX_SENSORS];
+    int m_count;
+    int m_current;
+    unsigned long m_guardUs;
+    unsigned long m_lastDone;
+    unsigned long m_cycles;
+    bool m_waitingGuard;
 };
 
 #endif // HCSR04_H
@@ -0,0 +1,99 @@
+#ifndef INFERENCE_CACHE_H
+#define INFERENCE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "NeuralNetwork.h"
+
+/**
+ * @brief Contadores de `InferenceCache`.
+ */
+struct InferenceCacheStats {
+    uint32_t lookups;
+    uint32_t hits;           // Sin `forward` ni `findClosestMatch`
+    uint32_t misses;
+    uint32_t invalidations;  // Consultas que encontraron la red cambiada desde la anterior
+    uint32_t evictions;      // Entradas válidas sustituidas por falta de sitio
+
+    float hitRate() const { return lookups ? static_cast<float>(hits) / lookups : 0.0f; }
+};
+
+/**
+ * @class InferenceCache
+ * @brief Memoriza la salida de la red y la acción elegida para las entradas
+ *        recientes, cuantizadas a una resolución por entrada.
+ *
+ * - La entrada se redondea al múltiplo más cercano de `resolution[i]` y la red se
+ *   evalúa sobre ese valor, así que un acierto devuelve exactamente lo mismo que un
+ *   fallo: el resultado solo depende de la celda, no del orden de las consultas.
+ * - Tabla de tamaño fijo (potencia de dos) con sondeo lineal de `kProbes` huecos;
+ *   si están todos ocupados se sustituye el menos usado recientemente. Toda la
+ *   memoria se reserva en el constructor.
+ * - Cada entrada guarda `network.parameterVersion()`: cualquier cambio de pesos o
+ *   activaciones (`setWeights`, `updateWeights`, `backward`...) invalida la tabla
+ *   entera sin recorrerla. Con entrenamiento en línea tras cada inferencia la red
+ *   cambia en cada ciclo y la caché no acierta nunca: solo compensa con la red fija.
+ * - Usa `forward`, no `forwardTrain`: no deja activaciones para un `backward`.
+ */
+class InferenceCache {
+public:
+    static const size_t kProbes = 4;
+
+    /**
+     * @param network Red a memorizar; debe vivir más que la caché.
+     * @param resolution Paso de cuantización de cada entrada (`layers.front()`
+     *        valores > 0), p.ej. {1, 1, 0.25, 0.25}: 1 cm y 0.25 s.
+     * @param capacity Entradas de la tabla; se redondea a potencia de dos.
+     * @param actions Opciones para `findClosestMatch` (la red debe tener 4 salidas),
+     *        o nullptr para no decodificar acciones.
+     */
+    InferenceCache(NeuralNetwork& network, const std::vector<float>& resolution,
+                   size_t capacity = 64,
+                   const std::vector<std::vector<float>>* actions = nullptr);
+
+    /**
+     * @brief Salida de la red y acción para `input`, de la tabla si la celda ya se
+     *        evaluó con los parámetros actuales.
+     * @param output `layers.back()` floats.
+     * @return Índice de la acción, o -1 sin `actions`.
+     */
+    int infer(const float* input, float* output);
+
+    /** @brief Vacía la tabla (los contadores se conservan). */
+    void clear();
+
+    const InferenceCacheStats& stats() const { return m_stats; }
+    void resetStats();
+
+    size_t capacity() const { return m_versions.size(); }
+
+    /** @brief Bytes reservados por la tabla. */
+    size_t memoryBytes() const;
+
+private:
+    NeuralNetwork& m_network;
+    const std::vector<std::vector<float>>* m_actions;
+    size_t m_inputSize;
+    size_t m_outputSize;
+    size_t m_mask;
+    std::vector<float> m_resolution;
+    uint32_t m_lastVersion;
+    uint32_t m_clock;  // Marca de uso para elegir la entrada a sustituir
+
+    // Tabla en estructura de arreglos: la entrada e ocupa [e * n, (e + 1) * n)
+    std::vector<int32_t> m_keys;
+    std::vector<float> m_outputs;
+    std::vector<int16_t> m_actionIndex;
+    std::vector<uint32_t> m_versions;
+    std::vector<uint32_t> m_lastUse;
+    std::vector<uint8_t> m_used;
+
+    // Entrada cuantizada y su valor reconstruido
+    std::vector<int32_t> m_key;
+    std::vector<float> m_snapped;
+
+    InferenceCacheStats m_stats;
+};
+
+#endif // INFERENCE_CACHE_H
@@ -0,0 +1,110 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Núcleos de álgebra lineal usados por las capas densas.
+ *
+ * En x86 se compilan variantes SSE2, AVX2 y AVX-512 y se elige la mejor que
+ * soporte la CPU la primera vez que se usa un núcleo. En cualquier otra
+ * arquitectura (p.ej. el ESP32) solo existe la versión escalar portable.
+ *
+ * Tolerancia numérica respecto a la versión escalar:
+ * - `axpy`, `mulAdd`, `outer` y `matmulRows` no usan FMA y cada elemento se calcula
+ *   con las mismas operaciones, por lo que el resultado es idéntico bit a bit.
+ * - `dot` reordena la suma en carriles paralelos. La diferencia con la suma
+ *   secuencial está acotada por `2 * n * FLT_EPSILON * sum(|a[i] * b[i]|)`.
+ */
+namespace kernels {
+
+/**
+ * @brief Conjuntos de instrucciones para los que existe una variante.
+ */
+enum class Isa {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief Producto escalar: devuelve sum(a[i] * b[i]) para i en [0, n).
+ */
+float dot(const float* a, const float* b, size_t n);
+
+/**
+ * @brief y[i] += alpha * x[i] para i en [0, n).
+ */
+void axpy(float alpha, const float* x, float* y, size_t n);
+
+/**
+ * @brief y[i] += x[i] * w[i] para i en [0, n).
+ */
+void mulAdd(const float* x, const float* w, float* y, size_t n);
+
+/**
+ * @brief Actualización de rango 1: A[i * n + j] += alpha * x[i] * y[j].
+ * @param A Matriz `m x n` aplanada por filas.
+ */
+void outer(float alpha, const float* x, size_t m, const float* y, size_t n, float* A);
+
+/**
+ * @brief Columnas de cada panel de `packPanels`: un registro AVX-512.
+ */
+const size_t kPanelWidth = 16;
+
+/**
+ * @brief Filas que procesa a la vez `matmulRows`.
+ */
+const size_t kMaxRows = 4;
+
+/**
+ * @brief Floats que ocupa una matriz `k x n` empaquetada con `packPanels`.
+ */
+size_t panelSize(size_t k, size_t n);
+
+/**
+ * @brief Empaqueta W (`k x n`, por filas) en paneles de `kPanelWidth` columnas: el
+ *        panel p guarda W[i][p * kPanelWidth + c] en
+ *        `panels[(p * k + i) * kPanelWidth + c]`, con ceros en las columnas que
+ *        sobran del último. Así `matmulRows` lee cada panel de forma contigua.
+ * @param panels Destino de `panelSize(k, n)` floats.
+ */
+void packPanels(const float* W, size_t k, size_t n, float* panels);
+
+/**
+ * @brief Micro-núcleo de producto de matrices: y[r * n + j] = sum(x[r * k + i] * W[i][j])
+ *        para las `rows` (1 a `kMaxRows`) filas de `x`, con W empaquetada por `packPanels`.
+ *
+ * Mantiene en registros un bloque de `rows x kPanelWidth` salidas (o dos paneles
+ * con AVX-512) mientras recorre k, así que cada peso se carga una vez por bloque
+ * de filas. Cada salida se suma desde cero en orden creciente de i, igual que
+ * `axpy` fila a fila de W: el resultado es idéntico bit a bit.
+ */
+void matmulRows(const float* x, size_t rows, size_t k, const float* panels, size_t n, float* y);
+
+/**
+ * @brief Conjunto de instrucciones que se está usando actualmente.
+ */
+Isa activeIsa();
+
+/**
+ * @brief Indica si la CPU actual (y esta compilación) soporta `isa`.
+ */
+bool isaSupported(Isa isa);
+
+/**
+ * @brief Fuerza una variante concreta (útil para comparar en benchmarks).
+ * @return false si `isa` no está soportado; en ese caso no cambia nada.
+ */
+bool setIsa(Isa isa);
+
+/**
+ * @brief Nombre legible de `isa` ("scalar", "sse2", "avx2", "avx512").
+ */
+const char* isaName(Isa isa);
+
+} // namespace kernels
+
+#endif // KERNELS_H
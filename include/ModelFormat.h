@@ -0,0 +1,125 @@
+#ifndef MODEL_FORMAT_H
+#define MODEL_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "NeuralNetwork.h"
+
+/**
+ * Formato binario de modelo (versión 2, little-endian):
+ *
+ *   0  char[4]   magic "RNMD"
+ *   4  uint16    versión (2)
+ *   6  uint16    tamaño de la cabecera con las tablas, múltiplo de 16
+ *   8  uint32    número de capas (incluida la de entrada)
+ *  12  uint8     activación oculta (solo v1; 0 en v2)
+ *  13  uint8     activación de salida (solo v1; 0 en v2)
+ *  14  uint16    reservado (0)
+ *  16  uint32    tamaño total del archivo
+ *  20  uint32    CRC-32 del archivo completo con este campo a 0
+ *  24  uint32[]  neuronas por capa
+ *   …  uint8[]   activación de cada capa con pesos (valor de `ActivationFunction`),
+ *                `número de capas - 1` entradas; relleno con ceros hasta múltiplo de 16
+ *
+ * La versión 1 no tiene la tabla de activaciones: usa la activación oculta para
+ * todas las capas salvo la última y la de salida para esta. `parseModel` acepta
+ * ambas; `serializeModel` siempre escribe la 2.
+ *
+ * Después, para cada capa con pesos: los pesos (`n_in * n_out` floats, aplanados
+ * como `i * n_out + j`) y los sesgos (`n_out` floats), cada bloque rellenado hasta
+ * múltiplo de 16 bytes. Si el archivo empieza alineado a 16 (mmap, flash), todos
+ * los bloques lo están y la red puede usarlos directamente.
+ */
+static const char MODEL_MAGIC[4] = {'R', 'N', 'M', 'D'};
+static const uint16_t MODEL_VERSION = 2;
+static const uint16_t MODEL_VERSION_V1 = 1;
+static const size_t MODEL_ALIGNMENT = 16;
+
+/**
+ * @brief Modelo ya validado cuyos parámetros apuntan al buffer original (sin copias).
+ */
+struct ModelView {
+    std::vector<int> layers;
+    std::vector<ActivationFunction> activations;  // Una por capa con pesos
+    std::vector<const float*> weights;  // Un puntero por capa
+    std::vector<const float*> biases;   // Un puntero por capa
+};
+
+/**
+ * @brief Valida un modelo en memoria y devuelve una vista sobre él.
+ *
+ * Acepta las versiones 1 y 2. Comprueba magic, versión, tamaños, activaciones,
+ * alineación y CRC. Lanza `std::runtime_error` si algo no cuadra. `size` puede
+ * ser mayor que el archivo (p.ej. una partición).
+ */
+ModelView parseModel(const void* data, size_t size);
+
+/**
+ * @brief Serializa topología, activación de cada capa y parámetros de la red al
+ *        formato binario (versión 2).
+ */
+std::vector<uint8_t> serializeModel(const NeuralNetwork& network);
+
+/**
+ * @brief Escribe `serializeModel(network)` en `path`. Lanza excepción si falla.
+ */
+void saveModel(const NeuralNetwork& network, const char* path);
+
+/**
+ * @brief Crea una red con la topología del modelo que usa sus parámetros prestados.
+ *        El buffer del modelo debe seguir vivo mientras se use la red.
+ */
+NeuralNetwork makeNetwork(const ModelView& view);
+
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+/**
+ * @class MappedModel
+ * @brief Modelo mapeado con `mmap` (solo lectura). Las páginas se cargan bajo
+ *        demanda y se comparten entre procesos; no se copia ningún parámetro.
+ */
+class MappedModel {
+public:
+    explicit MappedModel(const char* path);
+    ~MappedModel();
+
+    MappedModel(const MappedModel&) = delete;
+    MappedModel& operator=(const MappedModel&) = delete;
+
+    const ModelView& view() const { return m_view; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+    ModelView m_view;
+};
+#endif
+
+#ifdef ESP_PLATFORM
+/**
+ * @class FlashModel
+ * @brief Modelo grabado en una partición de datos de la flash, mapeado en el
+ *        espacio de direcciones con `esp_partition_mmap`. Los parámetros se leen
+ *        directamente de flash y no ocupan RAM.
+ *
+ * Requiere una tabla de particiones con una partición de datos, p.ej.:
+ *   modelo, data, 0x40, , 64K
+ * y grabar el archivo con `parttool.py write_partition --partition-name modelo`.
+ */
+class FlashModel {
+public:
+    explicit FlashModel(const char* partitionLabel);
+    ~FlashModel();
+
+    FlashModel(const FlashModel&) = delete;
+    FlashModel& operator=(const FlashModel&) = delete;
+
+    const ModelView& view() const { return m_view; }
+
+private:
+    uint32_t m_handle = 0;
+    ModelView m_view;
+};
+#endif
+
+#endif // MODEL_FORMAT_H
@@ -0,0 +1,90 @@
+#ifndef MOTOR_GROUP_H
+#define MOTOR_GROUP_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Configuración de `MotorGroup`.
+ */
+struct MotorGroupConfig {
+    // false: salidas digitales escritas por registro; true: PWM (LEDC) con rampa
+    bool pwm = false;
+    uint8_t firstChannel = 0;       // Canal LEDC del motor 0; el motor i usa firstChannel + i
+    uint32_t frequency = 20000;     // Hz
+    uint8_t resolutionBits = 8;     // Ciclo máximo = 2^bits - 1
+    unsigned long rampMs = 200;     // De 0 al ciclo máximo; 0 = sin rampa
+};
+
+/**
+ * @class MotorGroup
+ * @brief Los motores del vehículo como un grupo: recibe la orden completa (un bit
+ *        por motor) y solo toca los pines que cambian.
+ *
+ * - Digital: una orden igual a la anterior no escribe nada. Si cambia, se escribe
+ *   una máscara por banco de GPIO en los registros W1TC (apagar) y W1TS (encender)
+ *   del ESP32: como mucho 4 escrituras (GPIO0-31 y GPIO32-39), frente a un
+ *   `digitalWrite` por motor en cada ciclo.
+ * - Sin estados espurios: primero se apaga y luego se enciende, así que cada
+ *   estado intermedio es parte del anterior o del nuevo. Un puente H nunca ve IN1
+ *   e IN2 en alto a la vez si ninguna de las dos órdenes lo pide.
+ * - PWM (`config.pwm`): `update()` acerca el ciclo de trabajo de cada motor a su
+ *   objetivo a razón de `rampMs` de 0 al máximo. Los motores que se encienden no
+ *   arrancan hasta que los que se apagan llegan a 0, y solo se llama a `ledcWrite`
+ *   si el ciclo cambia.
+ */
+class MotorGroup {
+public:
+    static const int MAX_MOTORS = 8;
+
+    /**
+     * @param pins Pin de cada motor; el bit i de las órdenes corresponde a `pins[i]`.
+     */
+    MotorGroup(const uint8_t* pins, int count, const MotorGroupConfig& config = MotorGroupConfig());
+
+    /**
+     * @brief Configura los canales PWM y apaga todos los motores. Llamar desde
+     *        setup(), no desde un constructor global.
+     */
+    void begin();
+
+    /**
+     * @brief Nueva orden: bit i = motor i encendido. En modo digital se aplica en el
+     *        acto; con PWM fija el objetivo de la rampa.
+     */
+    void command(uint32_t bits);
+
+    /**
+     * @brief Avanza la rampa según `millis()`. Sin PWM, o con la rampa terminada,
+     *        no hace nada; se puede llamar en cada iteración de loop().
+     */
+    void update();
+
+    /**
+     * @brief Motores encendidos ahora (con PWM, los que tienen ciclo > 0).
+     */
+    uint32_t state() const { return m_state; }
+
+    /**
+     * @brief Verdadero si las salidas ya coinciden con la última orden.
+     */
+    bool settled() const;
+
+    int count() const { return m_count; }
+
+private:
+    void writeDigital(uint32_t bits);
+    void writeDuty(int motor, uint32_t duty);
+
+    uint8_t m_pins[MAX_MOTORS];
+    uint8_t m_banks[MAX_MOTORS];      // 0 = GPIO0-31, 1 = GPIO32-39
+    uint32_t m_bankBits[MAX_MOTORS];  // Bit del pin dentro de su banco
+    uint32_t m_duty[MAX_MOTORS];
+    int m_count;
+    MotorGroupConfig m_config;
+    uint32_t m_maxDuty;
+    uint32_t m_target;
+    uint32_t m_state;
+    unsigned long m_lastRampMs;
+};
+
+#endif // MOTOR_GROUP_H
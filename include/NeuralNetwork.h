@@ -1,18 +1,12 @@
 #ifndef NEURAL_NETWORK_H
 #define NEURAL_NETWORK_H
 
+#include <stdint.h>
 #include <vector>
 #include <stdexcept>
+#include "Activations.h"
+#include "AlignedBuffer.h"
 
-/**
- * @brief Enumeración de funciones de activación disponibles.
- */
-enum class ActivationFunction {
-    RELU,
-    SIGMOID,
-    TANH,
-    LINEAR
-};
 /**
  * @brief Tipos de funciones de error disponibles
  */
@@ -30,6 +24,10 @@ enum class ErrorFunction {
  * - Ofrece la posibilidad de establecer funciones de activación para capas ocultas y de salida.
  * - Dispone de un método `setWeights` para cargar pesos y sesgos entrenados externamente.
  * - El método `forward` realiza la inferencia dada una entrada.
+ * - Todos los parámetros propios viven en un único bloque alineado a 64 bytes con
+ *   el orden plano [W0, b0, W1, b1, ...] (ver `parameters`), y los gradientes en
+ *   otro con el mismo orden (ver `gradients`). Cargar o guardar la red es una sola
+ *   copia y un optimizador recorre los dos bloques en un único bucle.
  */
 class NeuralNetwork {
 public:
@@ -42,6 +40,14 @@ public:
     NeuralNetwork(const std::vector<int>& layers,
                   ActivationFunction hiddenAct = ActivationFunction::RELU,
                   ActivationFunction outputAct = ActivationFunction::SIGMOID);
+
+    /**
+     * @brief Constructor con una activación por capa, p.ej. {4,16,8,2} con
+     *        {TANH, RELU, LINEAR}.
+     * @param activations Una función por capa con pesos (`layers.size() - 1`).
+     */
+    NeuralNetwork(const std::vector<int>& layers,
+                  const std::vector<ActivationFunction>& activations);
                   /**
      * @brief Constructor de la red neuronal.
      * @param layers Vector con el número de neuronas por capa, p.ej. {4,8,3}.
@@ -57,6 +63,23 @@ public:
      */
     void setWeights(const std::vector<std::vector<float>>& weights,
                     const std::vector<std::vector<float>>& biases);
+
+    /**
+     * @brief Usa pesos y sesgos externos sin copiarlos (p.ej. un modelo mapeado en
+     *        memoria con `MappedModel`, o una partición de flash).
+     *
+     * La red libera su copia propia y queda en modo de solo lectura: la inferencia
+     * funciona igual, pero los métodos de entrenamiento lanzan una excepción hasta
+     * que se vuelva a llamar a `setWeights`. Los buffers deben seguir vivos mientras
+     * se use la red.
+     * @param weights Un puntero por capa a `n_in * n_out` floats (`i * n_out + j`).
+     * @param biases Un puntero por capa a `n_out` floats.
+     */
+    void borrowWeights(const std::vector<const float*>& weights,
+                       const std::vector<const float*>& biases);
+
+    /** @brief Indica si la red está usando parámetros prestados (`borrowWeights`). */
+    bool hasBorrowedWeights() const { return !m_borrowedWeights.empty(); }
     
     /**
      * 
@@ -76,12 +99,125 @@ public:
                         ErrorFunction errorType);
 
     /**
-     * 
+     * @brief Gradiente del MSE de una muestra, en matrices por capa.
+     *
+     * Usa la misma regla que `accumulateGradients` y `backward`: derivada exacta
+     * del MSE (2 * (output - target) / n) retropropagada a través de las derivadas
+     * de las funciones de activación configuradas.
      */
     void computeGradients(const std::vector<float>& input,
                                      const std::vector<float>& target,
                                      std::vector<std::vector<float>>& grad_weights,
                                      std::vector<std::vector<float>>& grad_biases);
+
+    /**
+     * @brief Propagación hacia adelante que conserva las activaciones de cada capa
+     *        para un `backward` posterior. No reserva memoria dinámica.
+     * @param input Puntero a `m_layers.front()` floats de entrada.
+     * @param output Puntero a `m_layers.back()` floats donde se escribe la salida.
+     */
+    void forwardTrain(const float* input, float* output);
+
+    /**
+     * @brief Retropropagación con el descenso de gradiente fusionado, sobre las
+     *        activaciones del último `forwardTrain`.
+     *
+     * Equivale a `computeGradients` + `updateWeights` (mismo gradiente que
+     * `accumulateGradients`, así que un paso aquí y uno de SGD en `Trainer` con la
+     * misma tasa mueven los pesos igual), pero cada parámetro se lee y actualiza una
+     * sola vez y no se materializan matrices de gradiente.
+     * @param target Puntero a `m_layers.back()` floats con la salida esperada.
+     * @param learningRate Tasa de aprendizaje.
+     * @return Error MSE de la salida antes de actualizar.
+     */
+    float backward(const float* target, float learningRate);
+
+    /**
+     * @brief Paso de entrenamiento completo: `forwardTrain` + `backward`.
+     * @param output Si no es nulo, recibe la salida de la red antes de actualizar.
+     * @return Error MSE de la salida antes de actualizar.
+     */
+    float trainStep(const float* input, const float* target, float learningRate,
+                    float* output = nullptr);
+
+    /**
+     * @brief Número total de parámetros (pesos y sesgos de todas las capas).
+     */
+    size_t parameterCount() const;
+
+    /**
+     * @brief Suma el gradiente de una muestra a un buffer plano de gradientes.
+     *
+     * Usa la derivada exacta del MSE (2 * (output - target) / n) y retropropaga a
+     * través de las derivadas de las funciones de activación configuradas, igual
+     * que `computeGradients` y `backward`.
+     * @param input Puntero a `m_layers.front()` floats de entrada.
+     * @param target Puntero a `m_layers.back()` floats con la salida esperada.
+     * @param gradients Buffer de `parameterCount()` floats con el orden
+     *        [W0, b0, W1, b1, ...]; el gradiente se acumula (no se sobrescribe).
+     * @return Error MSE de la muestra.
+     */
+    float accumulateGradients(const float* input, const float* target, float* gradients);
+
+    /**
+     * @brief Suma `delta` a todos los parámetros, con el mismo orden plano que
+     *        `accumulateGradients`.
+     */
+    void addToParameters(const float* delta);
+
+    /**
+     * @brief Copia todos los parámetros a un buffer plano de `parameterCount()`
+     *        floats, con el orden [W0, b0, W1, b1, ...] de `accumulateGradients`.
+     */
+    void copyParameters(float* destination) const;
+
+    /**
+     * @brief Sustituye todos los parámetros por los de un buffer plano con el orden
+     *        de `copyParameters` (p.ej. un punto de control restaurado).
+     */
+    void setParameters(const float* source);
+
+    /**
+     * @brief Parámetros propios, `parameterCount()` floats con el orden de
+     *        `copyParameters` y alineados a 64 bytes. Nulo si son prestados.
+     */
+    const float* parameters() const { return m_parameters.data(); }
+
+    /**
+     * @brief Acceso de escritura a los parámetros propios, para actualizarlos en el
+     *        sitio (p.ej. el optimizador de `Trainer`). Lanza una excepción si son
+     *        prestados. El puntero deja de ser válido con `borrowWeights`.
+     */
+    float* mutableParameters();
+
+    /**
+     * @brief Buffer de gradientes de `parameterCount()` floats con el orden de
+     *        `copyParameters`, alineado a 64 bytes y a cero.
+     *
+     * Es memoria de trabajo para `accumulateGradients` (la red no lo lee): quien
+     * acumula en él debe dejarlo a cero al terminar, como hace `Trainer`. Se reserva
+     * en la primera llamada, así que una red que solo infiere (p.ej. con pesos
+     * prestados) no lo paga. El puntero es estable desde entonces y deja de ser
+     * válido con `borrowWeights`, que lo libera.
+     */
+    float* gradients();
+    /** @brief Buffer de gradientes, o `nullptr` si aún no se ha pedido. */
+    const float* gradients() const { return m_gradients.data(); }
+
+    /**
+     * @brief Contador que cambia cada vez que puede cambiar la salida de la red:
+     *        parámetros (`setWeights`, `updateWeights`, `backward`, `addToParameters`,
+     *        `setParameters`, `mutableParameters`, `borrowWeights`) o activaciones.
+     *        Sirve para invalidar resultados guardados (ver `InferenceCache`).
+     */
+    uint32_t parameterVersion() const { return m_parameterVersion; }
+
+    /**
+     * @brief Bytes de memoria dinámica reservada por la red: parámetros, gradientes
+     *        (si se han pedido), pesos empaquetados y buffers de trabajo.
+     */
+    size_t memoryBytes() const;
+
     /**
      * @brief Realiza la propagación hacia adelante dado un vector de entrada.
      * @param input Vector de floats correspondiente a la entrada de la red.
@@ -89,8 +225,127 @@ public:
      */
     std::vector<float> forward(const std::vector<float>& input);
 
+    /**
+     * @brief Propagación hacia adelante sin reservas de memoria dinámica.
+     *
+     * Usa los buffers de trabajo dimensionados en el constructor, por lo que
+     * puede llamarse en cada ciclo de `loop()` sin fragmentar el heap.
+     * @param input Puntero a `m_layers.front()` floats de entrada.
+     * @param output Puntero a `m_layers.back()` floats donde se escribe la salida.
+     */
+    void forward(const float* input, float* output);
+
+    /**
+     * @brief Como `forward`, pero con parámetros externos en el orden plano de
+     *        `copyParameters` (p.ej. una instantánea de `ParameterStore`). Los
+     *        parámetros propios de la red no se leen.
+     * @param parameters Puntero a `parameterCount()` floats.
+     */
+    void forward(const float* input, float* output, const float* parameters);
+
+    /**
+     * @brief Propagación hacia adelante de un lote de entradas.
+     *
+     * Procesa bloques de filas para que cada peso se lea una vez por bloque. En
+     * capas de menos de `kWideLayer` neuronas empaqueta los pesos transpuestos
+     * (una fila contigua por neurona); en las anchas los empaqueta en paneles y
+     * usa el micro-núcleo `kernels::matmulRows`. El resultado es idéntico al de
+     * llamar a `forward` fila por fila.
+     * @param inputs Matriz `numRows x m_layers.front()` en orden por filas.
+     * @param numRows Número de filas del lote.
+     * @param outputs Matriz `numRows x m_layers.back()` donde se escribe la salida.
+     */
+    void forwardBatch(const float* inputs, size_t numRows, float* outputs);
+
+    /**
+     * @brief Versión con vectores de `forwardBatch`.
+     * @param inputs Matriz de entradas aplanada por filas; su tamaño debe ser
+     *        múltiplo de `m_layers.front()`.
+     * @return Matriz `N x m_layers.back()` aplanada por filas.
+     */
+    std::vector<float> forwardBatch(const std::vector<float>& inputs);
+
+    /**
+     * @brief Elige la implementación de SIGMOID y TANH (exacta, tabla, racional o
+     *        recta saturada) para todas las capas: inferencia y entrenamiento.
+     *        Ver `ActivationMode` para el error máximo de cada una.
+     */
+    void setActivationMode(ActivationMode mode);
+
+    ActivationMode getActivationMode() const { return m_activationMode; }
+
+    /** @brief Topología de la red (neuronas por capa). */
+    const std::vector<int>& getLayers() const { return m_layers; }
+
+    /**
+     * @brief Copia de los pesos actuales, aplanados por capa como `i * n_out + j`
+     *        (propios o prestados). Para leerlos sin copiar, ver `weightsOf`.
+     */
+    std::vector<std::vector<float>> getWeights() const;
+
+    /** @brief Copia de los sesgos actuales por capa (propios o prestados). */
+    std::vector<std::vector<float>> getBiases() const;
+
+    /** @brief Pesos de la capa `layerIndex`, propios o prestados. */
+    const float* weightsOf(size_t layerIndex) const {
+        return hasBorrowedWeights() ? m_borrowedWeights[layerIndex]
+                                    : m_parameters.data() + m_layerOffsets[layerIndex];
+    }
+
+    /** @brief Sesgos de la capa `layerIndex`, propios o prestados. */
+    const float* biasesOf(size_t layerIndex) const {
+        return hasBorrowedWeights() ? m_borrowedBiases[layerIndex]
+                                    : weightsOf(layerIndex) + m_layers[layerIndex] * m_layers[layerIndex + 1];
+    }
+
+    /** @brief Función de activación de la capa `layerIndex` (0 = primera capa con pesos). */
+    ActivationFunction getActivation(size_t layerIndex) const {
+        return m_layerSpecs[layerIndex].activation;
+    }
+
+    /** @brief Cambia la función de activación de la capa `layerIndex`. */
+    void setActivation(size_t layerIndex, ActivationFunction func);
+
+    /**
+     * @brief Núcleo de una capa densa para una muestra, especializado para una
+     *        activación: out = act(in * W + b).
+     */
+    typedef void (*DenseKernel)(const float* in, int inSize, const float* weights,
+                                const float* biases, int outSize, float* out);
+
+    /**
+     * @brief Núcleo de una capa densa para un lote: recibe los pesos empaquetados
+     *        por `packWeights` (transpuestos o en paneles según `kWideLayer`).
+     */
+    typedef void (*BatchKernel)(const float* in, size_t numRows, int inSize, int outSize,
+                                const float* packed, const float* biases, float* out);
+
+    /**
+     * @brief Ancho de capa a partir del cual `forwardBatch` empaqueta los pesos en
+     *        paneles para `kernels::matmulRows` en lugar de transponerlos.
+     */
+    static const int kWideLayer = 16;
 
 private:
+    /**
+     * @brief Calcula el desplazamiento de cada capa en el bloque de parámetros.
+     */
+    void initLayout();
+
+    /** @brief Pesos propios de la capa `layerIndex` (vista del bloque de parámetros). */
+    float* ownWeights(size_t layerIndex) { return m_parameters.data() + m_layerOffsets[layerIndex]; }
+
+    /** @brief Sesgos propios de la capa `layerIndex`. */
+    float* ownBiases(size_t layerIndex) {
+        return ownWeights(layerIndex) + m_layers[layerIndex] * m_layers[layerIndex + 1];
+    }
+
+    /** @brief Los pesos empaquetados y los resultados guardados ya no valen. */
+    void markParametersChanged() {
+        m_packedDirty = true;
+        m_parameterVersion++;
+    }
+
     /**
      * @brief Inicializa los pesos y sesgos con valores fijos (0.1f).
      *        Ideal para ejemplos, aunque en casos reales se recomienda
@@ -98,19 +353,91 @@ private:
      */
     void initWeights();
 
+    /**
+     * @brief Dimensiona los buffers de activaciones (ping-pong) al ancho
+     *        máximo de la topología. Solo reserva memoria aquí.
+     */
+    void initWorkspace();
+
+    /**
+     * @brief Reconstruye `m_packedWeights` (pesos transpuestos o en paneles) si los
+     *        pesos cambiaron.
+     */
+    void packWeights();
+
+    /**
+     * @brief Deja en `m_delta` la derivada del MSE respecto a la entrada de la capa
+     *        de salida del último `forwardTrain` y devuelve el MSE.
+     */
+    float outputDelta(const float* target);
+
+    /**
+     * @brief Lanza una excepción si los parámetros son prestados (solo lectura).
+     */
+    void requireOwnedWeights() const;
+
+    /**
+     * @brief Guarda la activación de cada capa y elige sus núcleos.
+     */
+    void initLayerSpecs(const std::vector<ActivationFunction>& activations);
+
+    /**
+     * @brief Vuelve a elegir los núcleos de cada capa tras cambiar una activación
+     *        o el `ActivationMode`.
+     */
+    void selectKernels();
+
+    /**
+     * @brief Configuración de una capa con pesos: su activación y los núcleos
+     *        instanciados para ella (sin decisiones por neurona en el bucle interno).
+     */
+    struct LayerSpec {
+        ActivationFunction activation;
+        DenseKernel dense;
+        BatchKernel batch;
+    };
+
     // Estructura de la red: número de neuronas por capa
     std::vector<int> m_layers;
 
-    // Para cada capa, se guardan los pesos en un vector aplanado
-    // Ejemplo: la i-ésima capa almacenará (n_in * n_out) pesos
-    std::vector<std::vector<float>> m_weights;
+    // Parámetros propios [W0, b0, W1, b1, ...]: la capa l ocupa n_in * n_out pesos
+    // (`i * n_out + j`) seguidos de n_out sesgos desde `m_layerOffsets[l]`. Vacío
+    // si la red usa parámetros prestados.
+    AlignedBuffer<float> m_parameters;
+    // Gradientes con el mismo orden; siempre reservado
+    AlignedBuffer<float> m_gradients;
+    std::vector<size_t> m_layerOffsets;
+    size_t m_parameterCount = 0;
+
+    // Parámetros prestados por `borrowWeights` (vacíos si la red usa los propios)
+    std::vector<const float*> m_borrowedWeights;
+    std::vector<const float*> m_borrowedBiases;
+
+    // Activación y núcleos de cada capa con pesos (m_layers.size() - 1 entradas)
+    std::vector<LayerSpec> m_layerSpecs;
+    ActivationMode m_activationMode = ActivationMode::EXACT;
+
+    // Buffers de activaciones intermedias usados alternadamente por `forward`
+    std::vector<float> m_bufferA;
+    std::vector<float> m_bufferB;
+
+    // Activaciones de cada capa (incluida la entrada) guardadas por `forwardTrain`,
+    // y deltas de la retropropagación; se dimensionan una vez en `initWorkspace`
+    std::vector<std::vector<float>> m_layerActivations;
+    std::vector<float> m_delta;
+    std::vector<float> m_prevDelta;
 
-    // Para cada capa, se guarda un vector de longitud igual a n_out para los sesgos
-    std::vector<std::vector<float>> m_biases;
+    // Pesos empaquetados para `forwardBatch`. Transpuestos en las capas de menos de
+    // `kWideLayer` neuronas (la neurona j ocupa [j * n_in, (j + 1) * n_in)) y en
+    // paneles de `kernels::packPanels` en las demás. Se regeneran bajo demanda
+    // cuando `m_packedDirty`.
+    std::vector<std::vector<float>> m_packedWeights;
+    bool m_packedDirty = true;
+    uint32_t m_parameterVersion = 0;
 
-    // Funciones de activación para capas ocultas y capa de salida
-    ActivationFunction m_hiddenActivation;
-    ActivationFunction m_outputActivation;
+    // Buffers de activaciones intermedias de `forwardBatch` (crecen con el lote)
+    std::vector<float> m_batchA;
+    std::vector<float> m_batchB;
 };
 
 #endif // NEURAL_NETWORK_H
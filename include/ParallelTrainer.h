@@ -0,0 +1,39 @@
+#ifndef PARALLEL_TRAINER_H
+#define PARALLEL_TRAINER_H
+
+#include <vector>
+#include "ThreadPool.h"
+#include "Trainer.h"
+
+/**
+ * @class ParallelTrainer
+ * @brief `Trainer` con paralelismo de datos para reentrenar en el PC.
+ *
+ * Cada lote se divide en tantos fragmentos contiguos como hilos. Cada fragmento
+ * tiene su propia réplica de la red (que acumula en sus propios gradientes), y se ejecuta
+ * en el grupo de hilos con robo de trabajo. Los buffers se combinan con una
+ * reducción en árbol de orden fijo antes de aplicar el optimizador.
+ *
+ * Como el reparto en fragmentos y el orden de la reducción dependen solo del número
+ * de hilos (no de qué hilo ejecuta cada fragmento), el resultado es determinista
+ * para una semilla y un número de hilos fijos.
+ */
+class ParallelTrainer : public Trainer {
+public:
+    ParallelTrainer(NeuralNetwork& network, size_t numThreads,
+                    const TrainerConfig& config = TrainerConfig());
+
+    /** @brief Número de hilos (y de fragmentos por lote). */
+    size_t threadCount() const { return m_pool.size(); }
+
+protected:
+    float accumulate(const float* inputs, const float* targets, const size_t* indices,
+                     size_t count, float* sampleLosses) override;
+
+private:
+    ThreadPool m_pool;
+    std::vector<NeuralNetwork> m_replicas;
+    std::vector<float> m_shardLoss;
+};
+
+#endif // PARALLEL_TRAINER_H
@@ -0,0 +1,106 @@
+#ifndef PARAMETER_STORE_H
+#define PARAMETER_STORE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class NeuralNetwork;
+
+/**
+ * @class ParameterStore
+ * @brief Versiones inmutables de los parámetros de una red, publicadas por un
+ *        entrenador y leídas por la inferencia sin esperas (estilo RCU).
+ *
+ * - Hay `SLOTS` copias planas de los parámetros (orden de `copyParameters`). Una es
+ *   la versión actual; las demás guardan versiones antiguas que algún lector aún
+ *   usa, o están libres para la siguiente publicación.
+ * - `acquire` es una sola operación atómica (`fetch_add`) y nunca espera al
+ *   entrenador. La instantánea no cambia mientras viva, aunque se publiquen
+ *   versiones nuevas.
+ * - `publish` copia la red en una copia libre y la hace actual con un `exchange`.
+ *   Si los lectores retienen todas las copias antiguas devuelve false sin esperar;
+ *   el entrenador lo reintenta en su siguiente paso.
+ *
+ * Puede haber cualquier número de lectores, pero un único hilo publicador. Se usan
+ * atómicos de 32 bits, que son sin bloqueos también en el ESP32 (Xtensa).
+ */
+class ParameterStore {
+public:
+    static const int SLOTS = 3;
+
+    /**
+     * @class Snapshot
+     * @brief Referencia a una versión publicada; la libera al destruirse.
+     */
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot&& other) noexcept;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        ~Snapshot();
+
+        /** @brief Parámetros planos, para `NeuralNetwork::forward(input, output, parameters)`. */
+        const float* parameters() const { return m_parameters; }
+
+        /** @brief Número de versión (0 = la del constructor del almacén). */
+        uint32_t version() const { return m_version; }
+
+    private:
+        friend class ParameterStore;
+        Snapshot(const ParameterStore* store, uint32_t slot);
+        void release();
+
+        const ParameterStore* m_store;
+        uint32_t m_slot;
+        uint32_t m_version;
+        const float* m_parameters;
+    };
+
+    /**
+     * @brief Reserva las copias y publica como versión 0 los parámetros actuales
+     *        de `network`. Es la única reserva de memoria.
+     */
+    explicit ParameterStore(const NeuralNetwork& network);
+
+    ParameterStore(const ParameterStore&) = delete;
+    ParameterStore& operator=(const ParameterStore&) = delete;
+
+    /** @brief Instantánea de la versión actual (lectores, sin esperas). */
+    Snapshot acquire() const;
+
+    /**
+     * @brief Publica los parámetros actuales de `network` como nueva versión (un
+     *        único hilo publicador). No reserva memoria.
+     * @return false si no había ninguna copia libre; no se publica nada.
+     */
+    bool publish(const NeuralNetwork& network);
+
+    /** @brief Versión actual. */
+    uint32_t version() const;
+
+    /** @brief Número de floats de cada copia (`parameterCount()` de la red). */
+    size_t parameterCount() const { return m_parameterCount; }
+
+private:
+    // m_current: copia actual en los 2 bits altos y, en el resto, lectores que la
+    // adquirieron y aún no la han liberado.
+    static const uint32_t SLOT_SHIFT = 30;
+    static const uint32_t COUNT_MASK = (1u << SLOT_SHIFT) - 1;
+
+    void release(uint32_t slot) const;
+
+    size_t m_parameterCount;
+    std::vector<float> m_storage;                  // SLOTS * m_parameterCount
+    uint32_t m_versions[SLOTS];
+    uint32_t m_nextVersion = 1;                    // Solo lo usa el publicador
+
+    mutable std::atomic<uint32_t> m_current{0};
+    // Lectores de cada copia retirada: al retirarla se suman los de `m_current` y
+    // cada liberación posterior resta uno. La copia está libre cuando vale 0.
+    mutable std::atomic<int32_t> m_retiredReaders[SLOTS];
+};
+
+#endif // PARAMETER_STORE_H
@@ -0,0 +1,96 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Etapas del ciclo de control que se pueden medir.
+ */
+enum class Stage {
+    SENSING,    // Lectura de los HCSR04
+    FORWARD,    // forwardTrain
+    SELECTION,  // findClosestMatch
+    TRAINING,   // backward: gradientes y actualización de pesos (fusionados)
+    ACTUATION,  // MotorGroup::command
+    TELEMETRY,  // Registro de telemetría
+    CYCLE,      // Ciclo de control: tarea de inferencia
+    COUNT
+};
+
+#ifdef PERF_STATS
+/**
+ * Medición de etapas con histogramas de latencia. Solo existe con -DPERF_STATS;
+ * sin esa opción las macros PERF_* no generan código y Perf.cpp queda vacío.
+ *
+ * - Reloj: contador de ciclos de la CPU en el ESP32, `steady_clock` en el PC.
+ * - Histograma logarítmico por etapa: 4 cubetas por potencia de dos (resolución
+ *   ~19 %), hasta 2^32 ticks. Sin memoria dinámica: ~0.5 KB por etapa.
+ * - Cuenta las ejecuciones que superan el plazo de la etapa (`setDeadline`).
+ *
+ * No es seguro entre hilos: medir siempre desde el mismo (loop()).
+ */
+namespace perf {
+
+struct StageStats {
+    uint32_t count;
+    uint32_t deadlineMisses;
+    uint64_t minNs;
+    uint64_t maxNs;
+    uint64_t meanNs;
+    uint64_t p50Ns;  // Límite superior de la cubeta (acotado por maxNs)
+    uint64_t p99Ns;
+};
+
+const char* stageName(Stage stage);
+
+void begin(Stage stage);
+void end(Stage stage);
+
+/** @brief Plazo de la etapa en ns; 0 desactiva el conteo de incumplimientos. */
+void setDeadline(Stage stage, uint64_t ns);
+
+/** @brief Número de mediciones de la etapa (más barato que `stats`). */
+uint32_t count(Stage stage);
+
+StageStats stats(Stage stage);
+void reset();
+
+/**
+ * @brief Recibe el texto de `dump` línea a línea (p.ej. `Serial.print`).
+ */
+typedef void (*PerfWriter)(const char* text, void* context);
+
+/** @brief Escribe una tabla con las estadísticas de todas las etapas medidas. */
+void dump(PerfWriter writer, void* context);
+
+/** @brief Mide la etapa durante la vida del objeto. */
+class Scope {
+public:
+    explicit Scope(Stage stage) : m_stage(stage) { begin(stage); }
+    ~Scope() { end(m_stage); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Stage m_stage;
+};
+
+} // namespace perf
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+
+#define PERF_BEGIN(stage) perf::begin(stage)
+#define PERF_END(stage) perf::end(stage)
+#define PERF_SCOPE(stage) perf::Scope PERF_CONCAT(perfScope_, __LINE__)(stage)
+#define PERF_DEADLINE(stage, ns) perf::setDeadline(stage, ns)
+#else
+#define PERF_BEGIN(stage) do {} while (0)
+#define PERF_END(stage) do {} while (0)
+#define PERF_SCOPE(stage) do {} while (0)
+#define PERF_DEADLINE(stage, ns) do {} while (0)
+#endif
+
+#endif // PERF_H
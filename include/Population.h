@@ -0,0 +1,121 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <stddef.h>
+#include <vector>
+#include "Activations.h"
+#include "NeuralNetwork.h"
+
+class ThreadPool;
+
+/**
+ * @class Population
+ * @brief K redes con la misma topología evaluadas a la vez, p.ej. variantes de la
+ *        red del vehículo con pesos perturbados o activaciones distintas.
+ *
+ * - Los parámetros se guardan intercalados (estructura de arreglos): el parámetro
+ *   `p` del orden plano de `copyParameters` de la red `k` está en `p * K + k`. Así,
+ *   para cada peso, los K valores son contiguos y una capa de las K redes es una
+ *   serie de `kernels::axpy` / `kernels::mulAdd` de longitud K.
+ * - Las activaciones intermedias también van intercaladas (`neurona * K + k`).
+ * - Cada red calcula exactamente las mismas operaciones, en el mismo orden, que
+ *   `NeuralNetwork::forward`: el resultado es idéntico bit a bit.
+ * - Toda la memoria se reserva en el constructor. `forward` y `evaluate` usan
+ *   buffers internos, así que una misma población no admite llamadas concurrentes.
+ */
+class Population {
+public:
+    /**
+     * @param layers Topología común, p.ej. {4,8,4}.
+     * @param size Número de redes (K).
+     */
+    Population(const std::vector<int>& layers, size_t size,
+               ActivationFunction hiddenAct = ActivationFunction::RELU,
+               ActivationFunction outputAct = ActivationFunction::SIGMOID);
+
+    /** @brief Número de redes (K). */
+    size_t size() const { return m_size; }
+
+    /** @brief Parámetros de cada red. */
+    size_t parameterCount() const { return m_parameterCount; }
+
+    const std::vector<int>& getLayers() const { return m_layers; }
+
+    /**
+     * @brief Copia los parámetros y las activaciones de `network` en la red `k`.
+     *        La topología debe coincidir.
+     */
+    void setMember(size_t k, const NeuralNetwork& network);
+
+    /**
+     * @brief Sustituye los parámetros de la red `k`.
+     * @param parameters `parameterCount()` floats con el orden de `copyParameters`.
+     */
+    void setMemberParameters(size_t k, const float* parameters);
+
+    /** @brief Copia los parámetros de la red `k` con el orden de `copyParameters`. */
+    void copyMemberParameters(size_t k, float* destination) const;
+
+    /** @brief Cambia la activación de la capa `layerIndex` de la red `k`. */
+    void setActivation(size_t k, size_t layerIndex, ActivationFunction func);
+
+    ActivationFunction getActivation(size_t k, size_t layerIndex) const {
+        return m_activations[layerIndex * m_size + k];
+    }
+
+    /** @brief Implementación de SIGMOID y TANH para todas las redes. */
+    void setActivationMode(ActivationMode mode) { m_activationMode = mode; }
+
+    /**
+     * @brief La misma entrada por las K redes.
+     * @param input `layers.front()` floats.
+     * @param outputs Matriz `K x layers.back()`: la fila `k` es la salida de la red `k`.
+     */
+    void forward(const float* input, float* outputs);
+
+    /**
+     * @brief Error medio de cada red sobre una traza (p.ej. lecturas grabadas y la
+     *        acción esperada), con la misma fórmula que `calculateError` por fila.
+     *
+     * Con `pool`, las redes se reparten en bloques de `kMemberBlock` que se evalúan
+     * en paralelo. Cada red hace las mismas operaciones en cualquier bloque, así que
+     * el resultado no depende del número de hilos.
+     * @param inputs Matriz `numRows x layers.front()`.
+     * @param targets Matriz `numRows x layers.back()`.
+     * @param losses K floats: error medio de cada red en las `numRows` filas.
+     */
+    void evaluate(const float* inputs, const float* targets, size_t numRows,
+                  ErrorFunction errorType, float* losses, ThreadPool* pool = nullptr);
+
+    /** @brief Redes por bloque de `evaluate` en paralelo (múltiplo de 16 floats, para
+     *         que dos bloques no compartan líneas de caché de 64 bytes). */
+    static const size_t kMemberBlock = 64;
+
+private:
+    /**
+     * @brief Propaga `input` por las redes [k0, k1) y devuelve la salida intercalada
+     *        (`j * K + k`) en uno de los buffers de trabajo.
+     */
+    const float* forwardRange(const float* input, size_t k0, size_t k1);
+
+    void evaluateRange(const float* inputs, const float* targets, size_t numRows,
+                       ErrorFunction errorType, float* losses, size_t k0, size_t k1);
+
+    std::vector<int> m_layers;
+    size_t m_size;
+    size_t m_parameterCount;
+    ActivationMode m_activationMode = ActivationMode::EXACT;
+
+    // [W0, b0, W1, b1, ...] con cada parámetro repetido K veces seguidas
+    std::vector<float> m_parameters;
+    // Activación de cada capa y red (`capa * K + k`) y si toda la capa usa la misma
+    std::vector<ActivationFunction> m_activations;
+    std::vector<char> m_uniformActivation;
+
+    // Buffers de trabajo: ancho máximo x K cada uno, y un error por red
+    std::vector<float> m_bufferA;
+    std::vector<float> m_bufferB;
+    std::vector<float> m_rowErrors;
+};
+
+#endif // POPULATION_H
@@ -0,0 +1,146 @@
+#ifndef QUANTIZED_NETWORK_H
+#define QUANTIZED_NETWORK_H
+
+#include <stdint.h>
+#include <vector>
+#include "Activations.h"
+
+class NeuralNetwork;
+
+/**
+ * @brief Granularidad de las escalas de los pesos int8.
+ */
+enum class QuantizationGranularity {
+    PER_LAYER,   // Una escala para toda la matriz de la capa
+    PER_CHANNEL  // Una escala por neurona de salida
+};
+
+/**
+ * @brief Descripción de una capa cuantizada. Todos los punteros pueden apuntar a
+ *        arreglos `const` en flash (ver `tools/quantizer`).
+ *
+ * Entrada int8 con una escala por valor `s_x[i] = inputMultipliers[i] * s_in`,
+ * pesos int8 con escala `s_w[j]`. En la primera capa `x_q[i] * inputMultipliers[i]`
+ * es directamente la entrada float en la escala `s_in` (sin redondear a int8),
+ * saturada a ±127 veces el multiplicador:
+ *   acc_j = sum_i (x_q[i] * inputMultipliers[i]) * w_q[i * outSize + j] + b_q[j]   (int32)
+ *   real_j = acc_j * accScales[j],   accScales[j] = s_in * s_w[j]
+ * En capas ocultas el acumulador se reescala a la escala int8 de cada neurona
+ * (la `s_x[j]` de la capa siguiente) con un multiplicador de punto fijo:
+ * q = (acc * multipliers[j]) >> (31 - shifts[j]).
+ */
+struct QuantizedLayer {
+    int inSize;
+    int outSize;
+    ActivationFunction activation;
+    const int8_t* weights;       // inSize * outSize, aplanados como `i * outSize + j`
+    const int32_t* biases;       // outSize, en la escala del acumulador
+    const float* accScales;      // outSize, escala real del acumulador (nullptr en RELU/LINEAR ocultas)
+    const int32_t* multipliers;  // outSize, mantisa Q31 del reescalado (solo RELU/LINEAR ocultas)
+    const int8_t* shifts;        // outSize, exponente del reescalado (solo RELU/LINEAR ocultas)
+    const int32_t* inputMultipliers;  // inSize, escala de cada entrada en unidades de `s_in`
+    float outScale;              // Mayor escala int8 de la salida; SIGMOID/TANH ocultas la usan
+                                 // para cuantizar (no se usa en la última capa)
+};
+
+/**
+ * @brief Modelo cuantizado completo.
+ */
+struct QuantizedModel {
+    int numLayers;
+    const QuantizedLayer* layers;
+    const float* inputScales;    // Escala int8 de cada entrada (distancias y duraciones
+                                 // tienen rangos muy distintos): fija su rango, ±127 veces
+                                 // la escala. Dividida por el `inputMultipliers` de la
+                                 // primera capa da su escala común, `1 / K` con K entero
+};
+
+/**
+ * @class QuantizedNetwork
+ * @brief Inferencia int8 con acumuladores int32 para el MCU.
+ *
+ * - Los pesos ocupan un byte en vez de cuatro, y los productos se hacen en enteros.
+ * - Las capas ocultas RELU/LINEAR trabajan íntegramente en punto fijo; SIGMOID/TANH
+ *   ocultas y la capa de salida pasan a float solo para evaluar la activación.
+ * - Puede construirse sobre un `QuantizedModel` en flash (sin copias) o a partir de
+ *   un `NeuralNetwork` y un conjunto de calibración (`fromNetwork`), en cuyo caso
+ *   la instancia es dueña de los arreglos.
+ */
+class QuantizedNetwork {
+public:
+    /**
+     * @brief Envuelve un modelo ya cuantizado (p.ej. el de un encabezado generado).
+     *        El modelo debe seguir vivo mientras se use la red.
+     */
+    explicit QuantizedNetwork(const QuantizedModel& model);
+
+    QuantizedNetwork(QuantizedNetwork&&) = default;
+    QuantizedNetwork& operator=(QuantizedNetwork&&) = default;
+    QuantizedNetwork(const QuantizedNetwork&) = delete;
+    QuantizedNetwork& operator=(const QuantizedNetwork&) = delete;
+
+    /**
+     * @brief Cuantización post-entrenamiento de una red float.
+     * @param network Red con los pesos ya cargados.
+     * @param calibration Entradas representativas (p.ej. lecturas reales de sensores,
+     *        con las de -1 sin eco) usadas para fijar las escalas de las activaciones.
+     *        Las neuronas ocultas RELU/LINEAR se recortan al menor rango que no cambia
+     *        la salida float ni empeora la cuantizada sobre estas muestras (con una
+     *        octava de margen), así que deben cubrir los casos que importan.
+     * @param granularity Escala de pesos por capa o por neurona.
+     */
+    static QuantizedNetwork fromNetwork(const NeuralNetwork& network,
+                                        const std::vector<std::vector<float>>& calibration,
+                                        QuantizationGranularity granularity = QuantizationGranularity::PER_CHANNEL);
+
+    /**
+     * @brief Propagación hacia adelante sin reservas de memoria dinámica.
+     * @param input Puntero a `inputSize()` floats.
+     * @param output Puntero a `outputSize()` floats.
+     */
+    void forward(const float* input, float* output);
+
+    /** @brief Versión con vectores de `forward`. */
+    std::vector<float> forward(const std::vector<float>& input);
+
+    const QuantizedModel& model() const { return m_model; }
+    int inputSize() const { return m_model.layers[0].inSize; }
+    int outputSize() const { return m_model.layers[m_model.numLayers - 1].outSize; }
+
+    /** @brief Bytes ocupados por pesos, sesgos y escalas del modelo. */
+    size_t parameterBytes() const;
+
+private:
+    QuantizedNetwork() = default;
+    void initWorkspace();
+
+    /**
+     * @brief Cuantiza `network` con los rangos ya elegidos por `fromNetwork`: máximo
+     *        absoluto de cada entrada, techo de cada neurona oculta y máximo de la salida.
+     */
+    static QuantizedNetwork quantize(const NeuralNetwork& network,
+                                     const std::vector<float>& inputMax,
+                                     const std::vector<std::vector<float>>& clips,
+                                     float outputMax,
+                                     QuantizationGranularity granularity);
+
+    QuantizedModel m_model = {0, nullptr, nullptr};
+
+    // Almacenamiento propio cuando la red se construye con `fromNetwork`
+    std::vector<QuantizedLayer> m_ownedLayers;
+    std::vector<float> m_ownedInputScales;
+    std::vector<std::vector<int8_t>> m_ownedWeights;
+    std::vector<std::vector<int32_t>> m_ownedBiases;
+    std::vector<std::vector<float>> m_ownedAccScales;
+    std::vector<std::vector<int32_t>> m_ownedMultipliers;
+    std::vector<std::vector<int8_t>> m_ownedShifts;
+    std::vector<std::vector<int32_t>> m_ownedInputMultipliers;
+
+    // Activaciones int8 intermedias (ping-pong) y entrada de una capa en su
+    // escala común
+    std::vector<int32_t> m_input;
+    std::vector<int8_t> m_bufferA;
+    std::vector<int8_t> m_bufferB;
+};
+
+#endif // QUANTIZED_NETWORK_H
@@ -0,0 +1,120 @@
+#ifndef REPLAY_BUFFER_H
+#define REPLAY_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Forma de elegir las muestras de cada mini-lote.
+ */
+enum class ReplaySampling {
+    UNIFORM,     // Todas las muestras guardadas con la misma probabilidad
+    PRIORITIZED  // Proporcional a (pérdida + epsilon)^alpha, con un árbol de sumas
+};
+
+/**
+ * @brief Mini-lote sin copias: filas `indices[k]` de las matrices del anillo, en el
+ *        formato de `Trainer::trainBatch(inputs, targets, indices, count)`. Es válido
+ *        hasta la siguiente llamada a `sample`.
+ */
+struct ReplayBatch {
+    const float* inputs;     // capacidad x entradas
+    const float* targets;    // capacidad x salidas
+    const size_t* indices;   // count
+    size_t count;
+};
+
+/**
+ * @class ReplayBuffer
+ * @brief Memoria de experiencias de tamaño fijo para el aprendizaje en línea.
+ *
+ * - Toda la memoria (muestras, prioridades e índices del mini-lote) sale de un
+ *   único bloque reservado en el constructor, que nunca supera `budgetBytes`; la
+ *   capacidad es el máximo número de muestras que cabe en él.
+ * - `push` copia la muestra en el anillo en O(1) y, cuando está lleno, sobrescribe
+ *   la más antigua. En modo PRIORITIZED además actualiza una hoja del árbol de
+ *   sumas (O(log n)).
+ * - Las prioridades son la pérdida de `calculateError` / `Trainer` de cada muestra;
+ *   `updatePriorities` las refresca tras entrenar con ellas.
+ *
+ * El muestreo priorizado no aplica pesos de importancia: `accumulateGradients` no
+ * admite pesos por muestra, así que `alpha` es el único control del sesgo.
+ */
+class ReplayBuffer {
+public:
+    /**
+     * @param inputSize Entradas de la red.
+     * @param targetSize Salidas de la red.
+     * @param budgetBytes Memoria máxima del búfer, en bytes.
+     * @param maxBatch Tamaño máximo de los mini-lotes de `sample`.
+     * @param sampling Muestreo uniforme o priorizado.
+     * @param alpha Exponente de la prioridad (0 = uniforme, 1 = proporcional a la pérdida).
+     * @param seed Semilla del muestreo (0 = semilla por defecto).
+     */
+    ReplayBuffer(size_t inputSize, size_t targetSize, size_t budgetBytes, size_t maxBatch,
+                 ReplaySampling sampling = ReplaySampling::UNIFORM, float alpha = 0.6f,
+                 uint32_t seed = 0);
+
+    /**
+     * @brief Muestras que caben en `budgetBytes` con esta configuración.
+     */
+    static size_t capacityFor(size_t inputSize, size_t targetSize, size_t budgetBytes,
+                              size_t maxBatch, ReplaySampling sampling);
+
+    /**
+     * @brief Guarda una muestra.
+     * @param loss Pérdida de la muestra (solo se usa en modo PRIORITIZED).
+     * @return Posición de la muestra en el anillo.
+     */
+    size_t push(const float* input, const float* target, float loss = 0.0f);
+
+    /**
+     * @brief Elige `count` muestras con reemplazo. No reserva memoria.
+     * @param count Como máximo `maxBatch`; el lote está vacío si no hay muestras.
+     */
+    ReplayBatch sample(size_t count);
+
+    /**
+     * @brief Actualiza la prioridad de las muestras de un mini-lote.
+     * @param losses Pérdida de cada muestra de `batch` (p.ej. de `Trainer::trainBatch`).
+     */
+    void updatePriorities(const ReplayBatch& batch, const float* losses);
+
+    /** @brief Vacía el búfer (la memoria se conserva). */
+    void clear();
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    /** @brief Bytes reservados (siempre <= `budgetBytes`). */
+    size_t memoryBytes() const { return m_arena.size(); }
+
+private:
+    static size_t bytesFor(size_t capacity, size_t inputSize, size_t targetSize,
+                           size_t maxBatch, ReplaySampling sampling);
+    void setPriority(size_t slot, float loss);
+    size_t samplePrioritized();
+
+    size_t m_inputSize;
+    size_t m_targetSize;
+    size_t m_capacity;
+    size_t m_maxBatch;
+    ReplaySampling m_sampling;
+    float m_alpha;
+
+    size_t m_size = 0;
+    size_t m_next = 0;       // Posición que se escribirá a continuación
+    uint32_t m_rngState;
+
+    // Bloque único: [índices del lote | entradas | salidas | árbol de sumas]
+    std::vector<uint8_t> m_arena;
+    size_t* m_batchIndices = nullptr;
+    float* m_inputs = nullptr;
+    float* m_targets = nullptr;
+    // Árbol de sumas en forma de montículo: nodo 1 = raíz, hojas en
+    // [capacidad, 2 * capacidad). Solo en modo PRIORITIZED.
+    float* m_tree = nullptr;
+};
+
+#endif // REPLAY_BUFFER_H
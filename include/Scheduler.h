@@ -0,0 +1,145 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Función de una tarea; recibe el `context` con el que se registró.
+ */
+typedef void (*TaskFunction)(void* context);
+
+/**
+ * @brief Cuándo y con qué urgencia se ejecuta una tarea.
+ */
+struct TaskConfig {
+    unsigned long periodUs = 0;    // 0 = solo se activa con `Scheduler::trigger`
+    unsigned long deadlineUs = 0;  // Plazo desde la activación hasta el final; 0 = sin plazo
+    uint8_t priority = 0;          // Entre las tareas listas, se ejecuta antes la mayor
+    // De fondo: solo se ejecuta si su duración prevista cabe antes de la próxima
+    // activación periódica de una tarea más prioritaria (p.ej. el entrenamiento)
+    bool background = false;
+    // Duración prevista (us) de una tarea de fondo hasta la primera medida. Después
+    // sigue a las medidas: sube de golpe con una ejecución más larga y baja poco a
+    // poco con las más cortas
+    unsigned long budgetUs = 0;
+    // Espera máxima (us) de una tarea de fondo desde su activación; pasada, se
+    // ejecuta aunque no quepa en la holgura, en cuanto no haya otra más prioritaria
+    // lista (retrasa una vez al sensado). 0 = puede esperar indefinidamente
+    unsigned long maxWaitUs = 0;
+};
+
+/**
+ * @brief Estadísticas de una tarea. Latencia = inicio - activación.
+ */
+struct TaskStats {
+    uint32_t runs;
+    uint32_t deadlineMisses;
+    uint32_t skipped;        // Activaciones perdidas: periodos saltados o disparos repetidos
+    uint32_t deferred;       // Activaciones de fondo que esperaron por falta de holgura
+    uint32_t forced;         // Activaciones de fondo ejecutadas al agotar `maxWaitUs`
+    unsigned long meanLatencyUs;
+    unsigned long maxLatencyUs;
+    unsigned long jitterUs;  // Latencia máxima - mínima
+    unsigned long meanRunUs;
+    unsigned long maxRunUs;
+};
+
+/**
+ * @brief Escribe texto de `Scheduler::dump` (p.ej. `Serial.print`).
+ */
+typedef void (*SchedulerWriter)(const char* text, void* context);
+
+/**
+ * @class Scheduler
+ * @brief Planificador cooperativo de tareas con periodos, plazos y prioridades
+ *        propios, sobre `micros()`.
+ *
+ * - Las tareas periódicas se activan en múltiplos exactos de su periodo desde
+ *   `begin()` (sin deriva); si se pierde una activación entera se cuenta como
+ *   saltada y se sigue con la siguiente. Las de periodo 0 se activan con
+ *   `trigger()`, p.ej. la inferencia cuando hay una lectura nueva.
+ * - `runOnce()` ejecuta como mucho una tarea: la activada de mayor prioridad (a
+ *   igualdad, la que lleva más tiempo esperando). Ninguna tarea interrumpe a otra,
+ *   así que la latencia de una tarea está acotada por la duración de la tarea más
+ *   larga que no sea de fondo, salvo cuando una de fondo agota su `maxWaitUs`.
+ * - Mide latencia, jitter, duración e incumplimientos de plazo de cada tarea.
+ * - Sin memoria dinámica: hasta `MAX_TASKS` tareas. Todo ocurre en el hilo que
+ *   llama a `runOnce()` (loop()); `trigger()` no es seguro desde una interrupción.
+ *
+ * En el PC funciona igual sobre el reloj simulado de lib/ArduinoSim.
+ */
+class Scheduler {
+public:
+    static const int MAX_TASKS = 8;
+
+    /**
+     * @param name Nombre para `dump` (no se copia).
+     * @return Identificador de la tarea, o -1 si ya hay `MAX_TASKS`.
+     */
+    int add(const char* name, TaskFunction function, void* context, const TaskConfig& config);
+
+    /**
+     * @brief Fija el instante cero: las tareas periódicas se activan ya y luego
+     *        cada periodo. Llamar desde setup(), tras registrar las tareas.
+     */
+    void begin();
+
+    /**
+     * @brief Activa una tarea. Si ya estaba activada, conserva la activación más
+     *        antigua y cuenta la nueva como saltada.
+     */
+    void trigger(int task);
+
+    /**
+     * @brief Ejecuta la tarea activada de mayor prioridad que pueda ejecutarse.
+     * @return false si no había ninguna.
+     */
+    bool runOnce();
+
+    /**
+     * @brief Microsegundos hasta la próxima activación periódica (0 si ya venció
+     *        alguna). Cuando `runOnce()` devuelve false, sirve para dormir o, en la
+     *        simulación, avanzar el reloj: ninguna tarea estará lista antes.
+     */
+    unsigned long timeToNextRelease() const;
+
+    int taskCount() const { return m_count; }
+    const char* name(int task) const { return m_tasks[task].name; }
+    TaskStats stats(int task) const;
+    void resetStats();
+
+    /** @brief Escribe una tabla con las estadísticas de todas las tareas. */
+    void dump(SchedulerWriter writer, void* context) const;
+
+private:
+    struct Task {
+        const char* name;
+        TaskFunction function;
+        void* context;
+        TaskConfig config;
+        bool pending;
+        bool deferred;
+        unsigned long release;      // Activación pendiente
+        unsigned long nextRelease;  // Siguiente activación periódica
+        unsigned long expectedRunUs;  // Para la holgura; `resetStats` no la borra
+        // Estadísticas
+        uint32_t runs;
+        uint32_t deadlineMisses;
+        uint32_t skipped;
+        uint32_t deferredCount;
+        uint32_t forced;
+        uint64_t latencySumUs;
+        unsigned long minLatencyUs;
+        unsigned long maxLatencyUs;
+        uint64_t runSumUs;
+        unsigned long maxRunUs;
+    };
+
+    void releaseDue(unsigned long now);
+    bool fitsInSlack(const Task& task, unsigned long now) const;
+
+    Task m_tasks[MAX_TASKS];
+    int m_count = 0;
+};
+
+#endif // SCHEDULER_H
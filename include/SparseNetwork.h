@@ -0,0 +1,127 @@
+#ifndef SPARSE_NETWORK_H
+#define SPARSE_NETWORK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "Activations.h"
+
+class NeuralNetwork;
+
+/**
+ * @brief Capa densa podada en formato CSR por filas de entrada. Todos los punteros
+ *        pueden apuntar a arreglos `const` en flash (ver `tools/sparse_export`).
+ *
+ * Los pesos no nulos de la entrada `i` están en `values[rowStart[i] .. rowStart[i+1])`,
+ * y `columns[k]` es la neurona de salida de `values[k]`. Es el mismo orden
+ * `i * outSize + j` de la matriz densa, sin los ceros:
+ *   out_j = act(b_j + sum_i x_i * W[i][j])
+ * Recorrer por entradas permite saltarse de una vez todas las filas con `x_i == 0`,
+ * que tras una capa RELU son la mayoría.
+ */
+struct SparseLayer {
+    int inSize;
+    int outSize;
+    ActivationFunction activation;
+    const uint32_t* rowStart;    // inSize + 1
+    const uint16_t* columns;     // rowStart[inSize]
+    const float* values;         // rowStart[inSize]
+    const float* biases;         // outSize
+};
+
+/**
+ * @brief Modelo disperso completo.
+ */
+struct SparseModel {
+    int numLayers;
+    const SparseLayer* layers;
+};
+
+/**
+ * @class SparseNetwork
+ * @brief Inferencia float sobre capas podadas.
+ *
+ * - Solo se guardan y se multiplican los pesos no nulos.
+ * - Las neuronas ocultas muertas se eliminan: sin pesos de entrada su salida es la
+ *   constante `act(b_j)`, que se suma a los sesgos de la capa siguiente; sin pesos
+ *   de salida no influyen en nada. Las entradas y salidas de la red se conservan.
+ * - Puede construirse sobre un `SparseModel` en flash (sin copias) o a partir de un
+ *   `NeuralNetwork` (`fromNetwork`), en cuyo caso la instancia es dueña de los arreglos.
+ *
+ * El entrenamiento sigue siendo denso (`NeuralNetwork`): la poda se aplica a una red
+ * ya entrenada con `pruneByMagnitude` y después se convierte.
+ */
+class SparseNetwork {
+public:
+    /**
+     * @brief Envuelve un modelo disperso ya generado (p.ej. el de un encabezado).
+     *        El modelo debe seguir vivo mientras se use la red.
+     */
+    explicit SparseNetwork(const SparseModel& model);
+
+    SparseNetwork(SparseNetwork&&) = default;
+    SparseNetwork& operator=(SparseNetwork&&) = default;
+    SparseNetwork(const SparseNetwork&) = delete;
+    SparseNetwork& operator=(const SparseNetwork&) = delete;
+
+    /**
+     * @brief Convierte una red float a formato disperso. Los pesos con valor absoluto
+     *        menor o igual que `threshold` se consideran nulos.
+     * @param network Red con los pesos ya cargados (normalmente tras `pruneByMagnitude`).
+     * @param threshold Umbral de poda; con 0 solo se descartan los ceros exactos.
+     */
+    static SparseNetwork fromNetwork(const NeuralNetwork& network, float threshold = 0.0f);
+
+    /**
+     * @brief Propagación hacia adelante sin reservas de memoria dinámica.
+     * @param input Puntero a `inputSize()` floats.
+     * @param output Puntero a `outputSize()` floats.
+     */
+    void forward(const float* input, float* output);
+
+    /** @brief Versión con vectores de `forward`. */
+    std::vector<float> forward(const std::vector<float>& input);
+
+    /** @brief Selecciona la implementación de SIGMOID y TANH (ver `ActivationMode`). */
+    void setActivationMode(ActivationMode mode) { m_activationMode = mode; }
+
+    const SparseModel& model() const { return m_model; }
+    int inputSize() const { return m_model.layers[0].inSize; }
+    int outputSize() const { return m_model.layers[m_model.numLayers - 1].outSize; }
+
+    /** @brief Número de pesos no nulos almacenados. */
+    size_t nonZeros() const;
+
+    /** @brief Bytes ocupados por pesos, índices y sesgos del modelo. */
+    size_t parameterBytes() const;
+
+private:
+    SparseNetwork() = default;
+    void initWorkspace();
+
+    SparseModel m_model = {0, nullptr};
+    ActivationMode m_activationMode = ActivationMode::EXACT;
+
+    // Almacenamiento propio cuando la red se construye con `fromNetwork`
+    std::vector<SparseLayer> m_ownedLayers;
+    std::vector<std::vector<uint32_t>> m_ownedRowStart;
+    std::vector<std::vector<uint16_t>> m_ownedColumns;
+    std::vector<std::vector<float>> m_ownedValues;
+    std::vector<std::vector<float>> m_ownedBiases;
+
+    // Activaciones intermedias (ping-pong)
+    std::vector<float> m_bufferA;
+    std::vector<float> m_bufferB;
+};
+
+/**
+ * @brief Poda por magnitud: en cada capa pone a cero la fracción `sparsity` de los
+ *        pesos con menor valor absoluto. Los sesgos no se tocan. Si la red usaba
+ *        parámetros prestados pasa a tener copia propia.
+ * @param network Red a podar.
+ * @param sparsity Fracción de pesos a anular en cada capa, en [0, 1].
+ * @return Número total de pesos nulos tras la poda.
+ */
+size_t pruneByMagnitude(NeuralNetwork& network, float sparsity);
+
+#endif // SPARSE_NETWORK_H
@@ -0,0 +1,80 @@
+#ifndef STATIC_NETWORK_H
+#define STATIC_NETWORK_H
+
+#include "Activations.h"
+
+/**
+ * @class StaticNetwork
+ * @brief Red feedforward de una capa oculta con topología fija en tiempo de compilación.
+ *
+ * - Los tamaños de capa y las funciones de activación son parámetros de plantilla,
+ *   por lo que el compilador conoce todos los límites de los bucles y puede desenrollarlos.
+ * - No copia los parámetros: guarda punteros a los arreglos `const` de
+ *   `pesos_red_neuronal.h`, que en el ESP32 residen en flash. No usa RAM para pesos.
+ * - Usa la misma disposición de pesos (`i * Out + j`) y el mismo orden de suma que
+ *   `NeuralNetwork::forward`, así que la salida es idéntica bit a bit.
+ *
+ * Ejemplo:
+ * @code
+ * static const StaticNetwork<4, 8, 4> red(PESOS_CAPA_0, SESGOS_CAPA_0,
+ *                                         PESOS_CAPA_1, SESGOS_CAPA_1);
+ * float salida[4];
+ * red.forward(entrada, salida);
+ * @endcode
+ */
+template <int In, int Hidden, int Out,
+          ActivationFunction HiddenAct = ActivationFunction::RELU,
+          ActivationFunction OutputAct = ActivationFunction::SIGMOID>
+class StaticNetwork {
+public:
+    static_assert(In > 0 && Hidden > 0 && Out > 0, "Las capas deben tener al menos una neurona.");
+
+    static constexpr int kInputs  = In;
+    static constexpr int kHidden  = Hidden;
+    static constexpr int kOutputs = Out;
+
+    /**
+     * @brief Constructor. Los tamaños de los arreglos se comprueban al compilar.
+     * @param weights0 Pesos entrada -> oculta, aplanados como `i * Hidden + j`.
+     * @param biases0 Sesgos de la capa oculta.
+     * @param weights1 Pesos oculta -> salida, aplanados como `i * Out + j`.
+     * @param biases1 Sesgos de la capa de salida.
+     */
+    constexpr StaticNetwork(const float (&weights0)[In * Hidden],
+                            const float (&biases0)[Hidden],
+                            const float (&weights1)[Hidden * Out],
+                            const float (&biases1)[Out])
+        : m_weights0(weights0), m_biases0(biases0),
+          m_weights1(weights1), m_biases1(biases1) {}
+
+    /**
+     * @brief Propagación hacia adelante sin memoria dinámica.
+     * @param input Puntero a `In` floats de entrada.
+     * @param output Puntero a `Out` floats donde se escribe la salida.
+     */
+    void forward(const float* input, float* output) const {
+        float hidden[Hidden];
+        denseLayer<In, Hidden, HiddenAct>(input, m_weights0, m_biases0, hidden);
+        denseLayer<Hidden, Out, OutputAct>(hidden, m_weights1, m_biases1, output);
+    }
+
+private:
+    template <int InSize, int OutSize, ActivationFunction Act>
+    static inline void denseLayer(const float* in, const float* weights,
+                                  const float* biases, float* out) {
+        for (int j = 0; j < OutSize; j++) {
+            float sum = 0.0f;
+            for (int i = 0; i < InSize; i++) {
+                sum += in[i] * weights[i * OutSize + j];
+            }
+            out[j] = applyActivation(sum + biases[j], Act);
+        }
+    }
+
+    const float* m_weights0;
+    const float* m_biases0;
+    const float* m_weights1;
+    const float* m_biases1;
+};
+
+#endif // STATIC_NETWORK_H
@@ -0,0 +1,108 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+static const uint16_t TELEMETRY_SYNC = 0xA55A;
+static const uint8_t TELEMETRY_VERSION = 1;
+
+/**
+ * @brief Registro binario de un ciclo de control (56 bytes, little-endian).
+ *
+ * Offset  Tipo      Campo
+ *   0     uint16    sincronismo (0xA55A)
+ *   2     uint8     versión (1)
+ *   3     uint8     acción elegida (`findClosestMatch`)
+ *   4     uint32    número de secuencia (los huecos son registros perdidos)
+ *   8     uint32    marca de tiempo (millis)
+ *  12     float[4]  entradas: dist. izq., dist. der., dur. izq., dur. der.
+ *  28     float[4]  salidas de la red
+ *  44     float     error (MSE) del entrenamiento
+ *  48     uint8     motores encendidos (bit i = IN(i+1))
+ *  49     uint8[3]  reservado (0)
+ *  52     uint32    CRC-32 de los bytes 0..51
+ *
+ * Todos los campos están alineados de forma natural, así que el struct no tiene
+ * relleno y se escribe tal cual.
+ */
+struct TelemetryRecord {
+    uint16_t sync;
+    uint8_t version;
+    uint8_t action;
+    uint32_t sequence;
+    uint32_t timestampMs;
+    float inputs[4];
+    float outputs[4];
+    float loss;
+    uint8_t motors;
+    uint8_t reserved[3];
+    uint32_t crc;
+};
+
+static_assert(sizeof(TelemetryRecord) == 56, "TelemetryRecord debe ocupar 56 bytes");
+
+static const size_t TELEMETRY_CRC_OFFSET = 52;
+
+/**
+ * @brief Destino de los datos drenados (p.ej. `Serial.write`).
+ * @return Bytes aceptados.
+ */
+typedef size_t (*TelemetryWriter)(const uint8_t* data, size_t size, void* context);
+
+/**
+ * @class Telemetry
+ * @brief Cola circular sin bloqueos (un productor, un consumidor) de registros
+ *        de telemetría.
+ *
+ * `push` se llama en el ciclo de control: copia unos pocos campos y no formatea
+ * texto ni toca el puerto serie. `drain`, fuera del ciclo (entre ticks, o desde
+ * otra tarea), calcula el CRC de los registros pendientes y los envía en una sola
+ * escritura. Si la cola está llena el registro se descarta y se cuenta.
+ */
+class Telemetry {
+public:
+    /**
+     * @param capacity Registros en cola; se redondea a potencia de dos.
+     */
+    explicit Telemetry(size_t capacity = 32);
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    /**
+     * @brief Encola un registro (productor). No reserva memoria.
+     * @return false si la cola estaba llena y el registro se descartó.
+     */
+    bool push(uint32_t timestampMs, const float* inputs, const float* outputs,
+              int action, float loss);
+
+    /**
+     * @brief Envía hasta `maxRecords` registros pendientes con una única llamada
+     *        a `writer` (consumidor).
+     * @return Registros enviados.
+     */
+    size_t drain(TelemetryWriter writer, void* context, size_t maxRecords);
+
+    /** @brief Registros en cola pendientes de `drain`. */
+    size_t pending() const;
+
+    /** @brief Registros descartados por cola llena. */
+    uint32_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    size_t capacity() const { return m_records.size(); }
+
+private:
+    std::vector<TelemetryRecord> m_records;
+    std::vector<uint8_t> m_staging;  // Registros drenados, listos para una escritura
+    size_t m_mask;
+    uint32_t m_sequence = 0;
+
+    std::atomic<uint32_t> m_head{0};  // Siguiente posición a escribir (productor)
+    std::atomic<uint32_t> m_tail{0};  // Siguiente posición a leer (consumidor)
+    std::atomic<uint32_t> m_dropped{0};
+};
+
+#endif // TELEMETRY_H
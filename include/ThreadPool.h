@@ -0,0 +1,62 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Grupo de hilos con robo de trabajo para el entrenamiento en el PC.
+ *
+ * `parallelFor` reparte los índices en colas por hilo; cada hilo consume su cola
+ * por el final y, cuando se vacía, roba del principio de las colas de los demás.
+ * Así un hilo lento no retrasa el lote completo.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param numThreads Número de hilos de trabajo (mínimo 1).
+     */
+    explicit ThreadPool(size_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @brief Número de hilos de trabajo. */
+    size_t size() const { return m_threads.size(); }
+
+    /**
+     * @brief Ejecuta `task(i)` para cada i en [0, count) y espera a que terminen.
+     *        No debe llamarse desde dentro de una tarea.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void workerLoop(size_t id);
+    bool popTask(size_t id, size_t& index);
+
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<Queue[]> m_queues;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_done;
+    const std::function<void(size_t)>* m_task = nullptr;
+    std::atomic<size_t> m_pending{0};
+    size_t m_generation = 0;
+    bool m_stop = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,125 @@
+#ifndef TRAINER_H
+#define TRAINER_H
+
+#include <stdint.h>
+#include <vector>
+#include "NeuralNetwork.h"
+
+/**
+ * @brief Optimizadores disponibles para el entrenamiento por mini-lotes.
+ */
+enum class Optimizer {
+    SGD,       // Descenso de gradiente simple
+    MOMENTUM,  // SGD con momento
+    ADAM       // Adam (Kingma & Ba)
+};
+
+/**
+ * @brief Parámetros del entrenamiento.
+ */
+struct TrainerConfig {
+    Optimizer optimizer = Optimizer::ADAM;
+    float learningRate = 0.001f;
+    float momentum = 0.9f;     // Solo MOMENTUM
+    float beta1 = 0.9f;        // Solo ADAM
+    float beta2 = 0.999f;      // Solo ADAM
+    float epsilon = 1e-8f;     // Solo ADAM
+    size_t batchSize = 32;
+    bool shuffle = true;       // Barajar las muestras en cada época
+    uint32_t seed = 0;         // Semilla del barajado (resultado reproducible)
+};
+
+/**
+ * @class Trainer
+ * @brief Entrenamiento por mini-lotes sobre un `NeuralNetwork`.
+ *
+ * - Acumula los gradientes de cada lote en el buffer de gradientes de la red
+ *   (`NeuralNetwork::gradients`, con `accumulateGradients`), con las derivadas de
+ *   las activaciones.
+ * - Mantiene el estado del optimizador (momento o Adam) en buffers contiguos y, en
+ *   una sola pasada por parámetro, lo actualiza, modifica el parámetro en el sitio
+ *   y deja el gradiente a cero.
+ * - Los conjuntos de datos son matrices aplanadas por filas: `inputs` de
+ *   `N x entradas` y `targets` de `N x salidas`.
+ *
+ * Todos los buffers se reservan en el constructor; entrenar no reserva memoria
+ * salvo el índice de barajado, que se dimensiona al tamaño del dataset.
+ */
+class Trainer {
+public:
+    Trainer(NeuralNetwork& network, const TrainerConfig& config = TrainerConfig());
+
+    /**
+     * @brief Entrena con un lote y aplica una actualización del optimizador.
+     * @param inputs Matriz `count x entradas`.
+     * @param targets Matriz `count x salidas`.
+     * @return MSE medio del lote (antes de actualizar).
+     */
+    float trainBatch(const float* inputs, const float* targets, size_t count);
+
+    /**
+     * @brief Entrena con las filas `indices` de las matrices, sin copiarlas (p.ej.
+     *        un mini-lote de `ReplayBuffer`).
+     * @param sampleLosses Si no es nulo, recibe el MSE de cada muestra (`count` floats).
+     * @return MSE medio del lote (antes de actualizar).
+     */
+    float trainBatch(const float* inputs, const float* targets, const size_t* indices,
+                     size_t count, float* sampleLosses = nullptr);
+
+    /**
+     * @brief Una época completa sobre el dataset, en lotes de `batchSize`.
+     * @return MSE medio de las muestras durante la época.
+     */
+    float trainEpoch(const std::vector<float>& inputs, const std::vector<float>& targets);
+
+    /**
+     * @brief MSE medio de la red sobre el dataset (con `calculateError`), sin entrenar.
+     */
+    float evaluate(const std::vector<float>& inputs, const std::vector<float>& targets);
+
+    /**
+     * @brief Entrena épocas hasta que `evaluate` baje de `targetMse` o se alcance `maxEpochs`.
+     * @return Épocas hasta llegar a `targetMse` (1 a `maxEpochs`), o 0 si no se llegó.
+     */
+    size_t fit(const std::vector<float>& inputs, const std::vector<float>& targets,
+               size_t maxEpochs, float targetMse);
+
+    /** @brief Número de actualizaciones aplicadas hasta ahora. */
+    size_t steps() const { return m_step; }
+
+    virtual ~Trainer() = default;
+
+protected:
+    /**
+     * @brief Suma a `m_gradients` el gradiente de las filas indicadas del lote.
+     * @param indices Filas a usar, o nullptr para las `count` primeras.
+     * @param sampleLosses Si no es nulo, recibe el MSE de cada muestra.
+     * @return Suma de los MSE de las muestras.
+     */
+    virtual float accumulate(const float* inputs, const float* targets, const size_t* indices,
+                             size_t count, float* sampleLosses = nullptr);
+
+    NeuralNetwork& m_network;
+    size_t m_inputSize;
+    size_t m_outputSize;
+
+    // Gradientes de la red (`NeuralNetwork::gradients`), con el orden [W0, b0, W1, b1, ...]
+    float* m_gradients;
+    size_t m_parameterCount;
+
+private:
+    void applyOptimizer(size_t count);
+    size_t numSamples(const std::vector<float>& inputs, const std::vector<float>& targets) const;
+
+    TrainerConfig m_config;
+    size_t m_step = 0;
+
+    // Estado del optimizador, con el mismo orden que `m_gradients`
+    std::vector<float> m_velocity;   // MOMENTUM: velocidad; ADAM: primer momento
+    std::vector<float> m_secondMoment;
+
+    std::vector<size_t> m_order;
+    uint32_t m_rngState;
+};
+
+#endif // TRAINER_H
@@ -0,0 +1,95 @@
+#ifndef ARDUINO_SIM_H
+#define ARDUINO_SIM_H
+
+// -----------------------------------------------------------------------------
+// HAL de Arduino simulado para el entorno `native` de PlatformIO.
+// Implementa solo lo que usa el proyecto, sobre un reloj simulado determinista.
+// -----------------------------------------------------------------------------
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+#define digitalPinToInterrupt(pin) (pin)
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+// Registros de salida del GPIO del ESP32 (soc/gpio_reg.h). Escribir una máscara en
+// W1TS pone en alto esos pines y en W1TC los pone en bajo; el resto no cambia. Cada
+// escritura es una sola operación del bus. OUT = GPIO0-31, OUT1 = GPIO32-39.
+#define DR_REG_GPIO_BASE   0x3ff44000
+#define GPIO_OUT_W1TS_REG  (DR_REG_GPIO_BASE + 0x0008)
+#define GPIO_OUT_W1TC_REG  (DR_REG_GPIO_BASE + 0x000c)
+#define GPIO_OUT1_W1TS_REG (DR_REG_GPIO_BASE + 0x0014)
+#define GPIO_OUT1_W1TC_REG (DR_REG_GPIO_BASE + 0x0018)
+#define REG_WRITE(reg, value) simRegWrite((reg), (value))
+void simRegWrite(uint32_t reg, uint32_t value);
+
+// PWM por hardware del ESP32 (LEDC, API del núcleo de Arduino 2.x)
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout = 1000000UL);
+
+// Las interrupciones se ejecutan dentro del avance del reloj simulado, con
+// micros() igual al instante exacto del flanco.
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+/**
+ * @brief Puerto serie simulado. No escribe en la consola salvo que se active el
+ *        eco; siempre acumula una huella (FNV-1a) de todo lo enviado para comprobar
+ *        que dos ejecuciones producen exactamente la misma salida.
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    size_t setTxBufferSize(size_t size);
+    int availableForWrite();
+
+    size_t write(uint8_t byte);
+    size_t write(const uint8_t* buffer, size_t size);
+
+    size_t print(const char* text);
+    size_t print(char value);
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    size_t println(const char* text);
+    size_t println(char value);
+    size_t println(int value);
+    size_t println(unsigned int value);
+    size_t println(long value);
+    size_t println(unsigned long value);
+    size_t println(double value, int digits = 2);
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_SIM_H
@@ -0,0 +1,423 @@
+#include "Arduino.h"
+#include "ArduinoSim.h"
+
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Estado del HAL simulado. Todo es de inicialización estática para que los
+// constructores globales (HCSR04, MotorGroup) puedan llamar a pinMode antes de main().
+// -----------------------------------------------------------------------------
+namespace {
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+// Tiempo que tarda el sensor en levantar ECHO tras el disparo (datasheet ~450 us).
+const uint64_t ECHO_LATENCY_US = 450;
+// Sin obstáculo, el HC-SR04 mantiene ECHO en alto unos 38 ms.
+const uint64_t NO_ECHO_PULSE_US = 38000;
+const int MAX_EDGES = 32;
+const int LEDC_CHANNELS = 16;
+
+struct Edge {
+    uint64_t us;
+    uint8_t pin;
+    uint8_t level;
+};
+
+struct Interrupt {
+    void (*handler)(void);
+    void (*handlerArg)(void*);
+    void* arg;
+    int mode;
+};
+
+uint64_t g_nowUs = 0;
+
+uint8_t g_pinMode[SIM_MAX_PINS];
+uint8_t g_pinLevel[SIM_MAX_PINS];
+uint32_t g_pinWrites[SIM_MAX_PINS];
+int g_triggerSensor[SIM_MAX_PINS];
+uint8_t g_triggerEcho[SIM_MAX_PINS];
+bool g_triggerBound[SIM_MAX_PINS];
+Interrupt g_interrupts[SIM_MAX_PINS];
+bool g_interruptsEnabled = true;
+
+uint32_t g_pinDuty[SIM_MAX_PINS];
+uint8_t g_ledcPin[LEDC_CHANNELS];
+bool g_ledcBound[LEDC_CHANNELS];
+uint32_t g_gpioOperations = 0;
+SimGpioObserver g_observer = nullptr;
+void* g_observerContext = nullptr;
+
+// Flancos pendientes, ordenados por instante
+Edge g_edges[MAX_EDGES];
+int g_edgeCount = 0;
+
+SimDistanceSource g_source = nullptr;
+void* g_sourceContext = nullptr;
+
+FILE* g_serialCapture = nullptr;
+size_t g_txBufferSize = 128;  // FIFO de la UART del ESP32
+uint32_t g_serialHash = FNV_OFFSET;
+uint64_t g_serialBytes = 0;
+
+bool validPin(uint8_t pin) {
+    return pin < SIM_MAX_PINS;
+}
+
+void scheduleEdge(uint64_t us, uint8_t pin, uint8_t level) {
+    if (g_edgeCount == MAX_EDGES) return;
+    int i = g_edgeCount++;
+    while (i > 0 && g_edges[i - 1].us > us) {
+        g_edges[i] = g_edges[i - 1];
+        --i;
+    }
+    g_edges[i] = {us, pin, level};
+}
+
+void applyEdge(const Edge& edge) {
+    uint8_t previous = g_pinLevel[edge.pin];
+    g_pinLevel[edge.pin] = edge.level;
+    if (!g_interruptsEnabled || previous == edge.level) return;
+
+    const Interrupt& irq = g_interrupts[edge.pin];
+    bool fires = irq.mode == CHANGE || (irq.mode == RISING && edge.level == HIGH) ||
+                 (irq.mode == FALLING && edge.level == LOW);
+    if (!fires) return;
+    if (irq.handlerArg != nullptr) {
+        irq.handlerArg(irq.arg);
+    } else if (irq.handler != nullptr) {
+        irq.handler();
+    }
+}
+
+// Avanza el reloj hasta `targetUs` entregando los flancos en su instante exacto.
+void advanceTo(uint64_t targetUs) {
+    while (g_edgeCount > 0 && g_edges[0].us <= targetUs) {
+        Edge edge = g_edges[0];
+        for (int i = 1; i < g_edgeCount; ++i) g_edges[i - 1] = g_edges[i];
+        g_edgeCount--;
+        if (edge.us > g_nowUs) g_nowUs = edge.us;
+        applyEdge(edge);
+    }
+    if (targetUs > g_nowUs) g_nowUs = targetUs;
+}
+
+// Flanco de bajada del TRIG: el sensor emite y programa el pulso ECHO.
+void fireUltrasonic(uint8_t trigPin) {
+    uint8_t echoPin = g_triggerEcho[trigPin];
+    uint64_t rise = g_nowUs + ECHO_LATENCY_US;
+    uint64_t width = NO_ECHO_PULSE_US;
+    if (g_source != nullptr) {
+        float distance = g_source(g_triggerSensor[trigPin], g_nowUs, g_sourceContext);
+        if (distance > 0.0f) {
+            width = static_cast<uint64_t>(distance * 2.0f / 0.034f + 0.5f);
+            if (width > NO_ECHO_PULSE_US) width = NO_ECHO_PULSE_US;
+        }
+    }
+    scheduleEdge(rise, echoPin, HIGH);
+    scheduleEdge(rise + width, echoPin, LOW);
+}
+
+// Escritura de un pin de salida desde el código del vehículo.
+void writePin(uint8_t pin, uint8_t level) {
+    bool falling = g_pinLevel[pin] == HIGH && level == LOW;
+    g_pinLevel[pin] = level;
+    g_pinWrites[pin]++;
+    if (falling && g_triggerBound[pin]) fireUltrasonic(pin);
+}
+
+// Cierra una operación de salida: la cuenta y avisa al observador.
+void outputDone() {
+    g_gpioOperations++;
+    if (g_observer != nullptr) g_observer(g_observerContext);
+}
+
+void writeMask(uint8_t firstPin, uint32_t mask, uint8_t level) {
+    for (int bit = 0; bit < 32; ++bit) {
+        if ((mask >> bit) & 1u) {
+            uint8_t pin = static_cast<uint8_t>(firstPin + bit);
+            if (validPin(pin)) writePin(pin, level);
+        }
+    }
+}
+
+const Edge* findEdge(uint8_t pin, uint8_t level) {
+    for (int i = 0; i < g_edgeCount; ++i) {
+        if (g_edges[i].pin == pin && g_edges[i].level == level) return &g_edges[i];
+    }
+    return nullptr;
+}
+
+} // namespace
+
+HardwareSerial Serial;
+
+uint64_t simNowMicros() {
+    return g_nowUs;
+}
+
+void simAdvanceMicros(uint64_t us) {
+    advanceTo(g_nowUs + us);
+}
+
+void simBindUltrasonic(uint8_t trigPin, uint8_t echoPin, int sensor) {
+    if (!validPin(trigPin) || !validPin(echoPin)) return;
+    g_triggerSensor[trigPin] = sensor;
+    g_triggerEcho[trigPin] = echoPin;
+    g_triggerBound[trigPin] = true;
+}
+
+void simSetDistanceSource(SimDistanceSource source, void* context) {
+    g_source = source;
+    g_sourceContext = context;
+}
+
+int simPinLevel(uint8_t pin) {
+    return validPin(pin) ? g_pinLevel[pin] : LOW;
+}
+
+uint32_t simPinWrites(uint8_t pin) {
+    return validPin(pin) ? g_pinWrites[pin] : 0;
+}
+
+uint32_t simTotalPinWrites() {
+    uint32_t total = 0;
+    for (int p = 0; p < SIM_MAX_PINS; ++p) total += g_pinWrites[p];
+    return total;
+}
+
+uint32_t simGpioOperations() {
+    return g_gpioOperations;
+}
+
+uint32_t simPinDuty(uint8_t pin) {
+    return validPin(pin) ? g_pinDuty[pin] : 0;
+}
+
+void simSetGpioObserver(SimGpioObserver observer, void* context) {
+    g_observer = observer;
+    g_observerContext = context;
+}
+
+bool simSetSerialCapture(const char* path) {
+    if (g_serialCapture != nullptr) fclose(g_serialCapture);
+    g_serialCapture = fopen(path, "wb");
+    return g_serialCapture != nullptr;
+}
+
+uint32_t simSerialFingerprint() {
+    return g_serialHash;
+}
+
+uint64_t simSerialBytes() {
+    return g_serialBytes;
+}
+
+// -----------------------------------------------------------------------------
+// API de Arduino
+// -----------------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (validPin(pin)) g_pinMode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (!validPin(pin)) return;
+    writePin(pin, value ? HIGH : LOW);
+    outputDone();
+}
+
+int digitalRead(uint8_t pin) {
+    return simPinLevel(pin);
+}
+
+void simRegWrite(uint32_t reg, uint32_t value) {
+    switch (reg) {
+        case GPIO_OUT_W1TS_REG:  writeMask(0, value, HIGH); break;
+        case GPIO_OUT_W1TC_REG:  writeMask(0, value, LOW); break;
+        case GPIO_OUT1_W1TS_REG: writeMask(32, value, HIGH); break;
+        case GPIO_OUT1_W1TC_REG: writeMask(32, value, LOW); break;
+        default: return;
+    }
+    outputDone();
+}
+
+double ledcSetup(uint8_t, double freq, uint8_t) {
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (!validPin(pin) || channel >= LEDC_CHANNELS) return;
+    g_ledcPin[channel] = pin;
+    g_ledcBound[channel] = true;
+}
+
+// El nivel del pin refleja si el PWM está activo (ciclo > 0)
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNELS || !g_ledcBound[channel]) return;
+    uint8_t pin = g_ledcPin[channel];
+    g_pinDuty[pin] = duty;
+    writePin(pin, duty > 0 ? HIGH : LOW);
+    outputDone();
+}
+
+unsigned long millis() {
+    return static_cast<unsigned long>(g_nowUs / 1000);
+}
+
+unsigned long micros() {
+    return static_cast<unsigned long>(g_nowUs);
+}
+
+void delay(unsigned long ms) {
+    advanceTo(g_nowUs + static_cast<uint64_t>(ms) * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    advanceTo(g_nowUs + us);
+}
+
+/**
+ * Espera el pulso programado por el disparo del HC-SR04 y consume en el reloj
+ * simulado el mismo tiempo que bloquearía el pulseIn real, timeout incluido.
+ */
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+    uint64_t start = g_nowUs;
+    uint64_t deadline = start + timeout;
+    if (!validPin(pin)) {
+        advanceTo(deadline);
+        return 0;
+    }
+
+    const Edge* begin = findEdge(pin, state);
+    const Edge* end = findEdge(pin, state == HIGH ? LOW : HIGH);
+    if (begin == nullptr || end == nullptr || end->us < begin->us || end->us > deadline) {
+        advanceTo(deadline);
+        return 0;
+    }
+
+    uint64_t width = end->us - begin->us;
+    advanceTo(end->us);
+    return static_cast<unsigned long>(width);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (validPin(pin)) g_interrupts[pin] = {handler, nullptr, nullptr, mode};
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (validPin(pin)) g_interrupts[pin] = {nullptr, handler, arg, mode};
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (validPin(pin)) g_interrupts[pin] = {nullptr, nullptr, nullptr, 0};
+}
+
+void noInterrupts() {
+    g_interruptsEnabled = false;
+}
+
+void interrupts() {
+    g_interruptsEnabled = true;
+}
+
+// -----------------------------------------------------------------------------
+// Puerto serie
+// -----------------------------------------------------------------------------
+void HardwareSerial::begin(unsigned long) {}
+
+// La transmisión es instantánea en la simulación: el búfer siempre está libre.
+size_t HardwareSerial::setTxBufferSize(size_t size) {
+    g_txBufferSize = size;
+    return size;
+}
+
+int HardwareSerial::availableForWrite() {
+    return static_cast<int>(g_txBufferSize);
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+    g_serialHash = (g_serialHash ^ byte) * FNV_PRIME;
+    g_serialBytes++;
+    if (g_serialCapture != nullptr) fputc(byte, g_serialCapture);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    for (size_t i = 0; i < size; ++i) write(buffer[i]);
+    return size;
+}
+
+size_t HardwareSerial::print(const char* text) {
+    return write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+size_t HardwareSerial::print(char value) {
+    return write(static_cast<uint8_t>(value));
+}
+
+size_t HardwareSerial::print(int value) {
+    return print(static_cast<long>(value));
+}
+
+size_t HardwareSerial::print(unsigned int value) {
+    return print(static_cast<unsigned long>(value));
+}
+
+size_t HardwareSerial::print(long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", value);
+    return print(text);
+}
+
+size_t HardwareSerial::print(unsigned long value) {
+    char text[24];
+    snprintf(text, sizeof(text), "%lu", value);
+    return print(text);
+}
+
+size_t HardwareSerial::print(double value, int digits) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+}
+
+size_t HardwareSerial::println() {
+    return print("\r\n");
+}
+
+size_t HardwareSerial::println(const char* text) {
+    size_t n = print(text);
+    return n + println();
+}
+
+size_t HardwareSerial::println(char value) {
+    size_t n = print(value);
+    return n + println();
+}
+
+size_t HardwareSerial::println(int value) {
+    size_t n = print(value);
+    return n + println();
+}
+
+size_t HardwareSerial::println(unsigned int value) {
+    size_t n = print(value);
+    return n + println();
+}
+
+size_t HardwareSerial::println(long value) {
+    size_t n = print(value);
+    return n + println();
+}
+
+size_t HardwareSerial::println(unsigned long value) {
+    size_t n = print(value);
+    return n + println();
+}
+
+size_t HardwareSerial::println(double value, int digits) {
+    size_t n = print(value, digits);
+    return n + println();
+}
@@ -0,0 +1,60 @@
+#ifndef ARDUINO_SIM_CONTROL_H
+#define ARDUINO_SIM_CONTROL_H
+
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Control del HAL simulado: reloj, sensores y contadores. Solo lo usa el
+// programa de repetición (SimMain.cpp); el código del vehículo sigue viendo
+// únicamente la API de Arduino.h.
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Devuelve la distancia (cm) que ve el sensor `sensor` en el instante `us`
+ *        del reloj simulado. Un valor negativo simula que no llega eco.
+ */
+typedef float (*SimDistanceSource)(int sensor, uint64_t us, void* context);
+
+const int SIM_MAX_PINS = 64;
+
+uint64_t simNowMicros();
+void simAdvanceMicros(uint64_t us);
+
+/**
+ * @brief Conecta un HC-SR04 simulado: cada flanco de bajada en `trigPin` programa
+ *        los flancos de ECHO en `echoPin` según la distancia que da la fuente para
+ *        `sensor`. Los leen tanto `pulseIn` como las interrupciones.
+ */
+void simBindUltrasonic(uint8_t trigPin, uint8_t echoPin, int sensor);
+void simSetDistanceSource(SimDistanceSource source, void* context);
+
+int simPinLevel(uint8_t pin);
+uint32_t simPinWrites(uint8_t pin);
+uint32_t simTotalPinWrites();
+
+/**
+ * @brief Operaciones de salida hechas por el vehículo: cada `digitalWrite`,
+ *        `REG_WRITE` a un registro de GPIO o `ledcWrite` cuenta una vez, aunque
+ *        cambie varios pines.
+ */
+uint32_t simGpioOperations();
+
+/** @brief Ciclo de trabajo PWM del pin (0 si no está conectado a un canal LEDC). */
+uint32_t simPinDuty(uint8_t pin);
+
+/**
+ * @brief Llama a `observer` tras cada operación de salida, con los pines ya en su
+ *        nuevo nivel; sirve para ver los estados intermedios entre dos órdenes.
+ */
+typedef void (*SimGpioObserver)(void* context);
+void simSetGpioObserver(SimGpioObserver observer, void* context);
+
+/**
+ * @brief Guarda todo lo que el vehículo envía por Serial en `path` (binario).
+ * @return false si no se pudo crear el archivo.
+ */
+bool simSetSerialCapture(const char* path);
+uint32_t simSerialFingerprint();
+uint64_t simSerialBytes();
+
+#endif // ARDUINO_SIM_CONTROL_H
@@ -0,0 +1,231 @@
+// -----------------------------------------------------------------------------
+// Repetición determinista del bucle de control en el PC (entorno `native`).
+//
+//   pio run -e native && .pio/build/native/program [opciones]
+//
+//   --escenario pasillo|obstaculos  escenario sintético (por defecto: obstaculos)
+//   --csv archivo                   repite un registro serie del vehículo; usa las
+//                                   dos primeras columnas (dist. izq., dist. der.),
+//                                   una fila por ciclo de 100 ms
+//   --ticks N                       ciclos de control a ejecutar (por defecto 1000)
+//   --semilla S                     semilla del ruido de los escenarios sintéticos
+//   --serie archivo                 guarda la salida serial del vehículo (telemetría
+//                                   binaria; se decodifica con tools/telemetry_decoder)
+//
+// El reloj, los sensores y el ruido son simulados y dependen solo de los argumentos,
+// así que dos ejecuciones producen la misma salida serial (se imprime su huella).
+// Lo único que varía es la latencia medida en el host para cada etapa del ciclo
+// (estadísticas de Perf.h; el entorno native compila con -DPERF_STATS).
+// -----------------------------------------------------------------------------
+#include "Arduino.h"
+#include "ArduinoSim.h"
+#include "Perf.h"
+#include "Scheduler.h"
+
+#ifndef PERF_STATS
+#error "La repetición necesita -DPERF_STATS (ver [env:native] en platformio.ini)"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+void setup();
+void loop();
+
+extern Scheduler planificador;  // main.cpp
+
+namespace {
+
+// Pines de main.cpp: sensorIzquierdo(19, 21) y sensorDerecho(5, 18).
+const uint8_t TRIG_IZQUIERDO = 19;
+const uint8_t ECHO_IZQUIERDO = 21;
+const uint8_t TRIG_DERECHO = 5;
+const uint8_t ECHO_DERECHO = 18;
+const int SENSOR_IZQUIERDO = 0;
+const int SENSOR_DERECHO = 1;
+
+const uint64_t TICK_US = 100000;     // Paso del escenario y de cada fila del CSV
+const uint64_t IDLE_STEP_US = 1000;  // avance del reloj entre llamadas a loop()
+
+typedef std::chrono::steady_clock Clock;
+
+// -----------------------------------------------------------------------------
+// Escenarios
+// -----------------------------------------------------------------------------
+struct Scenario {
+    std::string name;
+    uint32_t seed = 1;
+    std::vector<float> left;   // Solo para --csv
+    std::vector<float> right;
+};
+
+// Ruido determinista: depende del instante (en ciclos), del sensor y de la semilla,
+// no del orden de las llamadas.
+uint32_t hashNoise(uint32_t seed, int sensor, uint64_t tick) {
+    uint64_t x = (static_cast<uint64_t>(seed) << 32) ^ (tick * 2 + sensor);
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>(x ^ (x >> 31));
+}
+
+float unitNoise(uint32_t h) {
+    return (h >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+}
+
+// Pasillo: dos paredes que se acercan y se alejan en oposición de fase.
+float corridorDistance(const Scenario& s, int sensor, uint64_t us) {
+    uint64_t tick = us / TICK_US;
+    float phase = static_cast<float>(us % 8000000) / 8000000.0f * 6.2831853f;
+    float wall = 45.0f + 25.0f * sinf(sensor == SENSOR_IZQUIERDO ? phase : phase + 3.1415927f);
+    return wall + unitNoise(hashNoise(s.seed, sensor, tick));
+}
+
+// Obstáculos: cada 6 s aparece un obstáculo que se acerca de 250 a 8 cm, alternando
+// el lado; el otro lado queda libre (sin eco). Un 3 % de lecturas se pierden.
+float obstacleDistance(const Scenario& s, int sensor, uint64_t us) {
+    const uint64_t period = 6000000;
+    uint64_t tick = us / TICK_US;
+    uint32_t h = hashNoise(s.seed, sensor, tick);
+    if (h % 100 < 3) return -1.0f;
+
+    int side = static_cast<int>((us / period) % 2);
+    if (side != sensor) return -1.0f;
+
+    float progress = static_cast<float>(us % period) / period;
+    return 250.0f - 242.0f * progress + 2.0f * unitNoise(h);
+}
+
+float recordedDistance(const Scenario& s, int sensor, uint64_t us) {
+    const std::vector<float>& column = (sensor == SENSOR_IZQUIERDO) ? s.left : s.right;
+    if (column.empty()) return -1.0f;
+    uint64_t row = us / TICK_US;
+    row = (row == 0) ? 0 : row - 1;  // la primera fila se registró a los 100 ms
+    if (row >= column.size()) row = column.size() - 1;
+    return column[row];
+}
+
+float scenarioDistance(int sensor, uint64_t us, void* context) {
+    const Scenario& s = *static_cast<const Scenario*>(context);
+    if (!s.left.empty()) return recordedDistance(s, sensor, us);
+    if (s.name == "pasillo") return corridorDistance(s, sensor, us);
+    return obstacleDistance(s, sensor, us);
+}
+
+bool loadCsv(const char* path, Scenario& s) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string a, b;
+        if (!std::getline(fields, a, ',') || !std::getline(fields, b, ',')) continue;
+        char* endA = nullptr;
+        char* endB = nullptr;
+        float left = strtof(a.c_str(), &endA);
+        float right = strtof(b.c_str(), &endB);
+        if (endA == a.c_str() || endB == b.c_str()) continue;  // Encabezados u otras líneas
+        s.left.push_back(left);
+        s.right.push_back(right);
+    }
+    return !s.left.empty();
+}
+
+void printLine(const char* text, void*) {
+    fputs(text, stdout);
+}
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "uso: %s [--escenario pasillo|obstaculos] [--csv archivo] [--ticks N]"
+            " [--semilla S] [--serie archivo]\n",
+            program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Scenario scenario;
+    scenario.name = "obstaculos";
+    uint64_t ticks = 1000;
+    bool ticksGiven = false;
+    const char* csvPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--escenario") && hasValue) {
+            scenario.name = argv[++i];
+        } else if (!strcmp(argv[i], "--csv") && hasValue) {
+            csvPath = argv[++i];
+        } else if (!strcmp(argv[i], "--ticks") && hasValue) {
+            ticks = strtoull(argv[++i], nullptr, 10);
+            ticksGiven = true;
+        } else if (!strcmp(argv[i], "--semilla") && hasValue) {
+            scenario.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(argv[i], "--serie") && hasValue) {
+            if (!simSetSerialCapture(argv[++i])) {
+                fprintf(stderr, "Error: no se pudo crear %s\n", argv[i]);
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (csvPath != nullptr) {
+        if (!loadCsv(csvPath, scenario)) {
+            fprintf(stderr, "Error: no se pudieron leer distancias de %s\n", csvPath);
+            return 1;
+        }
+        scenario.name = csvPath;
+        if (!ticksGiven) ticks = scenario.left.size();
+    } else if (scenario.name != "pasillo" && scenario.name != "obstaculos") {
+        fprintf(stderr, "Error: escenario desconocido '%s'\n", scenario.name.c_str());
+        return 2;
+    }
+
+    // Los constructores globales ya configuraron los pines; solo se conectan los sensores.
+    simBindUltrasonic(TRIG_IZQUIERDO, ECHO_IZQUIERDO, SENSOR_IZQUIERDO);
+    simBindUltrasonic(TRIG_DERECHO, ECHO_DERECHO, SENSOR_DERECHO);
+    simSetDistanceSource(scenarioDistance, &scenario);
+
+    setup();
+    Clock::time_point start = Clock::now();
+    // Tiempo simulado que pasa dentro de loop(): lo que el bucle bloquea al núcleo.
+    uint64_t blockedUs = 0;
+    uint64_t maxBlockedUs = 0;
+    while (perf::count(Stage::CYCLE) < ticks) {
+        uint64_t before = simNowMicros();
+        loop();
+        uint64_t blocked = simNowMicros() - before;
+        blockedUs += blocked;
+        maxBlockedUs = std::max(maxBlockedUs, blocked);
+        simAdvanceMicros(IDLE_STEP_US);
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const uint64_t cycles = perf::count(Stage::CYCLE);
+    printf("escenario: %s  semilla: %u  ciclos: %llu  tiempo simulado: %.1f s\n",
+           scenario.name.c_str(), scenario.seed, static_cast<unsigned long long>(cycles),
+           simNowMicros() / 1e6);
+    perf::dump(printLine, nullptr);
+    planificador.dump(printLine, nullptr);
+
+    printf("bloqueo de loop() (simulado): %.1f us por ciclo, max %llu us por llamada\n",
+           cycles ? static_cast<double>(blockedUs) / cycles : 0.0,
+           static_cast<unsigned long long>(maxBlockedUs));
+    printf("rendimiento (host): %.0f ciclos/s\n", elapsed > 0.0 ? cycles / elapsed : 0.0);
+    printf("huella serie: 0x%08x (%llu bytes)  escrituras GPIO: %u (%u operaciones)\n",
+           simSerialFingerprint(), static_cast<unsigned long long>(simSerialBytes()),
+           simTotalPinWrites(), simGpioOperations());
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "Actions.h"
+#include <stddef.h>
+
+const std::vector<std::vector<float>> targetOptions = {
+    {1,0,1,0},  // Adelante
+    {0,1,0,1},  // Atrás
+    {1,0,0,1},  // Izquierda
+    {0,1,1,0}   // Derecha
+};
+
+int findClosestMatch(const std::vector<float>& input, const std::vector<std::vector<float>>& targetOptions) {
+    if (targetOptions.empty() || input.size() != 4) {
+        return -1; // Error
+    }
+
+    return findClosestMatch(input.data(), targetOptions);
+}
+
+int findClosestMatch(const float* input, const std::vector<std::vector<float>>& targetOptions) {
+    int closestIndex = -1;
+    float minDistance = 99999.0f; // En Arduino, evitar std::numeric_limits<float>::max()
+
+    for (size_t i = 0; i < targetOptions.size(); i++) {
+        float distance = 0.0f;
+        for (size_t j = 0; j < 4; j++) {
+            float diff = input[j] - targetOptions[i][j];
+            distance += diff * diff; // Distancia euclidiana
+        }
+
+        if (distance < minDistance) {
+            minDistance = distance;
+            closestIndex = i;
+        }
+    }
+
+    return closestIndex;
+}
@@ -0,0 +1,49 @@
+#include "Activations.h"
+
+// sigmoid(i * SIGMOID_LUT_RANGE / SIGMOID_LUT_SIZE) para i = 0..SIGMOID_LUT_SIZE.
+// Tabla constante: en el ESP32 queda en flash y no ocupa RAM.
+const float SIGMOID_LUT[SIGMOID_LUT_SIZE + 1] = {
+    0.5f, 0.509764373f, 0.519521296f, 0.529263377f, 0.538983226f, 0.548673511f,
+    0.558327019f, 0.567936599f, 0.577495337f, 0.586996436f, 0.596433163f, 0.605799019f,
+    0.615087867f, 0.624293506f, 0.633410275f, 0.642432451f, 0.651354849f, 0.660172403f,
+    0.668880284f, 0.677474022f, 0.685949445f, 0.694302678f, 0.702530086f, 0.710628331f,
+    0.718594372f, 0.726425588f, 0.734119534f, 0.741674006f, 0.749087214f, 0.756357551f,
+    0.763483763f, 0.770464778f, 0.777299881f, 0.783988476f, 0.790530324f, 0.796925366f,
+    0.80317378f, 0.809275985f, 0.815232515f, 0.821044087f, 0.826711774f, 0.832236648f,
+    0.83761996f, 0.842863142f, 0.847967744f, 0.852935493f, 0.857768118f, 0.862467527f,
+    0.867035747f, 0.871474862f, 0.87578702f, 0.879974365f, 0.884039283f, 0.887984037f,
+    0.891811073f, 0.895522654f, 0.899121404f, 0.902609587f, 0.905989826f, 0.909264505f,
+    0.912436187f, 0.915507257f, 0.918480217f, 0.921357632f, 0.924141824f, 0.926835299f,
+    0.929440379f, 0.931959569f, 0.934395134f, 0.936749458f, 0.939024806f, 0.941223443f,
+    0.943347573f, 0.945399404f, 0.94738102f, 0.949294627f, 0.951142192f, 0.952925801f,
+    0.954647422f, 0.956308961f, 0.957912266f, 0.959459245f, 0.960951686f, 0.962391376f,
+    0.963779926f, 0.965119123f, 0.966410518f, 0.967655659f, 0.968856156f, 0.970013499f,
+    0.971129119f, 0.972204387f, 0.973240733f, 0.974239469f, 0.975201845f, 0.976129174f,
+    0.977022648f, 0.977883399f, 0.978712678f, 0.97951144f, 0.980280876f, 0.981021941f,
+    0.981735706f, 0.982423127f, 0.983085096f, 0.983722568f, 0.984336376f, 0.984927356f,
+    0.985496402f, 0.986044288f, 0.986571729f, 0.987079501f, 0.987568378f, 0.988038898f,
+    0.988491833f, 0.988927841f, 0.989347517f, 0.989751399f, 0.99014014f, 0.990514278f,
+    0.99087435f, 0.991220891f, 0.991554379f, 0.991875291f, 0.992184103f, 0.992481291f,
+    0.992767215f, 0.993042409f, 0.993307173f, 0.993561924f, 0.993807018f, 0.994042873f,
+    0.994269729f, 0.99448806f, 0.994698107f, 0.994900167f, 0.995094597f, 0.995281637f,
+    0.995461583f, 0.995634675f, 0.99580121f, 0.995961428f, 0.996115506f, 0.996263802f,
+    0.996406376f, 0.996543586f, 0.996675551f, 0.996802509f, 0.996924639f, 0.99704212f,
+    0.99715507f, 0.997263789f, 0.997368336f, 0.997468889f, 0.997565627f, 0.99765867f,
+    0.997748137f, 0.997834206f, 0.997917056f, 0.997996688f, 0.99807328f, 0.998146951f,
+    0.998217821f, 0.998285949f, 0.998351514f, 0.998414576f, 0.998475194f, 0.998533547f,
+    0.998589635f, 0.998643577f, 0.998695493f, 0.998745382f, 0.998793423f, 0.998839557f,
+    0.998883963f, 0.998926699f, 0.998967767f, 0.999007285f, 0.999045253f, 0.99908179f,
+    0.999116957f, 0.999150753f, 0.999183238f, 0.99921453f, 0.999244571f, 0.999273539f,
+    0.999301314f, 0.999328077f, 0.999353826f, 0.999378562f, 0.999402344f, 0.999425232f,
+    0.999447227f, 0.999468386f, 0.999488771f, 0.999508321f, 0.999527156f, 0.999545276f,
+    0.999562681f, 0.99957943f, 0.999595523f, 0.99961102f, 0.999625921f, 0.999640226f,
+    0.999653995f, 0.999667287f, 0.999679983f, 0.999692261f, 0.999704063f, 0.999715388f,
+    0.999726295f, 0.999736786f, 0.999746859f, 0.999756515f, 0.999765873f, 0.999774814f,
+    0.999783456f, 0.999791741f, 0.999799728f, 0.999807417f, 0.999814749f, 0.999821842f,
+    0.999828696f, 0.999835253f, 0.999841571f, 0.999847651f, 0.999853492f, 0.999859095f,
+    0.999864459f, 0.999869645f, 0.999874651f, 0.999879479f, 0.999884069f, 0.999888539f,
+    0.999892771f, 0.999896884f, 0.999900818f, 0.999904633f, 0.999908268f, 0.999911785f,
+    0.999915183f, 0.999918461f, 0.99992156f, 0.999924541f, 0.999927461f, 0.999930263f,
+    0.999932885f, 0.999935448f, 0.999937952f, 0.999940336f, 0.999942601f, 0.999944806f,
+    0.999946952f, 0.999948978f, 0.999950886f, 0.999952793f, 0.999954581f
+};
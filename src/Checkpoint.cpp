@@ -0,0 +1,616 @@
+#include "Checkpoint.h"
+#include "Crc32.h"
+#include "NeuralNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef ESP_PLATFORM
+#include <esp_partition.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Codificación de enteros
+// -----------------------------------------------------------------------------
+
+static inline uint8_t* putVarint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+static inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && in < end; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static inline uint32_t floatBits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+static inline float bitsFloat(uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+static inline void putU32(uint8_t* out, uint32_t value) {
+    std::memcpy(out, &value, sizeof(value));
+}
+
+static inline uint32_t getU32(const uint8_t* in) {
+    uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+// Medios de almacenamiento
+// -----------------------------------------------------------------------------
+
+// Página de programación de la flash SPI: cada una que toca una escritura cuesta
+// `FlashTiming::pageProgramUs`
+static const size_t FLASH_PAGE_SIZE = 256;
+
+MemoryCheckpointStorage::MemoryCheckpointStorage(size_t regionSize, size_t sectorSize,
+                                                 const FlashTiming& timing)
+    : m_regionSize(regionSize),
+      m_sectorSize(sectorSize),
+      m_timing(timing)
+{
+    if (sectorSize == 0 || regionSize % sectorSize != 0) {
+        throw std::runtime_error("La región debe ser múltiplo del sector.");
+    }
+    m_regions[0].assign(regionSize, 0xFF);
+    m_regions[1].assign(regionSize, 0xFF);
+}
+
+bool MemoryCheckpointStorage::read(int region, size_t offset, void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    std::memcpy(data, m_regions[region].data() + offset, size);
+    return true;
+}
+
+bool MemoryCheckpointStorage::write(int region, size_t offset, const void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    // Como en la flash, escribir solo puede pasar bits de 1 a 0
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        m_regions[region][offset + i] &= bytes[i];
+    }
+    if (m_timing.wait && size > 0) {
+        const size_t pages = (offset + size - 1) / FLASH_PAGE_SIZE - offset / FLASH_PAGE_SIZE + 1;
+        m_timing.wait(static_cast<unsigned long>(pages * m_timing.pageProgramUs));
+    }
+    return true;
+}
+
+bool MemoryCheckpointStorage::eraseSector(int region, size_t sector) {
+    if ((sector + 1) * m_sectorSize > m_regionSize) {
+        return false;
+    }
+    std::fill(m_regions[region].begin() + sector * m_sectorSize,
+              m_regions[region].begin() + (sector + 1) * m_sectorSize, 0xFF);
+    if (m_timing.wait) {
+        m_timing.wait(m_timing.eraseSectorUs);
+    }
+    return true;
+}
+
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+FileCheckpointStorage::FileCheckpointStorage(const char* pathA, const char* pathB,
+                                             size_t regionSize, size_t sectorSize)
+    : m_regionSize(regionSize),
+      m_sectorSize(sectorSize)
+{
+    if (sectorSize == 0 || regionSize % sectorSize != 0) {
+        throw std::runtime_error("La región debe ser múltiplo del sector.");
+    }
+
+    const char* paths[2] = {pathA, pathB};
+    std::vector<uint8_t> erased(regionSize, 0xFF);
+    for (int r = 0; r < 2; r++) {
+        FILE* file = std::fopen(paths[r], "r+b");
+        if (file == nullptr) {
+            file = std::fopen(paths[r], "w+b");
+        }
+        if (file == nullptr) {
+            throw std::runtime_error("No se pudo abrir el archivo de puntos de control.");
+        }
+        m_files[r] = file;
+
+        // Un archivo nuevo (o más corto) se completa con bytes borrados
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        if (size < 0 || static_cast<size_t>(size) < regionSize) {
+            size_t existing = size < 0 ? 0 : static_cast<size_t>(size);
+            std::fseek(file, static_cast<long>(existing), SEEK_SET);
+            std::fwrite(erased.data(), 1, regionSize - existing, file);
+            std::fflush(file);
+        }
+    }
+}
+
+FileCheckpointStorage::~FileCheckpointStorage() {
+    for (FILE* file : m_files) {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+}
+
+bool FileCheckpointStorage::read(int region, size_t offset, void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    FILE* file = m_files[region];
+    return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+           std::fread(data, 1, size, file) == size;
+}
+
+bool FileCheckpointStorage::write(int region, size_t offset, const void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    // Semántica de flash: el resultado es el AND con lo que ya había
+    uint8_t buffer[256];
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    FILE* file = m_files[region];
+    for (size_t done = 0; done < size; ) {
+        size_t n = std::min(sizeof(buffer), size - done);
+        if (!read(region, offset + done, buffer, n)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            buffer[i] &= bytes[done + i];
+        }
+        if (std::fseek(file, static_cast<long>(offset + done), SEEK_SET) != 0 ||
+            std::fwrite(buffer, 1, n, file) != n) {
+            return false;
+        }
+        done += n;
+    }
+    return std::fflush(file) == 0;
+}
+
+bool FileCheckpointStorage::eraseSector(int region, size_t sector) {
+    if ((sector + 1) * m_sectorSize > m_regionSize) {
+        return false;
+    }
+    std::vector<uint8_t> erased(m_sectorSize, 0xFF);
+    FILE* file = m_files[region];
+    return std::fseek(file, static_cast<long>(sector * m_sectorSize), SEEK_SET) == 0 &&
+           std::fwrite(erased.data(), 1, m_sectorSize, file) == m_sectorSize &&
+           std::fflush(file) == 0;
+}
+#endif
+
+#ifdef ESP_PLATFORM
+// Sector de borrado de la flash SPI del ESP32
+static const size_t FLASH_SECTOR_SIZE = 4096;
+
+PartitionCheckpointStorage::PartitionCheckpointStorage(const char* labelA, const char* labelB) {
+    const char* labels[2] = {labelA, labelB};
+    size_t size = SIZE_MAX;
+    for (int r = 0; r < 2; r++) {
+        const esp_partition_t* partition = esp_partition_find_first(
+            ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, labels[r]);
+        if (partition == nullptr) {
+            return; // Sin particiones: regionSize() == 0
+        }
+        m_partitions[r] = partition;
+        size = std::min<size_t>(size, partition->size);
+    }
+    m_regionSize = size - size % FLASH_SECTOR_SIZE;
+}
+
+size_t PartitionCheckpointStorage::sectorSize() const {
+    return FLASH_SECTOR_SIZE;
+}
+
+bool PartitionCheckpointStorage::read(int region, size_t offset, void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    const esp_partition_t* partition = static_cast<const esp_partition_t*>(m_partitions[region]);
+    return esp_partition_read(partition, offset, data, size) == ESP_OK;
+}
+
+bool PartitionCheckpointStorage::write(int region, size_t offset, const void* data, size_t size) {
+    if (offset + size > m_regionSize) {
+        return false;
+    }
+    const esp_partition_t* partition = static_cast<const esp_partition_t*>(m_partitions[region]);
+    return esp_partition_write(partition, offset, data, size) == ESP_OK;
+}
+
+bool PartitionCheckpointStorage::eraseSector(int region, size_t sector) {
+    if ((sector + 1) * FLASH_SECTOR_SIZE > m_regionSize) {
+        return false;
+    }
+    const esp_partition_t* partition = static_cast<const esp_partition_t*>(m_partitions[region]);
+    return esp_partition_erase_range(partition, sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE) == ESP_OK;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Registro de puntos de control
+// -----------------------------------------------------------------------------
+
+CheckpointLog::CheckpointLog(CheckpointStorage& storage, size_t parameterCount,
+                             const CheckpointConfig& config)
+    : m_storage(storage),
+      m_parameterCount(parameterCount),
+      m_config(config),
+      m_persisted(parameterCount, 0.0f),
+      m_current(parameterCount, 0.0f)
+{
+    if (m_config.encoding == DeltaEncoding::QUANTIZED && !(m_config.quantStep > 0.0f)) {
+        throw std::runtime_error("El paso de cuantización debe ser positivo.");
+    }
+    if (m_config.chunkBytes == 0) {
+        throw std::runtime_error("El tamaño de los trozos de compactación debe ser mayor que cero.");
+    }
+    // Peor caso: la base, o un delta con todos los parámetros (5 + 5 bytes cada uno)
+    const size_t basePayload = parameterCount * sizeof(float);
+    const size_t deltaPayload = sizeof(float) + 5 + parameterCount * 10;
+    m_record.assign(RECORD_HEADER_SIZE + std::max(basePayload, deltaPayload), 0);
+}
+
+bool CheckpointLog::readHeader(int region, uint32_t& generation) {
+    uint8_t header[HEADER_SIZE];
+    if (!m_storage.read(region, 0, header, sizeof(header))) {
+        return false;
+    }
+    uint16_t version;
+    std::memcpy(&version, header + 4, sizeof(version));
+    if (std::memcmp(header, CHECKPOINT_MAGIC, 4) != 0 || version != CHECKPOINT_VERSION ||
+        getU32(header + 12) != m_parameterCount || getU32(header + 16) != crc32(header, 16)) {
+        return false;
+    }
+    generation = getU32(header + 8);
+    return true;
+}
+
+bool CheckpointLog::readRecord(int region, size_t offset, uint8_t& type, size_t& payloadSize) {
+    uint8_t* record = m_record.data();
+    if (!m_storage.read(region, offset, record, RECORD_HEADER_SIZE)) {
+        return false;
+    }
+    type = record[0];
+    payloadSize = getU32(record + 4);
+    if (type < RECORD_BASE || type > RECORD_QUANTIZED ||
+        payloadSize > m_record.size() - RECORD_HEADER_SIZE ||
+        !m_storage.read(region, offset + RECORD_HEADER_SIZE, record + RECORD_HEADER_SIZE, payloadSize)) {
+        return false;
+    }
+    const uint32_t stored = getU32(record + 8);
+    putU32(record + 8, 0);
+    return crc32(record, RECORD_HEADER_SIZE + payloadSize) == stored;
+}
+
+bool CheckpointLog::applyDelta(uint8_t type, const uint8_t* payload, size_t size) {
+    if (type == RECORD_BASE) {
+        if (size != m_parameterCount * sizeof(float)) {
+            return false;
+        }
+        std::memcpy(m_persisted.data(), payload, size);
+        return true;
+    }
+
+    // Se decodifica sobre una copia: un delta mal formado no deja cambios a medias
+    const uint8_t* in = payload;
+    const uint8_t* end = payload + size;
+    float step = 0.0f;
+    if (type == RECORD_QUANTIZED) {
+        if (size < sizeof(float)) {
+            return false;
+        }
+        step = bitsFloat(getU32(in));
+        in += sizeof(float);
+    } else if (type != RECORD_XOR) {
+        return false;
+    }
+
+    uint32_t count;
+    if (!getVarint(in, end, count)) {
+        return false;
+    }
+    std::copy(m_persisted.begin(), m_persisted.end(), m_current.begin());
+    size_t index = 0;
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t gap;
+        uint32_t value;
+        if (!getVarint(in, end, gap) || !getVarint(in, end, value)) {
+            return false;
+        }
+        index += gap;
+        if (index >= m_parameterCount) {
+            return false;
+        }
+        if (type == RECORD_XOR) {
+            m_current[index] = bitsFloat(floatBits(m_current[index]) ^ value);
+        } else {
+            m_current[index] += static_cast<float>(unzigzag(value)) * step;
+        }
+        index++;
+    }
+    if (in != end) {
+        return false;
+    }
+    m_persisted.swap(m_current);
+    return true;
+}
+
+bool CheckpointLog::restore(NeuralNetwork& network) {
+    if (network.parameterCount() != m_parameterCount || m_storage.regionSize() == 0) {
+        return false;
+    }
+
+    // 1️ Región válida (cabecera y base correctas) con la mayor generación
+    int best = -1;
+    uint32_t bestGeneration = 0;
+    for (int region = 0; region < 2; region++) {
+        uint32_t generation;
+        uint8_t type;
+        size_t payloadSize;
+        if (readHeader(region, generation) &&
+            readRecord(region, HEADER_SIZE, type, payloadSize) &&
+            type == RECORD_BASE && payloadSize == m_parameterCount * sizeof(float) &&
+            (best < 0 || static_cast<int32_t>(generation - bestGeneration) > 0)) {
+            best = region;
+            bestGeneration = generation;
+        }
+    }
+    if (best < 0) {
+        return false;
+    }
+
+    // 2️ Base y deltas hasta el primer registro incompleto
+    uint8_t type;
+    size_t payloadSize;
+    readRecord(best, HEADER_SIZE, type, payloadSize);
+    std::memcpy(m_persisted.data(), m_record.data() + RECORD_HEADER_SIZE, payloadSize);
+    size_t offset = HEADER_SIZE + RECORD_HEADER_SIZE + payloadSize;
+    while (readRecord(best, offset, type, payloadSize) &&
+           applyDelta(type, m_record.data() + RECORD_HEADER_SIZE, payloadSize)) {
+        offset += RECORD_HEADER_SIZE + payloadSize;
+    }
+
+    m_active = best;
+    m_generation = bestGeneration;
+    m_offset = offset;
+    m_compacting = false;
+    network.setParameters(m_persisted.data());
+
+    // Si tras el último registro válido hay bytes escritos (una escritura
+    // interrumpida), no se puede añadir encima: se compacta a la otra región
+    uint8_t tail[RECORD_HEADER_SIZE];
+    size_t tailSize = std::min(sizeof(tail), m_storage.regionSize() - m_offset);
+    bool dirty = !m_storage.read(m_active, m_offset, tail, tailSize);
+    for (size_t i = 0; i < tailSize && !dirty; i++) {
+        dirty = (tail[i] != 0xFF);
+    }
+    if (dirty || m_offset > m_config.compactThreshold * m_storage.regionSize()) {
+        startCompaction();
+    }
+    return true;
+}
+
+void CheckpointLog::reset(const NeuralNetwork& network) {
+    if (network.parameterCount() != m_parameterCount) {
+        throw std::runtime_error("La red no coincide con el registro de puntos de control.");
+    }
+    network.copyParameters(m_persisted.data());
+    startCompaction();
+}
+
+size_t CheckpointLog::encodeDelta(const NeuralNetwork& network) {
+    network.copyParameters(m_current.data());
+
+    uint8_t* payload = m_record.data() + RECORD_HEADER_SIZE;
+    uint8_t* out = payload;
+    const bool quantized = (m_config.encoding == DeltaEncoding::QUANTIZED);
+    const float step = m_config.quantStep;
+    if (quantized) {
+        putU32(out, floatBits(step));
+        out += sizeof(float);
+    }
+
+    // El número de cambios va delante: se escribe al final en un hueco de 5 bytes
+    uint8_t* countSlot = out;
+    out += 5;
+    uint32_t count = 0;
+    size_t last = 0;
+    for (size_t i = 0; i < m_parameterCount; i++) {
+        uint32_t value;
+        if (quantized) {
+            float q = std::nearbyint((m_current[i] - m_persisted[i]) / step);
+            if (!(q != 0.0f)) {
+                continue;  // Sin cambio apreciable (o NaN)
+            }
+            q = std::min(1e9f, std::max(-1e9f, q));
+            value = zigzag(static_cast<int32_t>(q));
+        } else {
+            value = floatBits(m_current[i]) ^ floatBits(m_persisted[i]);
+            if (value == 0) {
+                continue;
+            }
+        }
+        out = putVarint(out, static_cast<uint32_t>(i - last));
+        out = putVarint(out, value);
+        last = i + 1;
+        count++;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    // Se compacta el hueco del contador
+    uint8_t countBytes[5];
+    size_t countSize = putVarint(countBytes, count) - countBytes;
+    std::memmove(countSlot + countSize, countSlot + 5, out - (countSlot + 5));
+    std::memcpy(countSlot, countBytes, countSize);
+    return (out - payload) - (5 - countSize);
+}
+
+bool CheckpointLog::appendRecord(uint8_t type, size_t payloadSize) {
+    uint8_t* record = m_record.data();
+    record[0] = type;
+    record[1] = record[2] = record[3] = 0;
+    putU32(record + 4, static_cast<uint32_t>(payloadSize));
+    putU32(record + 8, 0);
+    putU32(record + 8, crc32(record, RECORD_HEADER_SIZE + payloadSize));
+
+    const size_t size = RECORD_HEADER_SIZE + payloadSize;
+    if (!m_storage.write(m_active, m_offset, record, size)) {
+        return false;
+    }
+    m_offset += size;
+    m_stats.bytesWritten += size;
+    m_stats.lastBytes = size;
+    return true;
+}
+
+bool CheckpointLog::checkpoint(const NeuralNetwork& network) {
+    if (m_active < 0 || m_compacting) {
+        m_stats.deferred++;
+        return false;
+    }
+
+    size_t payloadSize = encodeDelta(network);
+    if (payloadSize == 0) {
+        return true;  // Nada cambió
+    }
+    uint8_t type = (m_config.encoding == DeltaEncoding::QUANTIZED) ? RECORD_QUANTIZED : RECORD_XOR;
+    if (payloadSize >= m_parameterCount * sizeof(float)) {
+        // Cambiaron casi todos los parámetros: una base completa ocupa menos
+        type = RECORD_BASE;
+        payloadSize = m_parameterCount * sizeof(float);
+        std::memcpy(m_record.data() + RECORD_HEADER_SIZE, m_current.data(), payloadSize);
+    }
+
+    if (m_offset + RECORD_HEADER_SIZE + payloadSize > m_storage.regionSize() ||
+        !appendRecord(type, payloadSize)) {
+        // No cabe (o falló la escritura): la nueva base será el estado actual
+        std::copy(m_current.begin(), m_current.end(), m_persisted.begin());
+        startCompaction();
+        m_stats.deferred++;
+        return false;
+    }
+
+    // El estado guardado avanza decodificando el propio registro, igual que `restore`
+    applyDelta(type, m_record.data() + RECORD_HEADER_SIZE, payloadSize);
+    m_stats.checkpoints++;
+
+    if (m_offset > m_config.compactThreshold * m_storage.regionSize()) {
+        startCompaction();
+    }
+    return true;
+}
+
+void CheckpointLog::startCompaction() {
+    const size_t total = HEADER_SIZE + RECORD_HEADER_SIZE + m_parameterCount * sizeof(float);
+    if (total > m_storage.regionSize()) {
+        return;  // Medio no disponible o demasiado pequeño: registro desactivado
+    }
+
+    m_compacting = true;
+    m_target = (m_active < 0) ? 0 : 1 - m_active;
+    m_nextSector = 0;
+    m_written = 0;
+
+    // CRC de la base: cabecera de registro y parámetros, que no cambian hasta terminar
+    uint8_t record[RECORD_HEADER_SIZE] = {RECORD_BASE, 0, 0, 0};
+    putU32(record + 4, static_cast<uint32_t>(m_parameterCount * sizeof(float)));
+    putU32(record + 8, 0);
+    m_baseCrc = crc32(record, sizeof(record));
+    m_baseCrc = crc32(m_persisted.data(), m_parameterCount * sizeof(float), m_baseCrc);
+}
+
+bool CheckpointLog::compactStep() {
+    if (!m_compacting) {
+        return true;
+    }
+
+    // 1️ Un sector borrado por paso
+    const size_t numSectors = m_storage.regionSize() / m_storage.sectorSize();
+    if (m_nextSector < numSectors) {
+        if (m_storage.eraseSector(m_target, m_nextSector)) {
+            m_nextSector++;
+        }
+        return false;
+    }
+
+    const uint32_t generation = m_generation + 1;
+    const size_t payloadSize = m_parameterCount * sizeof(float);
+    const size_t total = HEADER_SIZE + RECORD_HEADER_SIZE + payloadSize;
+
+    // 2️ Cabeceras de región y de la base
+    if (m_written == 0) {
+        uint8_t headers[HEADER_SIZE + RECORD_HEADER_SIZE] = {};
+        std::memcpy(headers, CHECKPOINT_MAGIC, 4);
+        std::memcpy(headers + 4, &CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION));
+        putU32(headers + 8, generation);
+        putU32(headers + 12, static_cast<uint32_t>(m_parameterCount));
+        putU32(headers + 16, crc32(headers, 16));
+        headers[HEADER_SIZE] = RECORD_BASE;
+        putU32(headers + HEADER_SIZE + 4, static_cast<uint32_t>(payloadSize));
+        putU32(headers + HEADER_SIZE + 8, m_baseCrc);
+        if (!m_storage.write(m_target, 0, headers, sizeof(headers))) {
+            m_nextSector = 0;  // Se reintenta desde el borrado
+            return false;
+        }
+        m_written = sizeof(headers);
+        m_stats.bytesWritten += sizeof(headers);
+        return false;
+    }
+
+    // 3️ Parámetros, por trozos
+    const size_t done = m_written - (HEADER_SIZE + RECORD_HEADER_SIZE);
+    const size_t n = std::min(m_config.chunkBytes, payloadSize - done);
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(m_persisted.data()) + done;
+    if (!m_storage.write(m_target, m_written, source, n)) {
+        m_nextSector = 0;
+        m_written = 0;
+        return false;
+    }
+    m_written += n;
+    m_stats.bytesWritten += n;
+    if (m_written < total) {
+        return false;
+    }
+
+    // 4️ Base completa: la nueva región pasa a ser la actual
+    m_active = m_target;
+    m_generation = generation;
+    m_offset = total;
+    m_compacting = false;
+    m_stats.compactions++;
+    return true;
+}
@@ -0,0 +1,14 @@
+#include "Crc32.h"
+
+uint32_t crc32(const void* data, size_t size, uint32_t crc) {
+    // Versión bit a bit: sin tabla de 1 KB, suficiente para cargar modelos
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
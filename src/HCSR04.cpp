@@ -1,10 +1,19 @@
 #include "HCSR04.h"
 
-HCSR04::HCSR04(int trigPin, int echoPin) : trigPin(trigPin), echoPin(echoPin) {
+HCSR04::HCSR04(int trigPin, int echoPin)
+    : trigPin(trigPin), echoPin(echoPin), estado(INACTIVO), inicioEco(0), finEco(0),
+      inicioDisparo(0), ultimaDistancia(-1) {
     pinMode(trigPin, OUTPUT);
     pinMode(echoPin, INPUT);
 }
 
+float HCSR04::distanciaDesdeDuracion(unsigned long duracion) {
+    if (duracion == 0) return -1;
+
+    float distancia = duracion * 0.034 / 2;
+    return (distancia >= 2 && distancia <= 400) ? distancia : -1;
+}
+
 float HCSR04::medirDistancia() {
     digitalWrite(trigPin, LOW);
     delayMicroseconds(2);
@@ -12,9 +21,113 @@ float HCSR04::medirDistancia() {
     delayMicroseconds(10);
     digitalWrite(trigPin, LOW);
 
-    long duracion = pulseIn(echoPin, HIGH, 30000);
-    if (duracion == 0) return -1;
+    long duracion = pulseIn(echoPin, HIGH, TIMEOUT_US);
+    return distanciaDesdeDuracion(duracion);
+}
 
-    float distancia = duracion * 0.034 / 2;
-    return (distancia >= 2 && distancia <= 400) ? distancia : -1;
+// -----------------------------------------------------------------------------
+// Medición asíncrona
+// -----------------------------------------------------------------------------
+void IRAM_ATTR HCSR04::isrEco(void* arg) {
+    HCSR04* sensor = static_cast<HCSR04*>(arg);
+    unsigned long ahora = micros();
+
+    // Se ignoran los flancos que no corresponden a una medición en curso
+    // (p. ej. la bajada de un eco que ya se dio por perdido).
+    if (digitalRead(sensor->echoPin) == HIGH) {
+        if (sensor->estado == ESPERANDO_SUBIDA) {
+            sensor->inicioEco = ahora;
+            sensor->estado = ESPERANDO_BAJADA;
+        }
+    } else if (sensor->estado == ESPERANDO_BAJADA) {
+        sensor->finEco = ahora;
+        sensor->estado = LISTO;
+    }
+}
+
+void HCSR04::begin() {
+    attachInterruptArg(digitalPinToInterrupt(echoPin), isrEco, this, CHANGE);
+}
+
+bool HCSR04::iniciarMedicion() {
+    if (ocupado()) return false;
+
+    inicioEco = 0;
+    finEco = 0;
+    estado = ESPERANDO_SUBIDA;
+
+    digitalWrite(trigPin, LOW);
+    delayMicroseconds(2);
+    digitalWrite(trigPin, HIGH);
+    delayMicroseconds(10);
+    inicioDisparo = micros();
+    digitalWrite(trigPin, LOW);
+    return true;
+}
+
+void HCSR04::actualizar() {
+    if (!ocupado()) return;
+
+    // Mismo límite que pulseIn: TIMEOUT_US desde el disparo. Si la interrupción
+    // llega justo después de la comprobación, el eco ya excedía el timeout.
+    if (micros() - inicioDisparo > TIMEOUT_US) {
+        noInterrupts();
+        if (ocupado()) {
+            inicioEco = 0;
+            finEco = 0;
+            estado = LISTO;
+        }
+        interrupts();
+    }
+}
+
+float HCSR04::leerDistancia() {
+    if (estado == LISTO) {
+        ultimaDistancia = distanciaDesdeDuracion(finEco - inicioEco);
+        estado = INACTIVO;
+    }
+    return ultimaDistancia;
+}
+
+// -----------------------------------------------------------------------------
+// RangingScheduler
+// -----------------------------------------------------------------------------
+RangingScheduler::RangingScheduler(HCSR04* const* sensors, int count, unsigned long guardUs)
+    : m_count(count < MAX_SENSORS ? count : MAX_SENSORS), m_current(0), m_guardUs(guardUs),
+      m_lastDone(0), m_cycles(0), m_waitingGuard(false) {
+    for (int i = 0; i < m_count; ++i) {
+        m_sensors[i] = sensors[i];
+        m_distances[i] = -1;
+    }
+}
+
+void RangingScheduler::begin() {
+    for (int i = 0; i < m_count; ++i) m_sensors[i]->begin();
+}
+
+void RangingScheduler::poll() {
+    if (m_count == 0) return;
+
+    HCSR04* sensor = m_sensors[m_current];
+    if (m_waitingGuard) {
+        if (micros() - m_lastDone < m_guardUs) return;
+        m_waitingGuard = false;
+        sensor->iniciarMedicion();
+        return;
+    }
+
+    sensor->actualizar();
+    if (sensor->ocupado()) return;
+
+    if (sensor->medicionLista()) {
+        m_distances[m_current] = sensor->leerDistancia();
+        m_lastDone = micros();
+        if (++m_current == m_count) {
+            m_current = 0;
+            m_cycles++;
+        }
+        m_waitingGuard = true;
+    } else {
+        sensor->iniciarMedicion();  // Primera medición
+    }
 }
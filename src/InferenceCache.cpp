@@ -0,0 +1,145 @@
+#include "InferenceCache.h"
+#include "Actions.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Fuera de este rango (o NaN) todas las entradas caen en la misma celda del borde
+const float kMaxKey = 1.0e9f;
+
+int32_t quantize(float x, float resolution) {
+    float q = std::nearbyint(x / resolution);
+    if (!(q > -kMaxKey)) return static_cast<int32_t>(-kMaxKey);
+    if (q > kMaxKey) return static_cast<int32_t>(kMaxKey);
+    return static_cast<int32_t>(q);
+}
+
+// Mezcla por palabra (multiplicación de Fibonacci y rotación): más barata que
+// recorrer los bytes y reparte bien claves que solo difieren en una unidad
+uint32_t hashKey(const int32_t* key, size_t n) {
+    uint32_t h = 0x9E3779B9u;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= static_cast<uint32_t>(key[i]);
+        h *= 0x85EBCA6Bu;
+        h = (h << 13) | (h >> 19);
+    }
+    return h ^ (h >> 16);
+}
+
+} // namespace
+
+InferenceCache::InferenceCache(NeuralNetwork& network, const std::vector<float>& resolution,
+                               size_t capacity, const std::vector<std::vector<float>>* actions)
+    : m_network(network), m_actions(actions) {
+    const std::vector<int>& layers = network.getLayers();
+    m_inputSize = static_cast<size_t>(layers.front());
+    m_outputSize = static_cast<size_t>(layers.back());
+
+    if (resolution.size() != m_inputSize) {
+        throw std::runtime_error("Se requiere una resolución por entrada de la red.");
+    }
+    for (float r : resolution) {
+        if (!(r > 0.0f)) {
+            throw std::runtime_error("La resolución de cada entrada debe ser mayor que 0.");
+        }
+    }
+    if (actions && m_outputSize != 4) {
+        throw std::runtime_error("Decodificar acciones requiere una red con 4 salidas.");
+    }
+    m_resolution = resolution;
+
+    size_t slots = kProbes;
+    while (slots < capacity) slots <<= 1;
+    m_mask = slots - 1;
+
+    m_keys.assign(slots * m_inputSize, 0);
+    m_outputs.assign(slots * m_outputSize, 0.0f);
+    m_actionIndex.assign(slots, -1);
+    m_versions.assign(slots, 0);
+    m_lastUse.assign(slots, 0);
+    m_used.assign(slots, 0);
+    m_key.assign(m_inputSize, 0);
+    m_snapped.assign(m_inputSize, 0.0f);
+
+    m_lastVersion = network.parameterVersion();
+    m_clock = 0;
+    resetStats();
+}
+
+int InferenceCache::infer(const float* input, float* output) {
+    m_stats.lookups++;
+    uint32_t version = m_network.parameterVersion();
+    if (version != m_lastVersion) {
+        m_stats.invalidations++;
+        m_lastVersion = version;
+    }
+
+    for (size_t i = 0; i < m_inputSize; ++i) m_key[i] = quantize(input[i], m_resolution[i]);
+    uint32_t h = hashKey(m_key.data(), m_inputSize);
+    m_clock++;
+
+    // Sondeo: acierto, o el hueco a reutilizar (uno libre u obsoleto antes que el más antiguo)
+    size_t victim = h & m_mask;
+    bool victimFree = false;
+    for (size_t p = 0; p < kProbes; ++p) {
+        size_t e = (h + p) & m_mask;
+        bool valid = m_used[e] && m_versions[e] == version;
+        if (valid) {
+            const int32_t* key = &m_keys[e * m_inputSize];
+            bool same = true;
+            for (size_t i = 0; i < m_inputSize && same; ++i) same = key[i] == m_key[i];
+            if (same) {
+                m_stats.hits++;
+                m_lastUse[e] = m_clock;
+                const float* stored = &m_outputs[e * m_outputSize];
+                for (size_t j = 0; j < m_outputSize; ++j) output[j] = stored[j];
+                return m_actionIndex[e];
+            }
+        }
+        if (victimFree) continue;
+        if (!valid) {
+            victim = e;
+            victimFree = true;
+        } else if (m_clock - m_lastUse[e] > m_clock - m_lastUse[victim]) {
+            victim = e;
+        }
+    }
+
+    m_stats.misses++;
+    if (!victimFree) m_stats.evictions++;
+
+    for (size_t i = 0; i < m_inputSize; ++i) {
+        m_snapped[i] = static_cast<float>(m_key[i]) * m_resolution[i];
+    }
+    m_network.forward(m_snapped.data(), output);
+    int action = m_actions ? findClosestMatch(output, *m_actions) : -1;
+
+    m_used[victim] = 1;
+    m_versions[victim] = version;
+    m_lastUse[victim] = m_clock;
+    m_actionIndex[victim] = static_cast<int16_t>(action);
+    int32_t* key = &m_keys[victim * m_inputSize];
+    for (size_t i = 0; i < m_inputSize; ++i) key[i] = m_key[i];
+    float* stored = &m_outputs[victim * m_outputSize];
+    for (size_t j = 0; j < m_outputSize; ++j) stored[j] = output[j];
+    return action;
+}
+
+void InferenceCache::clear() {
+    for (size_t e = 0; e < m_used.size(); ++e) m_used[e] = 0;
+}
+
+void InferenceCache::resetStats() {
+    m_stats.lookups = 0;
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.invalidations = 0;
+    m_stats.evictions = 0;
+}
+
+size_t InferenceCache::memoryBytes() const {
+    return m_keys.size() * sizeof(int32_t) + m_outputs.size() * sizeof(float) +
+           m_actionIndex.size() * sizeof(int16_t) + m_versions.size() * sizeof(uint32_t) +
+           m_lastUse.size() * sizeof(uint32_t) + m_used.size();
+}
@@ -0,0 +1,560 @@
+#include "Kernels.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace kernels {
+
+// -----------------------------------------------------------------------------
+// Versión escalar portable (la única que se compila en el ESP32)
+// -----------------------------------------------------------------------------
+static float dotScalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static void axpyScalar(float alpha, const float* x, float* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+static void mulAddScalar(const float* x, const float* w, float* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] += x[i] * w[i];
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Bloques de salida de `matmulRows`. Cada fila del bloque escribe directamente en
+// `y` si el panel está completo; si no (último panel) o si la fila sobra (bloque
+// de menos de `kMaxRows` filas), en un bloque temporal que luego se copia.
+// -----------------------------------------------------------------------------
+struct OutputTile {
+    float scratch[kMaxRows][kPanelWidth];
+    float* rows[kMaxRows];
+    size_t cols;
+};
+
+static inline void beginTile(OutputTile& tile, float* y, size_t rows, size_t n, size_t col) {
+    tile.cols = (n - col < kPanelWidth) ? n - col : kPanelWidth;
+    for (size_t r = 0; r < kMaxRows; r++) {
+        tile.rows[r] = (r < rows && tile.cols == kPanelWidth) ? y + r * n + col : tile.scratch[r];
+    }
+}
+
+static inline void endTile(const OutputTile& tile, float* y, size_t rows, size_t n, size_t col) {
+    if (tile.cols == kPanelWidth) {
+        return;
+    }
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < tile.cols; c++) {
+            y[r * n + col + c] = tile.scratch[r][c];
+        }
+    }
+}
+
+// Filas de `x` de un bloque; las que sobran repiten la primera (su salida se descarta)
+static inline void blockRows(const float* x, size_t rows, size_t k, const float* xr[kMaxRows]) {
+    for (size_t r = 0; r < kMaxRows; r++) {
+        xr[r] = x + (r < rows ? r : 0) * k;
+    }
+}
+
+static void matmulRowsScalar(const float* x, size_t rows, size_t k, const float* panels,
+                             size_t n, float* y) {
+    for (size_t col = 0; col < n; col += kPanelWidth) {
+        const float* panel = panels + col * k;
+        OutputTile tile;
+        beginTile(tile, y, rows, n, col);
+        for (size_t r = 0; r < rows; r++) {
+            float acc[kPanelWidth] = {};
+            const float* xr = x + r * k;
+            for (size_t i = 0; i < k; i++) {
+                const float xi = xr[i];
+                const float* w = panel + i * kPanelWidth;
+                for (size_t c = 0; c < kPanelWidth; c++) {
+                    acc[c] += xi * w[c];
+                }
+            }
+            for (size_t c = 0; c < kPanelWidth; c++) {
+                tile.rows[r][c] = acc[c];
+            }
+        }
+        endTile(tile, y, rows, n, col);
+    }
+}
+
+#if KERNELS_X86
+// -----------------------------------------------------------------------------
+// SSE2 (4 carriles)
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+static float dotSse2(const float* a, const float* b, size_t n) {
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("sse2")))
+static void axpySse2(float alpha, const float* x, float* y, size_t n) {
+    const __m128 va = _mm_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+        _mm_storeu_ps(y + i, vy);
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+__attribute__((target("sse2")))
+static void mulAddSse2(const float* x, const float* w, float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(w + i)));
+        _mm_storeu_ps(y + i, vy);
+    }
+    for (; i < n; i++) {
+        y[i] += x[i] * w[i];
+    }
+}
+
+// Bloque de 4 filas x 8 columnas (8 acumuladores): medio panel por pasada
+__attribute__((target("sse2")))
+static void matmulRowsSse2(const float* x, size_t rows, size_t k, const float* panels,
+                           size_t n, float* y) {
+    const float* xr[kMaxRows];
+    blockRows(x, rows, k, xr);
+    for (size_t col = 0; col < n; col += kPanelWidth) {
+        const float* panel = panels + col * k;
+        OutputTile tile;
+        beginTile(tile, y, rows, n, col);
+        for (size_t half = 0; half < kPanelWidth; half += 8) {
+            __m128 a00 = _mm_setzero_ps(), a01 = _mm_setzero_ps();
+            __m128 a10 = _mm_setzero_ps(), a11 = _mm_setzero_ps();
+            __m128 a20 = _mm_setzero_ps(), a21 = _mm_setzero_ps();
+            __m128 a30 = _mm_setzero_ps(), a31 = _mm_setzero_ps();
+            for (size_t i = 0; i < k; i++) {
+                const float* w = panel + i * kPanelWidth + half;
+                const __m128 w0 = _mm_loadu_ps(w);
+                const __m128 w1 = _mm_loadu_ps(w + 4);
+                __m128 xi = _mm_set1_ps(xr[0][i]);
+                a00 = _mm_add_ps(a00, _mm_mul_ps(xi, w0));
+                a01 = _mm_add_ps(a01, _mm_mul_ps(xi, w1));
+                xi = _mm_set1_ps(xr[1][i]);
+                a10 = _mm_add_ps(a10, _mm_mul_ps(xi, w0));
+                a11 = _mm_add_ps(a11, _mm_mul_ps(xi, w1));
+                xi = _mm_set1_ps(xr[2][i]);
+                a20 = _mm_add_ps(a20, _mm_mul_ps(xi, w0));
+                a21 = _mm_add_ps(a21, _mm_mul_ps(xi, w1));
+                xi = _mm_set1_ps(xr[3][i]);
+                a30 = _mm_add_ps(a30, _mm_mul_ps(xi, w0));
+                a31 = _mm_add_ps(a31, _mm_mul_ps(xi, w1));
+            }
+            _mm_storeu_ps(tile.rows[0] + half, a00);
+            _mm_storeu_ps(tile.rows[0] + half + 4, a01);
+            _mm_storeu_ps(tile.rows[1] + half, a10);
+            _mm_storeu_ps(tile.rows[1] + half + 4, a11);
+            _mm_storeu_ps(tile.rows[2] + half, a20);
+            _mm_storeu_ps(tile.rows[2] + half + 4, a21);
+            _mm_storeu_ps(tile.rows[3] + half, a30);
+            _mm_storeu_ps(tile.rows[3] + half + 4, a31);
+        }
+        endTile(tile, y, rows, n, col);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// AVX2 (8 carriles). Sin FMA para que axpy coincida bit a bit con la escalar.
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static float dotAvx2(const float* a, const float* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    float lanes[4];
+    _mm_storeu_ps(lanes, half);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static void axpyAvx2(float alpha, const float* x, float* y, size_t n) {
+    const __m256 va = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(va, _mm256_loadu_ps(x + i)));
+        _mm256_storeu_ps(y + i, vy);
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+__attribute__((target("avx2")))
+static void mulAddAvx2(const float* x, const float* w, float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(y + i),
+                                  _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(w + i)));
+        _mm256_storeu_ps(y + i, vy);
+    }
+    for (; i < n; i++) {
+        y[i] += x[i] * w[i];
+    }
+}
+
+// Bloque de 4 filas x 16 columnas (8 acumuladores): un panel por pasada
+__attribute__((target("avx2")))
+static void matmulRowsAvx2(const float* x, size_t rows, size_t k, const float* panels,
+                           size_t n, float* y) {
+    const float* xr[kMaxRows];
+    blockRows(x, rows, k, xr);
+    for (size_t col = 0; col < n; col += kPanelWidth) {
+        const float* panel = panels + col * k;
+        OutputTile tile;
+        beginTile(tile, y, rows, n, col);
+        __m256 a00 = _mm256_setzero_ps(), a01 = _mm256_setzero_ps();
+        __m256 a10 = _mm256_setzero_ps(), a11 = _mm256_setzero_ps();
+        __m256 a20 = _mm256_setzero_ps(), a21 = _mm256_setzero_ps();
+        __m256 a30 = _mm256_setzero_ps(), a31 = _mm256_setzero_ps();
+        for (size_t i = 0; i < k; i++) {
+            const float* w = panel + i * kPanelWidth;
+            const __m256 w0 = _mm256_loadu_ps(w);
+            const __m256 w1 = _mm256_loadu_ps(w + 8);
+            __m256 xi = _mm256_set1_ps(xr[0][i]);
+            a00 = _mm256_add_ps(a00, _mm256_mul_ps(xi, w0));
+            a01 = _mm256_add_ps(a01, _mm256_mul_ps(xi, w1));
+            xi = _mm256_set1_ps(xr[1][i]);
+            a10 = _mm256_add_ps(a10, _mm256_mul_ps(xi, w0));
+            a11 = _mm256_add_ps(a11, _mm256_mul_ps(xi, w1));
+            xi = _mm256_set1_ps(xr[2][i]);
+            a20 = _mm256_add_ps(a20, _mm256_mul_ps(xi, w0));
+            a21 = _mm256_add_ps(a21, _mm256_mul_ps(xi, w1));
+            xi = _mm256_set1_ps(xr[3][i]);
+            a30 = _mm256_add_ps(a30, _mm256_mul_ps(xi, w0));
+            a31 = _mm256_add_ps(a31, _mm256_mul_ps(xi, w1));
+        }
+        _mm256_storeu_ps(tile.rows[0], a00);
+        _mm256_storeu_ps(tile.rows[0] + 8, a01);
+        _mm256_storeu_ps(tile.rows[1], a10);
+        _mm256_storeu_ps(tile.rows[1] + 8, a11);
+        _mm256_storeu_ps(tile.rows[2], a20);
+        _mm256_storeu_ps(tile.rows[2] + 8, a21);
+        _mm256_storeu_ps(tile.rows[3], a30);
+        _mm256_storeu_ps(tile.rows[3] + 8, a31);
+        endTile(tile, y, rows, n, col);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// AVX-512 (16 carriles, cola con máscara). avx512f implica FMA y GCC contraería
+// mul + add; las variantes *_round_ps fijan redondeo por operación y lo impiden
+// (en su forma maskz para no arrastrar registros indefinidos).
+// -----------------------------------------------------------------------------
+#define ADD512(a, b) _mm512_maskz_add_round_ps(0xFFFF, (a), (b), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define MUL512(a, b) _mm512_maskz_mul_round_ps(0xFFFF, (a), (b), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+
+__attribute__((target("avx512f")))
+static float dotAvx512(const float* a, const float* b, size_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc = ADD512(acc, MUL512(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    }
+    if (i < n) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+        acc = ADD512(acc, MUL512(_mm512_maskz_loadu_ps(mask, a + i),
+                                 _mm512_maskz_loadu_ps(mask, b + i)));
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, acc);
+    float sum = 0.0f;
+    for (int k = 0; k < 16; k++) {
+        sum += lanes[k];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(float alpha, const float* x, float* y, size_t n) {
+    const __m512 va = _mm512_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 vy = ADD512(_mm512_loadu_ps(y + i), MUL512(va, _mm512_loadu_ps(x + i)));
+        _mm512_storeu_ps(y + i, vy);
+    }
+    if (i < n) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+        __m512 vy = ADD512(_mm512_maskz_loadu_ps(mask, y + i),
+                           MUL512(va, _mm512_maskz_loadu_ps(mask, x + i)));
+        _mm512_mask_storeu_ps(y + i, mask, vy);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void mulAddAvx512(const float* x, const float* w, float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 vy = ADD512(_mm512_loadu_ps(y + i), MUL512(_mm512_loadu_ps(x + i), _mm512_loadu_ps(w + i)));
+        _mm512_storeu_ps(y + i, vy);
+    }
+    if (i < n) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1u);
+        __m512 vy = ADD512(_mm512_maskz_loadu_ps(mask, y + i),
+                           MUL512(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, w + i)));
+        _mm512_mask_storeu_ps(y + i, mask, vy);
+    }
+}
+
+// Bloque de 4 filas x 32 columnas (8 acumuladores, dos paneles) y, si el número
+// de paneles es impar, uno de 4 x 16 al final
+__attribute__((target("avx512f")))
+static void matmulRowsAvx512(const float* x, size_t rows, size_t k, const float* panels,
+                             size_t n, float* y) {
+    const float* xr[kMaxRows];
+    blockRows(x, rows, k, xr);
+    size_t col = 0;
+    for (; col + kPanelWidth < n; col += 2 * kPanelWidth) {
+        const float* panel0 = panels + col * k;
+        const float* panel1 = panel0 + k * kPanelWidth;
+        OutputTile tile0, tile1;
+        beginTile(tile0, y, rows, n, col);
+        beginTile(tile1, y, rows, n, col + kPanelWidth);
+        __m512 a00 = _mm512_setzero_ps(), a01 = _mm512_setzero_ps();
+        __m512 a10 = _mm512_setzero_ps(), a11 = _mm512_setzero_ps();
+        __m512 a20 = _mm512_setzero_ps(), a21 = _mm512_setzero_ps();
+        __m512 a30 = _mm512_setzero_ps(), a31 = _mm512_setzero_ps();
+        for (size_t i = 0; i < k; i++) {
+            const __m512 w0 = _mm512_loadu_ps(panel0 + i * kPanelWidth);
+            const __m512 w1 = _mm512_loadu_ps(panel1 + i * kPanelWidth);
+            __m512 xi = _mm512_set1_ps(xr[0][i]);
+            a00 = ADD512(a00, MUL512(xi, w0));
+            a01 = ADD512(a01, MUL512(xi, w1));
+            xi = _mm512_set1_ps(xr[1][i]);
+            a10 = ADD512(a10, MUL512(xi, w0));
+            a11 = ADD512(a11, MUL512(xi, w1));
+            xi = _mm512_set1_ps(xr[2][i]);
+            a20 = ADD512(a20, MUL512(xi, w0));
+            a21 = ADD512(a21, MUL512(xi, w1));
+            xi = _mm512_set1_ps(xr[3][i]);
+            a30 = ADD512(a30, MUL512(xi, w0));
+            a31 = ADD512(a31, MUL512(xi, w1));
+        }
+        _mm512_storeu_ps(tile0.rows[0], a00);
+        _mm512_storeu_ps(tile1.rows[0], a01);
+        _mm512_storeu_ps(tile0.rows[1], a10);
+        _mm512_storeu_ps(tile1.rows[1], a11);
+        _mm512_storeu_ps(tile0.rows[2], a20);
+        _mm512_storeu_ps(tile1.rows[2], a21);
+        _mm512_storeu_ps(tile0.rows[3], a30);
+        _mm512_storeu_ps(tile1.rows[3], a31);
+        endTile(tile0, y, rows, n, col);
+        endTile(tile1, y, rows, n, col + kPanelWidth);
+    }
+    if (col < n) {
+        const float* panel = panels + col * k;
+        OutputTile tile;
+        beginTile(tile, y, rows, n, col);
+        __m512 a0 = _mm512_setzero_ps(), a1 = _mm512_setzero_ps();
+        __m512 a2 = _mm512_setzero_ps(), a3 = _mm512_setzero_ps();
+        for (size_t i = 0; i < k; i++) {
+            const __m512 w = _mm512_loadu_ps(panel + i * kPanelWidth);
+            a0 = ADD512(a0, MUL512(_mm512_set1_ps(xr[0][i]), w));
+            a1 = ADD512(a1, MUL512(_mm512_set1_ps(xr[1][i]), w));
+            a2 = ADD512(a2, MUL512(_mm512_set1_ps(xr[2][i]), w));
+            a3 = ADD512(a3, MUL512(_mm512_set1_ps(xr[3][i]), w));
+        }
+        _mm512_storeu_ps(tile.rows[0], a0);
+        _mm512_storeu_ps(tile.rows[1], a1);
+        _mm512_storeu_ps(tile.rows[2], a2);
+        _mm512_storeu_ps(tile.rows[3], a3);
+        endTile(tile, y, rows, n, col);
+    }
+}
+
+#undef ADD512
+#undef MUL512
+#endif // KERNELS_X86
+
+// -----------------------------------------------------------------------------
+// Despacho en tiempo de ejecución
+// -----------------------------------------------------------------------------
+struct KernelTable {
+    Isa isa;
+    float (*dot)(const float*, const float*, size_t);
+    void (*axpy)(float, const float*, float*, size_t);
+    void (*mulAdd)(const float*, const float*, float*, size_t);
+    void (*matmulRows)(const float*, size_t, size_t, const float*, size_t, float*);
+};
+
+static const KernelTable kScalarTable = {Isa::SCALAR, dotScalar, axpyScalar, mulAddScalar,
+                                         matmulRowsScalar};
+#if KERNELS_X86
+static const KernelTable kSse2Table   = {Isa::SSE2,   dotSse2,   axpySse2,   mulAddSse2,
+                                         matmulRowsSse2};
+static const KernelTable kAvx2Table   = {Isa::AVX2,   dotAvx2,   axpyAvx2,   mulAddAvx2,
+                                         matmulRowsAvx2};
+static const KernelTable kAvx512Table = {Isa::AVX512, dotAvx512, axpyAvx512, mulAddAvx512,
+                                         matmulRowsAvx512};
+#endif
+
+static const KernelTable* tableFor(Isa isa) {
+    switch (isa) {
+#if KERNELS_X86
+        case Isa::SSE2:   return &kSse2Table;
+        case Isa::AVX2:   return &kAvx2Table;
+        case Isa::AVX512: return &kAvx512Table;
+#endif
+        case Isa::SCALAR:
+        default:
+            return &kScalarTable;
+    }
+}
+
+static const KernelTable* bestTable() {
+    if (isaSupported(Isa::AVX512)) return tableFor(Isa::AVX512);
+    if (isaSupported(Isa::AVX2))   return tableFor(Isa::AVX2);
+    if (isaSupported(Isa::SSE2))   return tableFor(Isa::SSE2);
+    return tableFor(Isa::SCALAR);
+}
+
+// Atómico porque varios hilos pueden hacer la primera llamada a la vez (p.ej.
+// lectores de `ParameterStore`); todos eligen la misma tabla, así que basta relaxed
+static std::atomic<const KernelTable*> s_active{nullptr};
+
+static inline const KernelTable* active() {
+    const KernelTable* table = s_active.load(std::memory_order_relaxed);
+    if (table == nullptr) {
+        table = bestTable();
+        s_active.store(table, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+// Por debajo de este tamaño la llamada indirecta cuesta más que la operación.
+// Como axpy y mulAdd son exactos en todas las variantes, el atajo no cambia sus resultados.
+static const size_t kMinVectorLength = 16;
+
+float dot(const float* a, const float* b, size_t n) {
+#if KERNELS_X86
+    if (n >= kMinVectorLength) {
+        return active()->dot(a, b, n);
+    }
+#endif
+    return dotScalar(a, b, n);
+}
+
+void axpy(float alpha, const float* x, float* y, size_t n) {
+#if KERNELS_X86
+    if (n >= kMinVectorLength) {
+        active()->axpy(alpha, x, y, n);
+        return;
+    }
+#endif
+    axpyScalar(alpha, x, y, n);
+}
+
+void mulAdd(const float* x, const float* w, float* y, size_t n) {
+#if KERNELS_X86
+    if (n >= kMinVectorLength) {
+        active()->mulAdd(x, w, y, n);
+        return;
+    }
+#endif
+    mulAddScalar(x, w, y, n);
+}
+
+void outer(float alpha, const float* x, size_t m, const float* y, size_t n, float* A) {
+    for (size_t i = 0; i < m; i++) {
+        axpy(alpha * x[i], y, A + i * n, n);
+    }
+}
+
+size_t panelSize(size_t k, size_t n) {
+    return (n + kPanelWidth - 1) / kPanelWidth * kPanelWidth * k;
+}
+
+void packPanels(const float* W, size_t k, size_t n, float* panels) {
+    for (size_t col = 0; col < n; col += kPanelWidth) {
+        float* panel = panels + col * k;
+        for (size_t i = 0; i < k; i++) {
+            for (size_t c = 0; c < kPanelWidth; c++) {
+                panel[i * kPanelWidth + c] = (col + c < n) ? W[i * n + col + c] : 0.0f;
+            }
+        }
+    }
+}
+
+void matmulRows(const float* x, size_t rows, size_t k, const float* panels, size_t n, float* y) {
+#if KERNELS_X86
+    active()->matmulRows(x, rows, k, panels, n, y);
+#else
+    matmulRowsScalar(x, rows, k, panels, n, y);
+#endif
+}
+
+Isa activeIsa() {
+    return active()->isa;
+}
+
+bool isaSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#if KERNELS_X86
+        case Isa::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool setIsa(Isa isa) {
+    if (!isaSupported(isa)) {
+        return false;
+    }
+    s_active.store(tableFor(isa), std::memory_order_relaxed);
+    return true;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SSE2:   return "sse2";
+        case Isa::AVX2:   return "avx2";
+        case Isa::AVX512: return "avx512";
+        case Isa::SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+} // namespace kernels
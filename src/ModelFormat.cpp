@@ -0,0 +1,266 @@
+#include "ModelFormat.h"
+#include "Crc32.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ESP_PLATFORM
+#include <esp_partition.h>
+#endif
+
+/**
+ * @brief Cabecera fija; todos los campos están alineados de forma natural.
+ */
+struct ModelFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t numLayers;
+    uint8_t hiddenActivation;
+    uint8_t outputActivation;
+    uint16_t reserved;
+    uint32_t fileSize;
+    uint32_t checksum;
+};
+
+static const size_t kMaxLayers = 64;
+static const size_t kChecksumOffset = offsetof(ModelFileHeader, checksum);
+
+static inline size_t alignUp(size_t value) {
+    return (value + MODEL_ALIGNMENT - 1) & ~(MODEL_ALIGNMENT - 1);
+}
+
+static inline uint64_t alignUp64(uint64_t value) {
+    return (value + MODEL_ALIGNMENT - 1) & ~static_cast<uint64_t>(MODEL_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Cabecera fija más la tabla de capas y, desde v2, la de activaciones.
+ */
+static inline size_t headerSizeFor(uint16_t version, size_t numLayers) {
+    size_t activationTable = (version == MODEL_VERSION_V1) ? 0 : numLayers - 1;
+    return alignUp(sizeof(ModelFileHeader) + numLayers * sizeof(uint32_t) + activationTable);
+}
+
+static inline bool validActivation(uint8_t value) {
+    return value <= static_cast<uint8_t>(ActivationFunction::LINEAR);
+}
+
+/**
+ * @brief CRC del archivo saltando el campo del propio CRC (se toma como 0).
+ */
+static uint32_t fileChecksum(const uint8_t* bytes, size_t fileSize) {
+    const uint32_t zero = 0;
+    uint32_t crc = crc32(bytes, kChecksumOffset);
+    crc = crc32(&zero, sizeof(zero), crc);
+    const size_t rest = kChecksumOffset + sizeof(uint32_t);
+    return crc32(bytes + rest, fileSize - rest, crc);
+}
+
+ModelView parseModel(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (size < sizeof(ModelFileHeader)) {
+        throw std::runtime_error("Modelo truncado.");
+    }
+
+    ModelFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0) {
+        throw std::runtime_error("El buffer no contiene un modelo (magic incorrecto).");
+    }
+    if (header.version != MODEL_VERSION && header.version != MODEL_VERSION_V1) {
+        throw std::runtime_error("Versión de modelo no soportada.");
+    }
+    if (header.numLayers < 2 || header.numLayers > kMaxLayers ||
+        header.headerSize != headerSizeFor(header.version, header.numLayers) ||
+        header.fileSize > size || header.fileSize < header.headerSize) {
+        throw std::runtime_error("Cabecera de modelo inválida.");
+    }
+    if (fileChecksum(bytes, header.fileSize) != header.checksum) {
+        throw std::runtime_error("CRC del modelo incorrecto.");
+    }
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(float) != 0) {
+        throw std::runtime_error("El buffer del modelo no está alineado.");
+    }
+
+    ModelView view;
+    view.layers.resize(header.numLayers);
+    for (size_t i = 0; i < header.numLayers; i++) {
+        uint32_t neurons;
+        std::memcpy(&neurons, bytes + sizeof(ModelFileHeader) + i * sizeof(uint32_t), sizeof(neurons));
+        if (neurons == 0 || neurons > 65536) {
+            throw std::runtime_error("Tamaño de capa inválido en el modelo.");
+        }
+        view.layers[i] = static_cast<int>(neurons);
+    }
+
+    // v1: activación oculta en todas las capas salvo la última; v2: tabla por capa
+    const uint8_t* activationTable = bytes + sizeof(ModelFileHeader) + header.numLayers * sizeof(uint32_t);
+    for (size_t l = 0; l + 1 < header.numLayers; l++) {
+        uint8_t activation = (header.version == MODEL_VERSION_V1)
+                                 ? ((l + 2 == header.numLayers) ? header.outputActivation
+                                                                : header.hiddenActivation)
+                                 : activationTable[l];
+        if (!validActivation(activation)) {
+            throw std::runtime_error("Función de activación desconocida en el modelo.");
+        }
+        view.activations.push_back(static_cast<ActivationFunction>(activation));
+    }
+
+    // Tamaños en 64 bits: en el ESP32 (size_t de 32 bits) n_in * n_out * 4 puede
+    // desbordar y dejar pasar un modelo corrupto. Cada bloque se compara con lo que
+    // queda del archivo antes de sumarlo, así `offset` nunca supera `fileSize`.
+    size_t offset = header.headerSize;
+    for (size_t l = 0; l + 1 < header.numLayers; l++) {
+        uint64_t weightBytes = alignUp64(static_cast<uint64_t>(view.layers[l]) * view.layers[l + 1] * sizeof(float));
+        uint64_t biasBytes = alignUp64(static_cast<uint64_t>(view.layers[l + 1]) * sizeof(float));
+        if (weightBytes + biasBytes > header.fileSize - offset) {
+            throw std::runtime_error("Modelo truncado.");
+        }
+        view.weights.push_back(reinterpret_cast<const float*>(bytes + offset));
+        offset += static_cast<size_t>(weightBytes);
+        view.biases.push_back(reinterpret_cast<const float*>(bytes + offset));
+        offset += static_cast<size_t>(biasBytes);
+    }
+    if (offset != header.fileSize) {
+        throw std::runtime_error("Tamaño de modelo inconsistente con la topología.");
+    }
+    return view;
+}
+
+std::vector<uint8_t> serializeModel(const NeuralNetwork& network) {
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size();
+
+    const size_t headerSize = headerSizeFor(MODEL_VERSION, numLayers);
+    size_t fileSize = headerSize;
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        fileSize += alignUp(static_cast<size_t>(layers[l]) * layers[l + 1] * sizeof(float));
+        fileSize += alignUp(static_cast<size_t>(layers[l + 1]) * sizeof(float));
+    }
+
+    std::vector<uint8_t> out(fileSize, 0);
+
+    ModelFileHeader header;
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    header.version = MODEL_VERSION;
+    header.headerSize = static_cast<uint16_t>(headerSize);
+    header.numLayers = static_cast<uint32_t>(numLayers);
+    header.hiddenActivation = 0;  // v2 usa la tabla de activaciones
+    header.outputActivation = 0;
+    header.reserved = 0;
+    header.fileSize = static_cast<uint32_t>(fileSize);
+    header.checksum = 0;
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    for (size_t i = 0; i < numLayers; i++) {
+        uint32_t neurons = static_cast<uint32_t>(layers[i]);
+        std::memcpy(out.data() + sizeof(ModelFileHeader) + i * sizeof(uint32_t), &neurons, sizeof(neurons));
+    }
+    uint8_t* activationTable = out.data() + sizeof(ModelFileHeader) + numLayers * sizeof(uint32_t);
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        activationTable[l] = static_cast<uint8_t>(network.getActivation(l));
+    }
+
+    size_t offset = header.headerSize;
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        size_t weightBytes = static_cast<size_t>(layers[l]) * layers[l + 1] * sizeof(float);
+        size_t biasBytes = static_cast<size_t>(layers[l + 1]) * sizeof(float);
+        std::memcpy(out.data() + offset, network.weightsOf(l), weightBytes);
+        offset += alignUp(weightBytes);
+        std::memcpy(out.data() + offset, network.biasesOf(l), biasBytes);
+        offset += alignUp(biasBytes);
+    }
+
+    uint32_t checksum = fileChecksum(out.data(), fileSize);
+    std::memcpy(out.data() + kChecksumOffset, &checksum, sizeof(checksum));
+    return out;
+}
+
+void saveModel(const NeuralNetwork& network, const char* path) {
+    std::vector<uint8_t> bytes = serializeModel(network);
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("No se pudo abrir el archivo del modelo para escritura.");
+    }
+    size_t written = std::fwrite(bytes.data(), 1, bytes.size(), file);
+    int closed = std::fclose(file);
+    if (written != bytes.size() || closed != 0) {
+        throw std::runtime_error("No se pudo escribir el archivo del modelo.");
+    }
+}
+
+NeuralNetwork makeNetwork(const ModelView& view) {
+    NeuralNetwork network(view.layers, view.activations);
+    network.borrowWeights(view.weights, view.biases);
+    return network;
+}
+
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+MappedModel::MappedModel(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir el archivo del modelo.");
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("No se pudo leer el tamaño del modelo.");
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // El mapeo sigue siendo válido tras cerrar el descriptor
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear el modelo en memoria.");
+    }
+    m_data = data;
+
+    try {
+        m_view = parseModel(m_data, m_size);
+    } catch (...) {
+        ::munmap(m_data, m_size);
+        throw;
+    }
+}
+
+MappedModel::~MappedModel() {
+    ::munmap(m_data, m_size);
+}
+#endif
+
+#ifdef ESP_PLATFORM
+FlashModel::FlashModel(const char* partitionLabel) {
+    const esp_partition_t* partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partitionLabel);
+    if (partition == nullptr) {
+        throw std::runtime_error("No existe la partición del modelo.");
+    }
+
+    const void* data = nullptr;
+    spi_flash_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &data, &handle) != ESP_OK) {
+        throw std::runtime_error("No se pudo mapear la partición del modelo.");
+    }
+    m_handle = handle;
+
+    try {
+        m_view = parseModel(data, partition->size);
+    } catch (...) {
+        spi_flash_munmap(m_handle);
+        throw;
+    }
+}
+
+FlashModel::~FlashModel() {
+    spi_flash_munmap(m_handle);
+}
+#endif
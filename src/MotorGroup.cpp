@@ -0,0 +1,134 @@
+#include "MotorGroup.h"
+
+#ifdef ESP_PLATFORM
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#endif
+
+namespace {
+
+const int BANKS = 2;
+const uint32_t SET_REGISTER[BANKS] = { GPIO_OUT_W1TS_REG, GPIO_OUT1_W1TS_REG };
+const uint32_t CLEAR_REGISTER[BANKS] = { GPIO_OUT_W1TC_REG, GPIO_OUT1_W1TC_REG };
+
+} // namespace
+
+MotorGroup::MotorGroup(const uint8_t* pins, int count, const MotorGroupConfig& config)
+    : m_count(count < MAX_MOTORS ? count : MAX_MOTORS), m_config(config),
+      m_maxDuty((1u << config.resolutionBits) - 1), m_target(0), m_state(0), m_lastRampMs(0) {
+    for (int i = 0; i < m_count; ++i) {
+        m_pins[i] = pins[i];
+        m_banks[i] = pins[i] < 32 ? 0 : 1;
+        m_bankBits[i] = 1u << (pins[i] & 31);
+        m_duty[i] = 0;
+        pinMode(pins[i], OUTPUT);
+    }
+}
+
+void MotorGroup::begin() {
+    m_target = 0;
+    if (m_config.pwm) {
+        for (int i = 0; i < m_count; ++i) {
+            uint8_t channel = m_config.firstChannel + i;
+            ledcSetup(channel, m_config.frequency, m_config.resolutionBits);
+            ledcAttachPin(m_pins[i], channel);
+            ledcWrite(channel, 0);
+            m_duty[i] = 0;
+        }
+        m_state = 0;
+        m_lastRampMs = millis();
+    } else {
+        // Se desconoce el nivel de arranque de los pines: se apagan todos
+        m_state = (1u << m_count) - 1;
+        writeDigital(0);
+    }
+}
+
+void MotorGroup::command(uint32_t bits) {
+    bits &= (1u << m_count) - 1;
+    if (!m_config.pwm) {
+        if (bits != m_state) writeDigital(bits);
+        m_target = bits;
+        return;
+    }
+
+    if (bits == m_target) return;
+    // La rampa cuenta desde la orden, no desde la última vez que se movió
+    if (settled()) m_lastRampMs = millis();
+    m_target = bits;
+    update();
+}
+
+void MotorGroup::writeDigital(uint32_t bits) {
+    uint32_t turnOff = m_state & ~bits;
+    uint32_t turnOn = bits & ~m_state;
+    uint32_t clear[BANKS] = { 0, 0 };
+    uint32_t set[BANKS] = { 0, 0 };
+    for (int i = 0; i < m_count; ++i) {
+        if (turnOff & (1u << i)) clear[m_banks[i]] |= m_bankBits[i];
+        if (turnOn & (1u << i)) set[m_banks[i]] |= m_bankBits[i];
+    }
+
+    // Primero se apaga y luego se enciende (ver la descripción de la clase)
+    for (int b = 0; b < BANKS; ++b) {
+        if (clear[b] != 0) REG_WRITE(CLEAR_REGISTER[b], clear[b]);
+    }
+    for (int b = 0; b < BANKS; ++b) {
+        if (set[b] != 0) REG_WRITE(SET_REGISTER[b], set[b]);
+    }
+    m_state = bits;
+}
+
+void MotorGroup::writeDuty(int motor, uint32_t duty) {
+    if (duty == m_duty[motor]) return;
+    m_duty[motor] = duty;
+    ledcWrite(m_config.firstChannel + motor, duty);
+    if (duty > 0) {
+        m_state |= 1u << motor;
+    } else {
+        m_state &= ~(1u << motor);
+    }
+}
+
+bool MotorGroup::settled() const {
+    if (!m_config.pwm) return m_state == m_target;
+    for (int i = 0; i < m_count; ++i) {
+        uint32_t goal = (m_target & (1u << i)) ? m_maxDuty : 0;
+        if (m_duty[i] != goal) return false;
+    }
+    return true;
+}
+
+void MotorGroup::update() {
+    if (!m_config.pwm) return;
+
+    unsigned long now = millis();
+    if (settled()) {
+        m_lastRampMs = now;
+        return;
+    }
+
+    uint32_t step = m_maxDuty;
+    if (m_config.rampMs > 0) {
+        unsigned long elapsed = now - m_lastRampMs;
+        if (elapsed > m_config.rampMs) elapsed = m_config.rampMs;
+        step = static_cast<uint32_t>(static_cast<uint64_t>(elapsed) * m_maxDuty / m_config.rampMs);
+        if (step == 0) return;  // Se acumula hasta que toque al menos una unidad
+    }
+    m_lastRampMs = now;
+
+    bool stopping = false;
+    for (int i = 0; i < m_count; ++i) {
+        if (!(m_target & (1u << i)) && m_duty[i] > 0) {
+            writeDuty(i, m_duty[i] > step ? m_duty[i] - step : 0);
+            stopping = stopping || m_duty[i] > 0;
+        }
+    }
+    if (stopping) return;
+
+    for (int i = 0; i < m_count; ++i) {
+        if ((m_target & (1u << i)) && m_duty[i] < m_maxDuty) {
+            writeDuty(i, m_maxDuty - m_duty[i] > step ? m_duty[i] + step : m_maxDuty);
+        }
+    }
+}
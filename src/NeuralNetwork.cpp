@@ -1,86 +1,104 @@
 #include "NeuralNetwork.h"
+#include "Kernels.h"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
 /**
- * @brief Función ReLU (Rectified Linear Unit).
+ * @brief Activación fijada en tiempo de compilación: el switch de `applyActivation`
+ *        se resuelve al instanciar la plantilla y no queda ninguna rama por neurona.
  */
-static inline float relu(float x) {
-    return (x > 0.0f) ? x : 0.0f;
+template <ActivationFunction Act, ActivationMode Mode>
+static inline float activate(float x) {
+    return applyActivation(x, Act, Mode);
 }
 
 /**
- * @brief Función Sigmoid.
+ * @brief Capa densa de una muestra: out = act(in * W + b), con W aplanada como `i * outSize + j`.
+ *
+ * Recorre W por filas (contiguas) acumulando con `kernels::axpy`; cada salida se
+ * suma en el mismo orden que el bucle escalar original. `in` y `out` no deben solaparse.
  */
-static inline float sigmoid(float x) {
-    return 1.0f / (1.0f + std::exp(-x));
-}
-
-/**
- * @brief Función Tanh.
- */
-static inline float tanh_custom(float x) {
-    return std::tanh(x);
-}
-
-/**
- * @brief Función Linear.
- */
-static inline float linear(float x) {
-    return x;
-}
-
-/**
- * @brief Helper para aplicar la función de activación según el enum.
- */
-static inline float applyActivation(float x, ActivationFunction func) {
-    switch (func) {
-        case ActivationFunction::RELU:
-            return relu(x);
-        case ActivationFunction::SIGMOID:
-            return sigmoid(x);
-        case ActivationFunction::TANH:
-            return tanh_custom(x);
-        case ActivationFunction::LINEAR:
-        default:
-            return linear(x);
+template <ActivationFunction Act, ActivationMode Mode>
+static void denseLayer(const float* in, int inSize, const float* weights,
+                       const float* biases, int outSize, float* out) {
+    for (int j = 0; j < outSize; j++) {
+        out[j] = 0.0f;
+    }
+    for (int i = 0; i < inSize; i++) {
+        kernels::axpy(in[i], weights + i * outSize, out, outSize);
+    }
+    for (int j = 0; j < outSize; j++) {
+        out[j] = activate<Act, Mode>(out[j] + biases[j]);
     }
 }
 
-
 NeuralNetwork::NeuralNetwork(const std::vector<int>& layers,
                              ActivationFunction hiddenAct,
                              ActivationFunction outputAct)
-    : m_layers(layers),
-      m_hiddenActivation(hiddenAct),
-      m_outputActivation(outputAct)
+    : m_layers(layers)
 {
     // Validación mínima: se necesitan al menos 2 capas (entrada y salida)
     if (m_layers.size() < 2) {
         throw std::runtime_error("Se requieren al menos 2 capas (entrada y salida).");
     }
 
+    std::vector<ActivationFunction> activations(m_layers.size() - 1, hiddenAct);
+    activations.back() = outputAct;
+    initLayerSpecs(activations);
+    initLayout();
+
     // Inicializamos los pesos y sesgos con valores fijos (0.1f)
     initWeights();
+    initWorkspace();
 }
 
-void NeuralNetwork::initWeights() {
-    m_weights.resize(m_layers.size() - 1);
-    m_biases.resize(m_layers.size() - 1);
+NeuralNetwork::NeuralNetwork(const std::vector<int>& layers,
+                             const std::vector<ActivationFunction>& activations)
+    : m_layers(layers)
+{
+    if (m_layers.size() < 2) {
+        throw std::runtime_error("Se requieren al menos 2 capas (entrada y salida).");
+    }
+    if (activations.size() != m_layers.size() - 1) {
+        throw std::runtime_error("Se requiere una función de activación por capa con pesos.");
+    }
+
+    initLayerSpecs(activations);
+    initLayout();
+    initWeights();
+    initWorkspace();
+}
 
+void NeuralNetwork::initLayout() {
+    m_layerOffsets.resize(m_layers.size() - 1);
+    m_parameterCount = 0;
     for (size_t layerIndex = 0; layerIndex < m_layers.size() - 1; layerIndex++) {
-        int inSize  = m_layers[layerIndex];
-        int outSize = m_layers[layerIndex + 1];
+        m_layerOffsets[layerIndex] = m_parameterCount;
+        // Matriz (aplanada) de pesos seguida de los sesgos
+        m_parameterCount += static_cast<size_t>(m_layers[layerIndex] + 1) * m_layers[layerIndex + 1];
+    }
+    // Los gradientes no se reservan aquí, sino al pedirlos (`gradients`)
+}
+
+void NeuralNetwork::initWeights() {
+    m_parameters.assign(m_parameterCount, 0.1f);
+    markParametersChanged();
+}
 
-        // Tamaño de la matriz (aplanada) de pesos
-        m_weights[layerIndex].resize(inSize * outSize, 0.1f);
+void NeuralNetwork::initWorkspace() {
+    int maxWidth = *std::max_element(m_layers.begin(), m_layers.end());
+    m_bufferA.assign(maxWidth, 0.0f);
+    m_bufferB.assign(maxWidth, 0.0f);
 
-        // Tamaño de sesgos
-        m_biases[layerIndex].resize(outSize, 0.1f);
+    m_layerActivations.resize(m_layers.size());
+    for (size_t layerIndex = 0; layerIndex < m_layers.size(); layerIndex++) {
+        m_layerActivations[layerIndex].assign(m_layers[layerIndex], 0.0f);
     }
+    m_delta.assign(maxWidth, 0.0f);
+    m_prevDelta.assign(maxWidth, 0.0f);
 }
 
-
 float NeuralNetwork::calculateMSE(const std::vector<float>& output, const std::vector<float>& target) {
     if (output.size() != target.size()) {
         throw std::runtime_error("El tamaño de output y target no coinciden.");
@@ -180,9 +198,61 @@ void NeuralNetwork::setWeights(const std::vector<std::vector<float>>& weights,
         throw std::runtime_error("Pesos o sesgos no coinciden con la topología de la red.");
     }
 
-    // Asigna los pesos y sesgos externos
-    m_weights = weights;
-    m_biases  = biases;
+    // El forward sin reservas confía en que cada capa tenga el tamaño esperado
+    for (size_t layerIndex = 0; layerIndex < m_layers.size() - 1; layerIndex++) {
+        size_t inSize  = m_layers[layerIndex];
+        size_t outSize = m_layers[layerIndex + 1];
+        if (weights[layerIndex].size() != inSize * outSize ||
+            biases[layerIndex].size()  != outSize)
+        {
+            throw std::runtime_error("Pesos o sesgos no coinciden con la topología de la red.");
+        }
+    }
+
+    // Copia los pesos y sesgos externos en el bloque (que se vuelve a reservar si
+    // se liberó con `borrowWeights`)
+    if (m_parameters.size() != m_parameterCount) {
+        m_parameters.assign(m_parameterCount, 0.0f);
+    }
+    for (size_t layerIndex = 0; layerIndex < m_layers.size() - 1; layerIndex++) {
+        std::copy(weights[layerIndex].begin(), weights[layerIndex].end(), ownWeights(layerIndex));
+        std::copy(biases[layerIndex].begin(), biases[layerIndex].end(), ownBiases(layerIndex));
+    }
+    m_borrowedWeights.clear();
+    m_borrowedBiases.clear();
+    markParametersChanged();
+}
+
+void NeuralNetwork::borrowWeights(const std::vector<const float*>& weights,
+                                  const std::vector<const float*>& biases)
+{
+    if (weights.size() != m_layers.size() - 1 ||
+        biases.size()  != m_layers.size() - 1)
+    {
+        throw std::runtime_error("Pesos o sesgos no coinciden con la topología de la red.");
+    }
+
+    m_borrowedWeights = weights;
+    m_borrowedBiases  = biases;
+
+    // Liberamos la copia propia: los parámetros solo viven en el buffer prestado.
+    // Los gradientes tampoco sirven sin parámetros propios que actualizar
+    m_parameters.reset();
+    m_gradients.reset();
+    markParametersChanged();
+}
+
+float* NeuralNetwork::gradients() {
+    if (m_gradients.empty()) {
+        m_gradients.assign(m_parameterCount, 0.0f);
+    }
+    return m_gradients.data();
+}
+
+void NeuralNetwork::requireOwnedWeights() const {
+    if (hasBorrowedWeights()) {
+        throw std::runtime_error("Los parámetros prestados son de solo lectura.");
+    }
 }
 
 std::vector<float> NeuralNetwork::forward(const std::vector<float>& input) {
@@ -191,38 +261,264 @@ std::vector<float> NeuralNetwork::forward(const std::vector<float>& input) {
         throw std::runtime_error("El vector de entrada no coincide con la capa de entrada.");
     }
 
-    // Vector que almacena las activaciones de la capa actual
-    std::vector<float> activations = input;
+    std::vector<float> output(m_layers.back());
+    forward(input.data(), output.data());
+    return output;
+}
+
+void NeuralNetwork::forward(const float* input, float* output) {
+    const size_t numLayers = m_layers.size() - 1;
+    const float* activations = input;
 
     // Recorremos cada capa, salvo la última (que no tiene pesos salientes)
-    for (size_t layerIndex = 0; layerIndex < m_layers.size() - 1; layerIndex++) {
+    for (size_t layerIndex = 0; layerIndex < numLayers; layerIndex++) {
         int inSize  = m_layers[layerIndex];
         int outSize = m_layers[layerIndex + 1];
 
-        std::vector<float> newActivations(outSize, 0.0f);
+        // La última capa escribe directamente en la salida; las demás alternan buffers
+        float* newActivations = (layerIndex == numLayers - 1) ? output
+                              : (layerIndex % 2 == 0)         ? m_bufferA.data()
+                                                              : m_bufferB.data();
+
+        m_layerSpecs[layerIndex].dense(activations, inSize, weightsOf(layerIndex),
+                                       biasesOf(layerIndex), outSize, newActivations);
+
+        // Las activaciones de esta capa alimentan la siguiente
+        activations = newActivations;
+    }
+}
+
+void NeuralNetwork::forward(const float* input, float* output, const float* parameters) {
+    const size_t numLayers = m_layers.size() - 1;
+    const float* activations = input;
+
+    for (size_t layerIndex = 0; layerIndex < numLayers; layerIndex++) {
+        int inSize  = m_layers[layerIndex];
+        int outSize = m_layers[layerIndex + 1];
+        const float* weights = parameters;
+        const float* biases = weights + inSize * outSize;
+        parameters = biases + outSize;
+
+        float* newActivations = (layerIndex == numLayers - 1) ? output
+                              : (layerIndex % 2 == 0)         ? m_bufferA.data()
+                                                              : m_bufferB.data();
+
+        m_layerSpecs[layerIndex].dense(activations, inSize, weights, biases, outSize, newActivations);
+        activations = newActivations;
+    }
+}
+
+void NeuralNetwork::packWeights() {
+    if (!m_packedDirty) {
+        return;
+    }
+
+    m_packedWeights.resize(m_layers.size() - 1);
+    for (size_t layerIndex = 0; layerIndex < m_packedWeights.size(); layerIndex++) {
+        int inSize  = m_layers[layerIndex];
+        int outSize = m_layers[layerIndex + 1];
+
+        const float* weights = weightsOf(layerIndex);
+        if (outSize >= kWideLayer) {
+            m_packedWeights[layerIndex].resize(kernels::panelSize(inSize, outSize));
+            kernels::packPanels(weights, inSize, outSize, m_packedWeights[layerIndex].data());
+            continue;
+        }
+
+        m_packedWeights[layerIndex].resize(inSize * outSize);
+        for (int i = 0; i < inSize; i++) {
+            for (int j = 0; j < outSize; j++) {
+                m_packedWeights[layerIndex][j * inSize + i] = weights[i * outSize + j];
+            }
+        }
+    }
+    m_packedDirty = false;
+}
+
+/**
+ * @brief Capa densa sobre un lote: out = act(in * W + b).
+ *
+ * En capas estrechas (`outSize < kWideLayer`) `packed` guarda una fila contigua
+ * de `inSize` pesos por neurona y se procesan bloques de 4 filas por neurona
+ * para reutilizar cada peso cargado. En capas anchas `packed` guarda W en
+ * paneles (`kernels::packPanels`) y `kernels::matmulRows` calcula bloques de 4
+ * filas con las salidas en registros. En ambos casos la suma se hace en el
+ * mismo orden que `forward`, así que el resultado es idéntico.
+ */
+template <ActivationFunction Act, ActivationMode Mode>
+static void denseBatch(const float* in, size_t numRows, int inSize, int outSize,
+                       const float* packed, const float* biases, float* out) {
+    const size_t kRowBlock = 4;
+    size_t row = 0;
+
+    if (outSize >= NeuralNetwork::kWideLayer) {
+        for (; row < numRows; row += kernels::kMaxRows) {
+            size_t rows = (numRows - row < kernels::kMaxRows) ? numRows - row : kernels::kMaxRows;
+            const float* x = in + row * inSize;
+            float* y = out + row * outSize;
+            kernels::matmulRows(x, rows, inSize, packed, outSize, y);
+            for (size_t r = 0; r < rows; r++) {
+                for (int j = 0; j < outSize; j++) {
+                    y[r * outSize + j] = activate<Act, Mode>(y[r * outSize + j] + biases[j]);
+                }
+            }
+        }
+        return;
+    }
+
+    for (; row + kRowBlock <= numRows; row += kRowBlock) {
+        const float* x0 = in + (row + 0) * inSize;
+        const float* x1 = in + (row + 1) * inSize;
+        const float* x2 = in + (row + 2) * inSize;
+        const float* x3 = in + (row + 3) * inSize;
+        float* y0 = out + (row + 0) * outSize;
+        float* y1 = out + (row + 1) * outSize;
+        float* y2 = out + (row + 2) * outSize;
+        float* y3 = out + (row + 3) * outSize;
 
-        // Multiplicación activations x pesos
         for (int j = 0; j < outSize; j++) {
+            const float* w = packed + j * inSize;
+            float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
             for (int i = 0; i < inSize; i++) {
-                newActivations[j] += activations[i] * m_weights[layerIndex][i * outSize + j];
+                float wi = w[i];
+                s0 += x0[i] * wi;
+                s1 += x1[i] * wi;
+                s2 += x2[i] * wi;
+                s3 += x3[i] * wi;
             }
-            // Suma de sesgos
-            newActivations[j] += m_biases[layerIndex][j];
+            y0[j] = activate<Act, Mode>(s0 + biases[j]);
+            y1[j] = activate<Act, Mode>(s1 + biases[j]);
+            y2[j] = activate<Act, Mode>(s2 + biases[j]);
+            y3[j] = activate<Act, Mode>(s3 + biases[j]);
+        }
+    }
+
+    // Filas restantes que no completan un bloque
+    for (; row < numRows; row++) {
+        const float* x = in + row * inSize;
+        float* y = out + row * outSize;
+        for (int j = 0; j < outSize; j++) {
+            const float* w = packed + j * inSize;
+            float sum = 0.0f;
+            for (int i = 0; i < inSize; i++) {
+                sum += x[i] * w[i];
+            }
+            y[j] = activate<Act, Mode>(sum + biases[j]);
+        }
+    }
+}
 
-            // Determinamos si es una capa oculta o la capa final
-            ActivationFunction currentAct = (layerIndex < (m_layers.size() - 2))
-                                            ? m_hiddenActivation
-                                            : m_outputActivation;
+/**
+ * @brief Núcleos especializados para una activación y un modo dados.
+ */
+template <ActivationMode Mode>
+static void kernelsFor(ActivationFunction act, NeuralNetwork::DenseKernel& dense,
+                       NeuralNetwork::BatchKernel& batch) {
+    switch (act) {
+        case ActivationFunction::RELU:
+            dense = denseLayer<ActivationFunction::RELU, Mode>;
+            batch = denseBatch<ActivationFunction::RELU, Mode>;
+            break;
+        case ActivationFunction::SIGMOID:
+            dense = denseLayer<ActivationFunction::SIGMOID, Mode>;
+            batch = denseBatch<ActivationFunction::SIGMOID, Mode>;
+            break;
+        case ActivationFunction::TANH:
+            dense = denseLayer<ActivationFunction::TANH, Mode>;
+            batch = denseBatch<ActivationFunction::TANH, Mode>;
+            break;
+        case ActivationFunction::LINEAR:
+        default:
+            dense = denseLayer<ActivationFunction::LINEAR, Mode>;
+            batch = denseBatch<ActivationFunction::LINEAR, Mode>;
+            break;
+    }
+}
+
+void NeuralNetwork::initLayerSpecs(const std::vector<ActivationFunction>& activations) {
+    m_layerSpecs.resize(activations.size());
+    for (size_t layerIndex = 0; layerIndex < activations.size(); layerIndex++) {
+        m_layerSpecs[layerIndex].activation = activations[layerIndex];
+    }
+    selectKernels();
+}
 
-            // Aplicamos la función de activación
-            newActivations[j] = applyActivation(newActivations[j], currentAct);
+void NeuralNetwork::selectKernels() {
+    for (LayerSpec& spec : m_layerSpecs) {
+        // RELU y LINEAR no dependen del modo: siempre se usa la instancia EXACT
+        bool approximable = spec.activation == ActivationFunction::SIGMOID ||
+                            spec.activation == ActivationFunction::TANH;
+        switch (approximable ? m_activationMode : ActivationMode::EXACT) {
+            case ActivationMode::LUT:
+                kernelsFor<ActivationMode::LUT>(spec.activation, spec.dense, spec.batch);
+                break;
+            case ActivationMode::RATIONAL:
+                kernelsFor<ActivationMode::RATIONAL>(spec.activation, spec.dense, spec.batch);
+                break;
+            case ActivationMode::HARD:
+                kernelsFor<ActivationMode::HARD>(spec.activation, spec.dense, spec.batch);
+                break;
+            case ActivationMode::EXACT:
+            default:
+                kernelsFor<ActivationMode::EXACT>(spec.activation, spec.dense, spec.batch);
+                break;
         }
+    }
+}
+
+void NeuralNetwork::setActivation(size_t layerIndex, ActivationFunction func) {
+    if (layerIndex >= m_layerSpecs.size()) {
+        throw std::runtime_error("Índice de capa fuera de rango.");
+    }
+    m_layerSpecs[layerIndex].activation = func;
+    selectKernels();
+    m_parameterVersion++;
+}
+
+void NeuralNetwork::setActivationMode(ActivationMode mode) {
+    m_activationMode = mode;
+    selectKernels();
+    m_parameterVersion++;
+}
+
+void NeuralNetwork::forwardBatch(const float* inputs, size_t numRows, float* outputs) {
+    if (numRows == 0) {
+        return;
+    }
+    packWeights();
+
+    const size_t numLayers = m_layers.size() - 1;
+    const size_t batchSize = numRows * m_bufferA.size();
+    if (numLayers > 1 && m_batchA.size() < batchSize) {
+        m_batchA.resize(batchSize);
+        m_batchB.resize(batchSize);
+    }
+
+    const float* activations = inputs;
+    for (size_t layerIndex = 0; layerIndex < numLayers; layerIndex++) {
+        float* newActivations = (layerIndex == numLayers - 1) ? outputs
+                              : (layerIndex % 2 == 0)         ? m_batchA.data()
+                                                              : m_batchB.data();
+
+        m_layerSpecs[layerIndex].batch(activations, numRows, m_layers[layerIndex],
+                                       m_layers[layerIndex + 1],
+                                       m_packedWeights[layerIndex].data(), biasesOf(layerIndex),
+                                       newActivations);
 
-        // Actualizamos las activaciones para la siguiente capa
         activations = newActivations;
     }
+}
+
+std::vector<float> NeuralNetwork::forwardBatch(const std::vector<float>& inputs) {
+    const size_t inSize = m_layers.front();
+    if (inputs.size() % inSize != 0) {
+        throw std::runtime_error("El lote de entrada no es múltiplo de la capa de entrada.");
+    }
 
-    return activations;
+    const size_t numRows = inputs.size() / inSize;
+    std::vector<float> outputs(numRows * m_layers.back());
+    forwardBatch(inputs.data(), numRows, outputs.data());
+    return outputs;
 }
 
 void NeuralNetwork::computeGradients(const std::vector<float>& input,
@@ -230,79 +526,274 @@ void NeuralNetwork::computeGradients(const std::vector<float>& input,
                                      std::vector<std::vector<float>>& grad_weights,
                                      std::vector<std::vector<float>>& grad_biases) {
     // Inicializar estructuras
-    grad_weights = std::vector<std::vector<float>>(m_weights.size());
-    grad_biases = std::vector<std::vector<float>>(m_biases.size());
+    const size_t numLayers = m_layers.size() - 1;
+    grad_weights = std::vector<std::vector<float>>(numLayers);
+    grad_biases = std::vector<std::vector<float>>(numLayers);
 
-    for (size_t i = 0; i < m_weights.size(); i++) {
-        grad_weights[i] = std::vector<float>(m_weights[i].size(), 0.0f);
-        grad_biases[i] = std::vector<float>(m_biases[i].size(), 0.0f);
+    for (size_t i = 0; i < numLayers; i++) {
+        grad_weights[i] = std::vector<float>(m_layers[i] * m_layers[i + 1], 0.0f);
+        grad_biases[i] = std::vector<float>(m_layers[i + 1], 0.0f);
     }
 
     // 1️ Forward pass
     std::vector<float> activations = input;
     std::vector<std::vector<float>> layer_activations = {activations};
 
-    for (size_t layerIndex = 0; layerIndex < m_weights.size(); layerIndex++) {
+    for (size_t layerIndex = 0; layerIndex < numLayers; layerIndex++) {
         int inSize = m_layers[layerIndex];
         int outSize = m_layers[layerIndex + 1];
 
         std::vector<float> newActivations(outSize, 0.0f);
 
-        for (int j = 0; j < outSize; j++) {
-            for (int i = 0; i < inSize; i++) {
-                newActivations[j] += activations[i] * m_weights[layerIndex][i * outSize + j];
-            }
-            newActivations[j] += m_biases[layerIndex][j];
-
-            ActivationFunction func = (layerIndex < m_layers.size() - 2) ? m_hiddenActivation : m_outputActivation;
-            newActivations[j] = applyActivation(newActivations[j], func);
-        }
+        m_layerSpecs[layerIndex].dense(activations.data(), inSize, weightsOf(layerIndex),
+                                       biasesOf(layerIndex), outSize, newActivations.data());
         activations = newActivations;
         layer_activations.push_back(activations);
     }
 
-    //  Backpropagation
-    std::vector<float> delta = layer_activations.back();
-    for (size_t i = 0; i < delta.size(); i++) {
-        delta[i] = delta[i] - target[i]; // Derivada de MSE: (output - target)
+    //  Backpropagation: misma regla que `accumulateGradients`
+    const std::vector<float>& outputs = layer_activations.back();
+    const int outputSize = m_layers.back();
+    const ActivationFunction outputAct = m_layerSpecs.back().activation;
+    std::vector<float> delta(outputSize);
+    for (int j = 0; j < outputSize; j++) {
+        float diff = outputs[j] - target[j];
+        delta[j] = (2.0f * diff / outputSize) * activationDerivative(outputs[j], outputAct);
     }
 
-    for (int layerIndex = m_weights.size() - 1; layerIndex >= 0; layerIndex--) {
+    for (int layerIndex = numLayers - 1; layerIndex >= 0; layerIndex--) {
         int inSize = m_layers[layerIndex];
         int outSize = m_layers[layerIndex + 1];
 
         std::vector<float> prev_delta = std::vector<float>(inSize, 0.0f);
 
-        for (int j = 0; j < outSize; j++) {
+        // grad_W = a_{l} (x) delta (la matriz parte de cero)
+        kernels::outer(1.0f, layer_activations[layerIndex].data(), inSize,
+                       delta.data(), outSize, grad_weights[layerIndex].data());
+        grad_biases[layerIndex] = delta;
+
+        // La entrada de la red no tiene activación que derivar
+        if (layerIndex == 0) {
+            break;
+        }
+
+        // prev_delta = (W * delta) por la derivada de la activación de la capa
+        // anterior, recorriendo cada fila de W de forma contigua
+        const ActivationFunction inputAct = m_layerSpecs[layerIndex - 1].activation;
+        for (int i = 0; i < inSize; i++) {
+            float backprop = kernels::dot(weightsOf(layerIndex) + i * outSize,
+                                          delta.data(), outSize);
+            prev_delta[i] = backprop * activationDerivative(layer_activations[layerIndex][i], inputAct);
+        }
+
+        delta = prev_delta;
+    }
+}
+
+
+void NeuralNetwork::forwardTrain(const float* input, float* output) {
+    const size_t numLayers = m_layers.size() - 1;
+    std::copy(input, input + m_layers[0], m_layerActivations[0].begin());
+
+    for (size_t layerIndex = 0; layerIndex < numLayers; layerIndex++) {
+        m_layerSpecs[layerIndex].dense(m_layerActivations[layerIndex].data(), m_layers[layerIndex],
+                                       weightsOf(layerIndex), biasesOf(layerIndex),
+                                       m_layers[layerIndex + 1],
+                                       m_layerActivations[layerIndex + 1].data());
+    }
+
+    const std::vector<float>& last = m_layerActivations.back();
+    std::copy(last.begin(), last.end(), output);
+}
+
+float NeuralNetwork::outputDelta(const float* target) {
+    const std::vector<float>& outputs = m_layerActivations.back();
+    const int outputSize = m_layers.back();
+    const ActivationFunction outputAct = m_layerSpecs.back().activation;
+    float loss = 0.0f;
+    for (int j = 0; j < outputSize; j++) {
+        float diff = outputs[j] - target[j];
+        loss += diff * diff;
+        m_delta[j] = (2.0f * diff / outputSize) * activationDerivative(outputs[j], outputAct);
+    }
+    return loss / outputSize;
+}
+
+float NeuralNetwork::backward(const float* target, float learningRate) {
+    requireOwnedWeights();
+    float loss = outputDelta(target);
+
+    for (int layerIndex = m_layers.size() - 2; layerIndex >= 0; layerIndex--) {
+        int inSize = m_layers[layerIndex];
+        int outSize = m_layers[layerIndex + 1];
+        const float* activations = m_layerActivations[layerIndex].data();
+        float* weights = ownWeights(layerIndex);
+        // La entrada de la red no tiene activación que derivar
+        const bool hasInputActivation = layerIndex > 0;
+        const ActivationFunction inputAct = hasInputActivation ? m_layerSpecs[layerIndex - 1].activation
+                                                               : ActivationFunction::LINEAR;
+
+        for (int i = 0; i < inSize; i++) {
+            float* row = weights + i * outSize;
+
+            // prev_delta usa los pesos antes de actualizarlos, como computeGradients
+            if (hasInputActivation) {
+                float backprop = kernels::dot(row, m_delta.data(), outSize);
+                m_prevDelta[i] = backprop * activationDerivative(activations[i], inputAct);
+            }
+
+            // W -= lr * (a_i * delta), en la misma fila ya cargada
+            const float ai = activations[i];
+            for (int j = 0; j < outSize; j++) {
+                row[j] -= learningRate * (ai * m_delta[j]);
+            }
+        }
+        kernels::axpy(-learningRate, m_delta.data(), ownBiases(layerIndex), outSize);
+
+        m_delta.swap(m_prevDelta);
+    }
+
+    markParametersChanged();
+    return loss;
+}
+
+float NeuralNetwork::trainStep(const float* input, const float* target, float learningRate,
+                               float* output) {
+    forwardTrain(input, (output != nullptr) ? output : m_bufferA.data());
+    return backward(target, learningRate);
+}
+
+size_t NeuralNetwork::parameterCount() const {
+    return m_parameterCount;
+}
+
+float NeuralNetwork::accumulateGradients(const float* input, const float* target, float* gradients) {
+    const size_t numLayers = m_layers.size() - 1;
+    forwardTrain(input, m_bufferA.data());
+
+    // Desplazamiento de cada capa dentro del buffer plano [W0, b0, W1, b1, ...]
+    size_t offset = parameterCount();
+
+    // Derivada de MSE respecto a la salida, por la derivada de la activación de salida
+    float loss = outputDelta(target);
+
+    for (int layerIndex = numLayers - 1; layerIndex >= 0; layerIndex--) {
+        int inSize = m_layers[layerIndex];
+        int outSize = m_layers[layerIndex + 1];
+        const float* activations = m_layerActivations[layerIndex].data();
+
+        offset -= static_cast<size_t>(inSize + 1) * outSize;
+        float* gradWeights = gradients + offset;
+        float* gradBiases = gradWeights + inSize * outSize;
+
+        kernels::outer(1.0f, activations, inSize, m_delta.data(), outSize, gradWeights);
+        kernels::axpy(1.0f, m_delta.data(), gradBiases, outSize);
+
+        // La entrada de la red no tiene activación que derivar
+        if (layerIndex > 0) {
+            // Las activaciones de entrada de esta capa son la salida de la anterior
+            const ActivationFunction inputAct = m_layerSpecs[layerIndex - 1].activation;
             for (int i = 0; i < inSize; i++) {
-                grad_weights[layerIndex][i * outSize + j] = layer_activations[layerIndex][i] * delta[j];
-                prev_delta[i] += m_weights[layerIndex][i * outSize + j] * delta[j];
+                float backprop = kernels::dot(weightsOf(layerIndex) + i * outSize,
+                                              m_delta.data(), outSize);
+                m_prevDelta[i] = backprop * activationDerivative(activations[i], inputAct);
             }
-            grad_biases[layerIndex][j] = delta[j];
+            m_delta.swap(m_prevDelta);
         }
+    }
 
-        delta = prev_delta;
+    return loss;
+}
+
+void NeuralNetwork::addToParameters(const float* delta) {
+    requireOwnedWeights();
+    kernels::axpy(1.0f, delta, m_parameters.data(), m_parameterCount);
+    markParametersChanged();
+}
+
+float* NeuralNetwork::mutableParameters() {
+    requireOwnedWeights();
+    markParametersChanged();
+    return m_parameters.data();
+}
+
+void NeuralNetwork::copyParameters(float* destination) const {
+    if (!hasBorrowedWeights()) {
+        std::copy(m_parameters.data(), m_parameters.data() + m_parameterCount, destination);
+        return;
+    }
+    // Los parámetros prestados pueden estar repartidos: capa a capa
+    for (size_t layerIndex = 0; layerIndex < m_layers.size() - 1; layerIndex++) {
+        const size_t numWeights = static_cast<size_t>(m_layers[layerIndex]) * m_layers[layerIndex + 1];
+        const size_t numBiases = m_layers[layerIndex + 1];
+        std::copy(weightsOf(layerIndex), weightsOf(layerIndex) + numWeights, destination);
+        destination += numWeights;
+        std::copy(biasesOf(layerIndex), biasesOf(layerIndex) + numBiases, destination);
+        destination += numBiases;
+    }
+}
+
+void NeuralNetwork::setParameters(const float* source) {
+    requireOwnedWeights();
+    std::copy(source, source + m_parameterCount, m_parameters.data());
+    markParametersChanged();
+}
+
+std::vector<std::vector<float>> NeuralNetwork::getWeights() const {
+    std::vector<std::vector<float>> weights(m_layers.size() - 1);
+    for (size_t layerIndex = 0; layerIndex < weights.size(); layerIndex++) {
+        const float* w = weightsOf(layerIndex);
+        weights[layerIndex].assign(w, w + m_layers[layerIndex] * m_layers[layerIndex + 1]);
     }
+    return weights;
 }
 
+std::vector<std::vector<float>> NeuralNetwork::getBiases() const {
+    std::vector<std::vector<float>> biases(m_layers.size() - 1);
+    for (size_t layerIndex = 0; layerIndex < biases.size(); layerIndex++) {
+        const float* b = biasesOf(layerIndex);
+        biases[layerIndex].assign(b, b + m_layers[layerIndex + 1]);
+    }
+    return biases;
+}
+
+size_t NeuralNetwork::memoryBytes() const {
+    size_t bytes = m_parameters.bytes() + m_gradients.bytes();
+    bytes += m_layers.capacity() * sizeof(int);
+    bytes += m_layerOffsets.capacity() * sizeof(size_t);
+    bytes += (m_borrowedWeights.capacity() + m_borrowedBiases.capacity()) * sizeof(const float*);
+    bytes += m_layerSpecs.capacity() * sizeof(LayerSpec);
+    bytes += (m_bufferA.capacity() + m_bufferB.capacity()) * sizeof(float);
+    bytes += m_layerActivations.capacity() * sizeof(std::vector<float>);
+    for (const std::vector<float>& activations : m_layerActivations) {
+        bytes += activations.capacity() * sizeof(float);
+    }
+    bytes += (m_delta.capacity() + m_prevDelta.capacity()) * sizeof(float);
+    bytes += m_packedWeights.capacity() * sizeof(std::vector<float>);
+    for (const std::vector<float>& packed : m_packedWeights) {
+        bytes += packed.capacity() * sizeof(float);
+    }
+    bytes += (m_batchA.capacity() + m_batchB.capacity()) * sizeof(float);
+    return bytes;
+}
 
 void NeuralNetwork::updateWeights(const std::vector<std::vector<float>>& gradients_weights,
                                   const std::vector<std::vector<float>>& gradients_biases,
                                   float learningRate) {
-    if (gradients_weights.size() != m_weights.size() || 
-        gradients_biases.size() != m_biases.size()) {
+    requireOwnedWeights();
+    const size_t numLayers = m_layers.size() - 1;
+    if (gradients_weights.size() != numLayers ||
+        gradients_biases.size() != numLayers) {
         throw std::runtime_error("Los gradientes no coinciden con la estructura de la red.");
     }
 
     // Recorremos todas las capas y actualizamos pesos y sesgos
-    for (size_t layerIndex = 0; layerIndex < m_weights.size(); ++layerIndex) {
-        for (size_t i = 0; i < m_weights[layerIndex].size(); ++i) {
-            m_weights[layerIndex][i] -= learningRate * gradients_weights[layerIndex][i];
-        }
-
-        for (size_t j = 0; j < m_biases[layerIndex].size(); ++j) {
-            m_biases[layerIndex][j] -= learningRate * gradients_biases[layerIndex][j];
-        }
+    for (size_t layerIndex = 0; layerIndex < numLayers; ++layerIndex) {
+        kernels::axpy(-learningRate, gradients_weights[layerIndex].data(),
+                      ownWeights(layerIndex), static_cast<size_t>(m_layers[layerIndex]) * m_layers[layerIndex + 1]);
+        kernels::axpy(-learningRate, gradients_biases[layerIndex].data(),
+                      ownBiases(layerIndex), m_layers[layerIndex + 1]);
     }
+    markParametersChanged();
 }
 
@@ -0,0 +1,65 @@
+#include "ParallelTrainer.h"
+#include "Kernels.h"
+#include <algorithm>
+
+ParallelTrainer::ParallelTrainer(NeuralNetwork& network, size_t numThreads,
+                                 const TrainerConfig& config)
+    : Trainer(network, config),
+      m_pool(numThreads),
+      m_replicas(m_pool.size(), network),
+      m_shardLoss(m_pool.size(), 0.0f)
+{
+}
+
+float ParallelTrainer::accumulate(const float* inputs, const float* targets,
+                                  const size_t* indices, size_t count, float* sampleLosses) {
+    const size_t numShards = m_replicas.size();
+
+    // 1️ Cada fragmento sincroniza su réplica y acumula su parte del lote
+    m_pool.parallelFor(numShards, [&](size_t shard) {
+        NeuralNetwork& replica = m_replicas[shard];
+        replica.setParameters(m_network.parameters());
+
+        const size_t begin = count * shard / numShards;
+        const size_t end = count * (shard + 1) / numShards;
+        float* gradients = replica.gradients();
+        float loss = 0.0f;
+        for (size_t k = begin; k < end; k++) {
+            size_t row = (indices != nullptr) ? indices[k] : k;
+            float sampleLoss = replica.accumulateGradients(inputs + row * m_inputSize,
+                                                           targets + row * m_outputSize,
+                                                           gradients);
+            // Cada fragmento escribe posiciones distintas de `sampleLosses`
+            if (sampleLosses != nullptr) {
+                sampleLosses[k] = sampleLoss;
+            }
+            loss += sampleLoss;
+        }
+        m_shardLoss[shard] = loss;
+    });
+
+    // 2️ Reducción en árbol: en cada nivel se suman pares independientes
+    for (size_t stride = 1; stride < numShards; stride *= 2) {
+        const size_t numPairs = (numShards + 2 * stride - 1) / (2 * stride);
+        m_pool.parallelFor(numPairs, [&](size_t pair) {
+            size_t dst = pair * 2 * stride;
+            size_t src = dst + stride;
+            if (src < numShards) {
+                kernels::axpy(1.0f, m_replicas[src].gradients(), m_replicas[dst].gradients(),
+                              m_parameterCount);
+            }
+        });
+    }
+
+    kernels::axpy(1.0f, m_replicas[0].gradients(), m_gradients, m_parameterCount);
+    for (NeuralNetwork& replica : m_replicas) {
+        std::fill(replica.gradients(), replica.gradients() + m_parameterCount, 0.0f);
+    }
+
+    // La pérdida se suma en orden de fragmento para que también sea determinista
+    float loss = 0.0f;
+    for (float shardLoss : m_shardLoss) {
+        loss += shardLoss;
+    }
+    return loss;
+}
@@ -0,0 +1,107 @@
+#include "ParameterStore.h"
+#include "NeuralNetwork.h"
+#include <stdexcept>
+
+ParameterStore::Snapshot::Snapshot(const ParameterStore* store, uint32_t slot)
+    : m_store(store),
+      m_slot(slot),
+      m_version(store->m_versions[slot]),
+      m_parameters(store->m_storage.data() + slot * store->m_parameterCount)
+{
+}
+
+ParameterStore::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : m_store(other.m_store),
+      m_slot(other.m_slot),
+      m_version(other.m_version),
+      m_parameters(other.m_parameters)
+{
+    other.m_store = nullptr;
+}
+
+ParameterStore::Snapshot& ParameterStore::Snapshot::operator=(Snapshot&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_store = other.m_store;
+        m_slot = other.m_slot;
+        m_version = other.m_version;
+        m_parameters = other.m_parameters;
+        other.m_store = nullptr;
+    }
+    return *this;
+}
+
+ParameterStore::Snapshot::~Snapshot() {
+    release();
+}
+
+void ParameterStore::Snapshot::release() {
+    if (m_store != nullptr) {
+        m_store->release(m_slot);
+        m_store = nullptr;
+    }
+}
+
+ParameterStore::ParameterStore(const NeuralNetwork& network)
+    : m_parameterCount(network.parameterCount()),
+      m_storage(SLOTS * network.parameterCount())
+{
+    for (int slot = 0; slot < SLOTS; slot++) {
+        m_versions[slot] = 0;
+        m_retiredReaders[slot].store(0, std::memory_order_relaxed);
+    }
+    network.copyParameters(m_storage.data());
+    m_current.store(0, std::memory_order_release);
+}
+
+ParameterStore::Snapshot ParameterStore::acquire() const {
+    // Una sola operación: lee la copia actual y se registra como lector suyo
+    uint32_t state = m_current.fetch_add(1, std::memory_order_acquire);
+    return Snapshot(this, state >> SLOT_SHIFT);
+}
+
+void ParameterStore::release(uint32_t slot) const {
+    // Si la copia sigue siendo la actual, el lector está contado en `m_current`
+    uint32_t state = m_current.load(std::memory_order_relaxed);
+    while ((state >> SLOT_SHIFT) == slot) {
+        if (m_current.compare_exchange_weak(state, state - 1, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    // Ya se retiró: su cuenta pasó (o pasará) a `m_retiredReaders`
+    m_retiredReaders[slot].fetch_sub(1, std::memory_order_release);
+}
+
+bool ParameterStore::publish(const NeuralNetwork& network) {
+    if (network.parameterCount() != m_parameterCount) {
+        throw std::runtime_error("La red no coincide con el almacén de parámetros.");
+    }
+
+    // Solo el publicador cambia la copia actual, así que esta lectura no caduca
+    const uint32_t current = m_current.load(std::memory_order_relaxed) >> SLOT_SHIFT;
+    int target = -1;
+    for (int slot = 0; slot < SLOTS && target < 0; slot++) {
+        if (static_cast<uint32_t>(slot) != current &&
+            m_retiredReaders[slot].load(std::memory_order_acquire) == 0) {
+            target = slot;
+        }
+    }
+    if (target < 0) {
+        return false;
+    }
+
+    network.copyParameters(m_storage.data() + target * m_parameterCount);
+    m_versions[target] = m_nextVersion++;
+
+    // Publicación: los lectores que adquirieron la copia anterior pasan a su contador
+    uint32_t previous = m_current.exchange(static_cast<uint32_t>(target) << SLOT_SHIFT,
+                                           std::memory_order_acq_rel);
+    m_retiredReaders[previous >> SLOT_SHIFT].fetch_add(static_cast<int32_t>(previous & COUNT_MASK),
+                                                       std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t ParameterStore::version() const {
+    return acquire().version();
+}
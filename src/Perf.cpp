@@ -0,0 +1,165 @@
+#include "Perf.h"
+
+#ifdef PERF_STATS
+
+#include <stdio.h>
+
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace {
+
+const int SUB_BUCKETS = 4;  // Cubetas por potencia de dos
+const int NUM_BUCKETS = 124;  // Hasta 2^32 ticks
+const int NUM_STAGES = static_cast<int>(Stage::COUNT);
+
+const char* const STAGE_NAMES[NUM_STAGES] = {
+    "sensado", "forward", "seleccion", "entrenamiento", "actuacion", "telemetria", "ciclo"
+};
+
+struct StageData {
+    uint32_t start;
+    uint32_t count;
+    uint32_t deadlineMisses;
+    uint32_t deadlineTicks;  // 0 = sin plazo
+    uint32_t minTicks;
+    uint32_t maxTicks;
+    uint64_t sumTicks;
+    uint32_t buckets[NUM_BUCKETS];
+};
+
+StageData g_stages[NUM_STAGES];
+
+#ifdef ESP_PLATFORM
+inline uint32_t nowTicks() {
+    return ESP.getCycleCount();
+}
+
+inline uint64_t ticksToNs(uint64_t ticks) {
+    return ticks * 1000 / ESP.getCpuFreqMHz();
+}
+
+inline uint32_t nsToTicks(uint64_t ns) {
+    uint64_t ticks = ns * ESP.getCpuFreqMHz() / 1000;
+    return ticks > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(ticks);
+}
+#else
+// En el PC un tick es un nanosegundo; 32 bits bastan para etapas de hasta 4.29 s
+inline uint32_t nowTicks() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint64_t ticksToNs(uint64_t ticks) {
+    return ticks;
+}
+
+inline uint32_t nsToTicks(uint64_t ns) {
+    return ns > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(ns);
+}
+#endif
+
+inline int bucketIndex(uint32_t ticks) {
+    if (ticks < SUB_BUCKETS) return static_cast<int>(ticks);
+    int msb = 31 - __builtin_clz(ticks);
+    return (msb - 1) * SUB_BUCKETS + static_cast<int>((ticks >> (msb - 2)) & (SUB_BUCKETS - 1));
+}
+
+uint64_t bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    int msb = index / SUB_BUCKETS + 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t width = 1ull << (msb - 2);
+    return (SUB_BUCKETS + sub) * width + width - 1;
+}
+
+uint64_t percentileTicks(const StageData& data, uint32_t rank) {
+    uint32_t seen = 0;
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+        seen += data.buckets[b];
+        if (seen >= rank) {
+            uint64_t bound = bucketUpperBound(b);
+            return bound < data.maxTicks ? bound : data.maxTicks;
+        }
+    }
+    return data.maxTicks;
+}
+
+} // namespace
+
+namespace perf {
+
+const char* stageName(Stage stage) {
+    return STAGE_NAMES[static_cast<int>(stage)];
+}
+
+void begin(Stage stage) {
+    g_stages[static_cast<int>(stage)].start = nowTicks();
+}
+
+void end(Stage stage) {
+    const uint32_t now = nowTicks();
+    StageData& data = g_stages[static_cast<int>(stage)];
+    const uint32_t ticks = now - data.start;  // Correcto aunque el contador desborde
+
+    if (data.count == 0 || ticks < data.minTicks) data.minTicks = ticks;
+    if (ticks > data.maxTicks) data.maxTicks = ticks;
+    data.count++;
+    data.sumTicks += ticks;
+    data.buckets[bucketIndex(ticks)]++;
+    if (data.deadlineTicks != 0 && ticks > data.deadlineTicks) data.deadlineMisses++;
+}
+
+void setDeadline(Stage stage, uint64_t ns) {
+    g_stages[static_cast<int>(stage)].deadlineTicks = nsToTicks(ns);
+}
+
+uint32_t count(Stage stage) {
+    return g_stages[static_cast<int>(stage)].count;
+}
+
+StageStats stats(Stage stage) {
+    const StageData& data = g_stages[static_cast<int>(stage)];
+    StageStats result = {};
+    result.count = data.count;
+    result.deadlineMisses = data.deadlineMisses;
+    if (data.count == 0) return result;
+
+    result.minNs = ticksToNs(data.minTicks);
+    result.maxNs = ticksToNs(data.maxTicks);
+    result.meanNs = ticksToNs(data.sumTicks / data.count);
+    result.p50Ns = ticksToNs(percentileTicks(data, (data.count + 1) / 2));
+    result.p99Ns = ticksToNs(percentileTicks(data, data.count - data.count / 100));
+    return result;
+}
+
+void reset() {
+    for (int s = 0; s < NUM_STAGES; s++) {
+        uint32_t deadline = g_stages[s].deadlineTicks;
+        g_stages[s] = StageData();
+        g_stages[s].deadlineTicks = deadline;
+    }
+}
+
+void dump(PerfWriter writer, void* context) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-14s %8s %10s %10s %10s %10s %8s\n", "etapa", "n",
+             "media(us)", "p50(us)", "p99(us)", "max(us)", "plazo");
+    writer(line, context);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        StageStats st = stats(static_cast<Stage>(s));
+        if (st.count == 0) continue;
+        snprintf(line, sizeof(line), "%-14s %8lu %10.3f %10.3f %10.3f %10.3f %8lu\n",
+                 STAGE_NAMES[s], static_cast<unsigned long>(st.count), st.meanNs / 1000.0,
+                 st.p50Ns / 1000.0, st.p99Ns / 1000.0, st.maxNs / 1000.0,
+                 static_cast<unsigned long>(st.deadlineMisses));
+        writer(line, context);
+    }
+}
+
+} // namespace perf
+
+#endif // PERF_STATS
@@ -0,0 +1,218 @@
+#include "Population.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+Population::Population(const std::vector<int>& layers, size_t size,
+                       ActivationFunction hiddenAct, ActivationFunction outputAct)
+    : m_layers(layers),
+      m_size(size),
+      m_parameterCount(0)
+{
+    if (m_layers.size() < 2) {
+        throw std::runtime_error("Se requieren al menos 2 capas (entrada y salida).");
+    }
+    if (size == 0) {
+        throw std::runtime_error("La población debe tener al menos una red.");
+    }
+
+    int maxWidth = 0;
+    for (size_t l = 0; l < m_layers.size(); l++) {
+        if (m_layers[l] <= 0) {
+            throw std::runtime_error("Las capas deben tener al menos una neurona.");
+        }
+        maxWidth = std::max(maxWidth, m_layers[l]);
+        if (l + 1 < m_layers.size()) {
+            m_parameterCount += static_cast<size_t>(m_layers[l]) * m_layers[l + 1] + m_layers[l + 1];
+        }
+    }
+
+    // Mismo valor inicial que `NeuralNetwork::initWeights`
+    m_parameters.assign(m_parameterCount * size, 0.1f);
+
+    const size_t numLayers = m_layers.size() - 1;
+    m_activations.assign(numLayers * size, hiddenAct);
+    std::fill(m_activations.begin() + (numLayers - 1) * size, m_activations.end(), outputAct);
+    m_uniformActivation.assign(numLayers, 1);
+
+    m_bufferA.assign(static_cast<size_t>(maxWidth) * size, 0.0f);
+    m_bufferB.assign(static_cast<size_t>(maxWidth) * size, 0.0f);
+    m_rowErrors.assign(size, 0.0f);
+}
+
+void Population::setMember(size_t k, const NeuralNetwork& network) {
+    if (network.getLayers() != m_layers) {
+        throw std::runtime_error("La topología de la red no coincide con la de la población.");
+    }
+    std::vector<float> parameters(m_parameterCount);
+    network.copyParameters(parameters.data());
+    setMemberParameters(k, parameters.data());
+    for (size_t l = 0; l + 1 < m_layers.size(); l++) {
+        setActivation(k, l, network.getActivation(l));
+    }
+}
+
+void Population::setMemberParameters(size_t k, const float* parameters) {
+    if (k >= m_size) {
+        throw std::runtime_error("Índice de red fuera de rango.");
+    }
+    float* destination = m_parameters.data() + k;
+    for (size_t p = 0; p < m_parameterCount; p++) {
+        destination[p * m_size] = parameters[p];
+    }
+}
+
+void Population::copyMemberParameters(size_t k, float* destination) const {
+    if (k >= m_size) {
+        throw std::runtime_error("Índice de red fuera de rango.");
+    }
+    const float* source = m_parameters.data() + k;
+    for (size_t p = 0; p < m_parameterCount; p++) {
+        destination[p] = source[p * m_size];
+    }
+}
+
+void Population::setActivation(size_t k, size_t layerIndex, ActivationFunction func) {
+    if (k >= m_size || layerIndex + 1 >= m_layers.size()) {
+        throw std::runtime_error("Índice de red o de capa fuera de rango.");
+    }
+    ActivationFunction* layer = m_activations.data() + layerIndex * m_size;
+    layer[k] = func;
+    m_uniformActivation[layerIndex] =
+        std::all_of(layer, layer + m_size, [&](ActivationFunction f) { return f == layer[0]; });
+}
+
+const float* Population::forwardRange(const float* input, size_t k0, size_t k1) {
+    const size_t K = m_size;
+    const size_t n = k1 - k0;
+    const float* layerParameters = m_parameters.data();
+    const float* in = nullptr;
+    float* out = m_bufferA.data();
+
+    for (size_t l = 0; l + 1 < m_layers.size(); l++) {
+        const int inSize = m_layers[l];
+        const int outSize = m_layers[l + 1];
+        const float* weights = layerParameters + k0;
+        const float* biases = weights + static_cast<size_t>(inSize) * outSize * K;
+
+        // Mismo orden que `denseLayer`: out = 0, out += in[i] * W[i][j], act(out + b)
+        for (int j = 0; j < outSize; j++) {
+            std::fill(out + j * K + k0, out + j * K + k1, 0.0f);
+        }
+        for (int i = 0; i < inSize; i++) {
+            const float* row = weights + static_cast<size_t>(i) * outSize * K;
+            for (int j = 0; j < outSize; j++) {
+                if (l == 0) {
+                    // La entrada es la misma para todas las redes
+                    kernels::axpy(input[i], row + j * K, out + j * K + k0, n);
+                } else {
+                    kernels::mulAdd(in + i * K + k0, row + j * K, out + j * K + k0, n);
+                }
+            }
+        }
+        for (int j = 0; j < outSize; j++) {
+            kernels::axpy(1.0f, biases + j * K, out + j * K + k0, n);
+        }
+
+        const ActivationFunction* activations = m_activations.data() + l * K;
+        if (m_uniformActivation[l]) {
+            for (int j = 0; j < outSize; j++) {
+                applyActivation(out + j * K + k0, static_cast<int>(n), activations[0], m_activationMode);
+            }
+        } else {
+            for (int j = 0; j < outSize; j++) {
+                float* z = out + j * K;
+                for (size_t k = k0; k < k1; k++) {
+                    z[k] = applyActivation(z[k], activations[k], m_activationMode);
+                }
+            }
+        }
+
+        layerParameters += (static_cast<size_t>(inSize) * outSize + outSize) * K;
+        in = out;
+        out = (out == m_bufferA.data()) ? m_bufferB.data() : m_bufferA.data();
+    }
+    return in;
+}
+
+void Population::forward(const float* input, float* outputs) {
+    const float* out = forwardRange(input, 0, m_size);
+    const size_t outSize = m_layers.back();
+    for (size_t j = 0; j < outSize; j++) {
+        for (size_t k = 0; k < m_size; k++) {
+            outputs[k * outSize + j] = out[j * m_size + k];
+        }
+    }
+}
+
+void Population::evaluateRange(const float* inputs, const float* targets, size_t numRows,
+                               ErrorFunction errorType, float* losses, size_t k0, size_t k1) {
+    const size_t K = m_size;
+    const size_t inSize = m_layers.front();
+    const size_t outSize = m_layers.back();
+    float* rowErrors = m_rowErrors.data();
+    std::fill(losses + k0, losses + k1, 0.0f);
+
+    for (size_t r = 0; r < numRows; r++) {
+        const float* out = forwardRange(inputs + r * inSize, k0, k1);
+        const float* target = targets + r * outSize;
+        std::fill(rowErrors + k0, rowErrors + k1, 0.0f);
+
+        // Mismas fórmulas que `calculateError`, salida a salida
+        for (size_t j = 0; j < outSize; j++) {
+            const float* o = out + j * K;
+            const float y = target[j];
+            switch (errorType) {
+                case ErrorFunction::MSE:
+                    for (size_t k = k0; k < k1; k++) {
+                        float error = o[k] - y;
+                        rowErrors[k] += error * error;
+                    }
+                    break;
+                case ErrorFunction::MAE:
+                    for (size_t k = k0; k < k1; k++) {
+                        rowErrors[k] += std::abs(o[k] - y);
+                    }
+                    break;
+                case ErrorFunction::CROSS_ENTROPY:
+                    for (size_t k = k0; k < k1; k++) {
+                        float p = std::min(std::max(o[k], 1e-9f), 1.0f - 1e-9f);
+                        rowErrors[k] -= y * std::log(p) + (1 - y) * std::log(1 - p);
+                    }
+                    break;
+            }
+        }
+        for (size_t k = k0; k < k1; k++) {
+            losses[k] += rowErrors[k] / outSize;
+        }
+    }
+
+    if (numRows > 0) {
+        for (size_t k = k0; k < k1; k++) {
+            losses[k] /= numRows;
+        }
+    }
+}
+
+void Population::evaluate(const float* inputs, const float* targets, size_t numRows,
+                          ErrorFunction errorType, float* losses, ThreadPool* pool) {
+    if (errorType != ErrorFunction::MSE && errorType != ErrorFunction::MAE &&
+        errorType != ErrorFunction::CROSS_ENTROPY) {
+        throw std::runtime_error("Tipo de función de error no reconocido.");
+    }
+
+    const size_t numBlocks = (m_size + kMemberBlock - 1) / kMemberBlock;
+    if (pool == nullptr || numBlocks == 1) {
+        evaluateRange(inputs, targets, numRows, errorType, losses, 0, m_size);
+        return;
+    }
+
+    // Cada bloque escribe solo sus columnas de los buffers intercalados
+    pool->parallelFor(numBlocks, [&](size_t block) {
+        const size_t k0 = block * kMemberBlock;
+        const size_t k1 = std::min(k0 + kMemberBlock, m_size);
+        evaluateRange(inputs, targets, numRows, errorType, losses, k0, k1);
+    });
+}
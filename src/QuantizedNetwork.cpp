@@ -0,0 +1,469 @@
+#include "QuantizedNetwork.h"
+#include "NeuralNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Satura un entero al rango simétrico int8 [-127, 127].
+ */
+static inline int8_t saturateInt8(int32_t x) {
+    return static_cast<int8_t>(std::min<int32_t>(127, std::max<int32_t>(-127, x)));
+}
+
+/**
+ * @brief Cuantiza un valor real a int8 con la escala dada (redondeo al más cercano).
+ */
+static inline int8_t quantizeValue(float x, float scale) {
+    float q = std::round(x / scale);
+    q = std::min(127.0f, std::max(-127.0f, q));
+    return static_cast<int8_t>(q);
+}
+
+/**
+ * @brief Multiplica el acumulador por mult * 2^(shift - 31) con redondeo.
+ */
+static inline int32_t requantize(int32_t acc, int32_t mult, int shift) {
+    int rshift = 31 - shift;
+    if (rshift > 62) {
+        return 0;
+    }
+    int64_t prod = static_cast<int64_t>(acc) * mult;
+    prod += static_cast<int64_t>(1) << (rshift - 1);
+    return static_cast<int32_t>(prod >> rshift);
+}
+
+/**
+ * @brief Descompone un multiplicador real m > 0 en mantisa Q31 y exponente:
+ *        m ~= mult * 2^(shift - 31).
+ */
+static void quantizeMultiplier(double m, int32_t& mult, int8_t& shift) {
+    if (m <= 0.0) {
+        mult = 0;
+        shift = 0;
+        return;
+    }
+    int exponent = 0;
+    double mantissa = std::frexp(m, &exponent); // m = mantissa * 2^exponent, mantissa en [0.5, 1)
+    int64_t q = std::llround(mantissa * static_cast<double>(1LL << 31));
+    if (q == (1LL << 31)) {
+        q /= 2;
+        exponent++;
+    }
+    if (exponent > 30) {
+        throw std::runtime_error("Multiplicador de cuantización fuera de rango.");
+    }
+    mult = static_cast<int32_t>(q);
+    shift = static_cast<int8_t>(std::max(exponent, -31));
+}
+
+/**
+ * @brief Escala int8 simétrica para un valor absoluto máximo.
+ */
+static inline float scaleFor(float maxAbs) {
+    return (maxAbs > 0.0f) ? maxAbs / 127.0f : 1.0f;
+}
+
+/**
+ * @brief Lleva escalas int8 distintas a una común `s_ref`: cada escala pasa a ser
+ *        exactamente `multipliers[i] * s_ref`, redondeando hacia arriba para que el
+ *        rango calibrado siga cabiendo en int8. Devuelve `s_ref`.
+ *
+ * Los multiplicadores se acotan para que sum |x_q * m * w_q| <= 2^29 y el
+ * acumulador int32 conserve margen para el sesgo.
+ * @param integerInverse Si es true y cabe, `s_ref` se agranda a `1 / K` con K entero
+ *        para que los enteros (p.ej. el -1 del HCSR04 sin eco) tengan código exacto.
+ */
+static float commonScale(std::vector<float>& scales, std::vector<int32_t>& multipliers,
+                         bool integerInverse) {
+    const int inSize = static_cast<int>(scales.size());
+    const int32_t maxMultiplier = std::max<int32_t>(1, (1 << 29) / (127 * 127 * inSize));
+    float referenceScale = *std::max_element(scales.begin(), scales.end()) / maxMultiplier;
+    if (integerInverse && referenceScale <= 1.0f) {
+        referenceScale = 1.0f / std::floor(1.0f / referenceScale);
+    }
+
+    multipliers.resize(inSize);
+    for (int i = 0; i < inSize; i++) {
+        double m = std::ceil(static_cast<double>(scales[i]) / referenceScale);
+        multipliers[i] = static_cast<int32_t>(std::min<double>(maxMultiplier, std::max(1.0, m)));
+        scales[i] = multipliers[i] * referenceScale;
+    }
+    return referenceScale;
+}
+
+// Búsqueda del techo de cada neurona oculta RELU/LINEAR (ver `fromNetwork`): se
+// prueban techos desde el máximo calibrado, cada uno 2^(-1/4) veces el anterior
+// (hasta 1/256 del máximo), y el elegido se sube `kClipHeadroomSteps` pasos.
+static const int kClipSteps = 32;
+static const float kClipStepsPerOctave = 4.0f;
+static const int kClipHeadroomSteps = 4;
+
+static inline float clipCandidate(float neuronMax, int step) {
+    return neuronMax * std::exp2(-static_cast<float>(step) / kClipStepsPerOctave);
+}
+
+/**
+ * @brief Propagación float de referencia para la calibración; la salida queda en
+ *        `activations`.
+ * @param clips Si no está vacío, la salida de cada neurona oculta se recorta a
+ *        [-clips[l][j], clips[l][j]], como hará la saturación int8.
+ * @param neuronMax Si no es nulo, acumula el valor absoluto máximo de cada neurona.
+ */
+static void referenceForward(const NeuralNetwork& network, const std::vector<float>& input,
+                             const std::vector<std::vector<float>>& clips,
+                             std::vector<std::vector<float>>* neuronMax,
+                             std::vector<float>& activations, std::vector<float>& newActivations) {
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size() - 1;
+
+    activations = input;
+    for (size_t l = 0; l < numLayers; l++) {
+        int inSize = layers[l];
+        int outSize = layers[l + 1];
+        const bool clipped = !clips.empty() && l + 1 < numLayers;
+        newActivations.assign(outSize, 0.0f);
+        for (int j = 0; j < outSize; j++) {
+            float sum = 0.0f;
+            for (int i = 0; i < inSize; i++) {
+                sum += activations[i] * network.weightsOf(l)[i * outSize + j];
+            }
+            float value = applyActivation(sum + network.biasesOf(l)[j], network.getActivation(l));
+            if (clipped) {
+                value = std::min(clips[l][j], std::max(-clips[l][j], value));
+            }
+            if (neuronMax != nullptr) {
+                (*neuronMax)[l][j] = std::max((*neuronMax)[l][j], std::fabs(value));
+            }
+            newActivations[j] = value;
+        }
+        activations.swap(newActivations);
+    }
+}
+
+QuantizedNetwork::QuantizedNetwork(const QuantizedModel& model)
+    : m_model(model)
+{
+    if (m_model.numLayers < 1 || m_model.layers == nullptr || m_model.inputScales == nullptr) {
+        throw std::runtime_error("Modelo cuantizado sin capas.");
+    }
+    initWorkspace();
+}
+
+void QuantizedNetwork::initWorkspace() {
+    int maxWidth = 0;
+    for (int l = 0; l < m_model.numLayers; l++) {
+        maxWidth = std::max(maxWidth, std::max(m_model.layers[l].inSize, m_model.layers[l].outSize));
+    }
+    m_input.assign(maxWidth, 0);
+    m_bufferA.assign(maxWidth, 0);
+    m_bufferB.assign(maxWidth, 0);
+}
+
+QuantizedNetwork QuantizedNetwork::fromNetwork(const NeuralNetwork& network,
+                                               const std::vector<std::vector<float>>& calibration,
+                                               QuantizationGranularity granularity) {
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size() - 1;
+
+    if (calibration.empty()) {
+        throw std::runtime_error("Se requiere al menos una muestra de calibración.");
+    }
+
+    // 1️ Calibración: rango máximo de cada entrada y de cada neurona
+    std::vector<float> inputMax(layers[0], 0.0f);
+    std::vector<std::vector<float>> neuronMax(numLayers);
+    for (size_t l = 0; l < numLayers; l++) {
+        neuronMax[l].assign(layers[l + 1], 0.0f);
+    }
+    std::vector<float> activations, newActivations;
+    std::vector<std::vector<float>> referenceOutputs;
+    const std::vector<std::vector<float>> noClips;
+
+    for (const std::vector<float>& sample : calibration) {
+        if (sample.size() != static_cast<size_t>(layers[0])) {
+            throw std::runtime_error("La muestra de calibración no coincide con la capa de entrada.");
+        }
+        for (size_t i = 0; i < sample.size(); i++) {
+            inputMax[i] = std::max(inputMax[i], std::fabs(sample[i]));
+        }
+        referenceForward(network, sample, noClips, &neuronMax, activations, newActivations);
+        referenceOutputs.push_back(activations);
+    }
+
+    float outputMax = 0.0f;
+    for (float value : neuronMax[numLayers - 1]) {
+        outputMax = std::max(outputMax, value);
+    }
+
+    // 2️ Rango int8 de las neuronas ocultas RELU/LINEAR: no el máximo calibrado, sino
+    // el menor techo que no empeora las salidas (más un margen, ver abajo). Una neurona que llega a cientos con el obstáculo lejos (cuando la salida ya
+    // está saturada) conserva así resolución para los valores pequeños, que son los
+    // que deciden la maniobra. Se recorta neurona a neurona manteniendo los techos
+    // ya elegidos, así que la tolerancia vale para todos a la vez. Cada techo debe
+    // cumplir dos condiciones sobre la calibración:
+    // - el recorte float no mueve ninguna salida más de medio paso int8 de su rango;
+    // - la red cuantizada con ese techo (ejecutando `forward`, con todos los
+    //   redondeos int8 de entrada, pesos, sesgos y reescalado) no tiene más error
+    //   que sin recortar esa neurona.
+    const float tolerance = 0.5f * scaleFor(outputMax);
+    std::vector<std::vector<float>> clips = neuronMax;
+    std::vector<float> output(layers.back());
+
+    auto clippingWithinTolerance = [&]() {
+        for (size_t s = 0; s < calibration.size(); s++) {
+            referenceForward(network, calibration[s], clips, nullptr, activations, newActivations);
+            for (size_t k = 0; k < activations.size(); k++) {
+                if (std::fabs(activations[k] - referenceOutputs[s][k]) > tolerance) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // Error absoluto máximo de la red cuantizada con `clips`
+    auto quantizedError = [&]() {
+        QuantizedNetwork candidate = quantize(network, inputMax, clips, outputMax, granularity);
+        float worst = 0.0f;
+        for (size_t s = 0; s < calibration.size(); s++) {
+            candidate.forward(calibration[s].data(), output.data());
+            for (size_t k = 0; k < output.size(); k++) {
+                worst = std::max(worst, std::fabs(output[k] - referenceOutputs[s][k]));
+            }
+        }
+        return worst;
+    };
+
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        ActivationFunction act = network.getActivation(l);
+        if (act != ActivationFunction::RELU && act != ActivationFunction::LINEAR) {
+            continue;
+        }
+        for (int j = 0; j < layers[l + 1]; j++) {
+            if (neuronMax[l][j] <= 0.0f) {
+                continue;
+            }
+            clips[l][j] = neuronMax[l][j];
+            const float unclippedError = quantizedError();
+            int chosen = 0;
+            for (int step = 1; step <= kClipSteps; step++) {
+                clips[l][j] = clipCandidate(neuronMax[l][j], step);
+                if (!clippingWithinTolerance()) {
+                    break;
+                }
+                if (quantizedError() <= unclippedError) {
+                    chosen = step;
+                }
+            }
+            // Una octava de margen: combinaciones de entradas que la calibración no
+            // cubre (p.ej. ambas duraciones largas a la vez) no llegan a saturar
+            clips[l][j] = clipCandidate(neuronMax[l][j], std::max(0, chosen - kClipHeadroomSteps));
+        }
+    }
+
+    return quantize(network, inputMax, clips, outputMax, granularity);
+}
+
+QuantizedNetwork QuantizedNetwork::quantize(const NeuralNetwork& network,
+                                            const std::vector<float>& inputMax,
+                                            const std::vector<std::vector<float>>& clips,
+                                            float outputMax,
+                                            QuantizationGranularity granularity) {
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size() - 1;
+
+    // 3️ Cuantización de pesos, sesgos y multiplicadores
+    QuantizedNetwork q;
+    q.m_ownedLayers.resize(numLayers);
+    q.m_ownedWeights.resize(numLayers);
+    q.m_ownedBiases.resize(numLayers);
+    q.m_ownedAccScales.resize(numLayers);
+    q.m_ownedMultipliers.resize(numLayers);
+    q.m_ownedShifts.resize(numLayers);
+    q.m_ownedInputMultipliers.resize(numLayers);
+
+    // Escala int8 de la entrada de cada capa, una por valor: cada sensor tiene la
+    // suya (distancias y duraciones tienen rangos muy distintos) y cada neurona
+    // oculta RELU/LINEAR la suya (unas llegan a cientos, otras no pasan de 1).
+    // SIGMOID/TANH están acotadas a [-1, 1]. No se multiplican dentro de los pesos:
+    // la escala por neurona de los pesos la fijaría el rango más grande. Cada capa
+    // reescala su entrada a una escala común con multiplicadores enteros.
+    std::vector<std::vector<float>> valueScales(numLayers);
+    valueScales[0].resize(layers[0]);
+    for (int i = 0; i < layers[0]; i++) {
+        valueScales[0][i] = scaleFor(inputMax[i]);
+    }
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        ActivationFunction act = network.getActivation(l);
+        const bool bounded = (act == ActivationFunction::SIGMOID || act == ActivationFunction::TANH);
+        // Las neuronas que nunca se activan usan la escala mayor para no forzar las demás
+        float largest = scaleFor(*std::max_element(clips[l].begin(), clips[l].end()));
+        valueScales[l + 1].resize(layers[l + 1]);
+        for (int j = 0; j < layers[l + 1]; j++) {
+            valueScales[l + 1][j] = bounded ? 1.0f / 127.0f
+                                  : (clips[l][j] > 0.0f) ? scaleFor(clips[l][j]) : largest;
+        }
+    }
+    std::vector<float> inScales(numLayers);
+    for (size_t l = 0; l < numLayers; l++) {
+        // La primera capa recibe la entrada float directamente en su escala común
+        // (ver `forward`): con `1 / s_in` entero, el -1 del HCSR04 es un código exacto
+        inScales[l] = commonScale(valueScales[l], q.m_ownedInputMultipliers[l], l == 0);
+    }
+    q.m_ownedInputScales = valueScales[0];
+    q.m_model.inputScales = q.m_ownedInputScales.data();
+
+    for (size_t l = 0; l < numLayers; l++) {
+        int inSize = layers[l];
+        int outSize = layers[l + 1];
+        ActivationFunction act = network.getActivation(l);
+        const float* layerWeights = network.weightsOf(l);
+
+        // Escala de los pesos por neurona (o una común para toda la capa)
+        std::vector<float> weightMax(outSize, 0.0f);
+        for (int i = 0; i < inSize; i++) {
+            for (int j = 0; j < outSize; j++) {
+                weightMax[j] = std::max(weightMax[j], std::fabs(layerWeights[i * outSize + j]));
+            }
+        }
+        if (granularity == QuantizationGranularity::PER_LAYER) {
+            float layerWeightMax = *std::max_element(weightMax.begin(), weightMax.end());
+            std::fill(weightMax.begin(), weightMax.end(), layerWeightMax);
+        }
+
+        // Escala de la salida de cada neurona: la de la entrada de la capa siguiente
+        const bool isOutput = (l == numLayers - 1);
+        const std::vector<float>* outScales = isOutput ? nullptr : &valueScales[l + 1];
+
+        std::vector<int8_t>& qWeights = q.m_ownedWeights[l];
+        std::vector<int32_t>& qBiases = q.m_ownedBiases[l];
+        std::vector<float>& accScales = q.m_ownedAccScales[l];
+        std::vector<int32_t>& multipliers = q.m_ownedMultipliers[l];
+        std::vector<int8_t>& shifts = q.m_ownedShifts[l];
+        // Solo se guardan los arreglos que `forward` usa para esta capa:
+        // punto fijo (RELU/LINEAR ocultas) o escala float (salida y SIGMOID/TANH)
+        const bool fixedPoint = (l < numLayers - 1) &&
+                                (act == ActivationFunction::RELU || act == ActivationFunction::LINEAR);
+        qWeights.resize(inSize * outSize);
+        qBiases.resize(outSize);
+        accScales.resize(fixedPoint ? 0 : outSize);
+        multipliers.resize(fixedPoint ? outSize : 0);
+        shifts.resize(fixedPoint ? outSize : 0);
+
+        for (int j = 0; j < outSize; j++) {
+            float weightScale = scaleFor(weightMax[j]);
+            for (int i = 0; i < inSize; i++) {
+                qWeights[i * outSize + j] = quantizeValue(layerWeights[i * outSize + j], weightScale);
+            }
+            float accScale = inScales[l] * weightScale;
+
+            double qBias = std::round(static_cast<double>(network.biasesOf(l)[j]) / accScale);
+            qBias = std::min<double>(INT32_MAX, std::max<double>(-INT32_MAX, qBias));
+            qBiases[j] = static_cast<int32_t>(qBias);
+
+            if (fixedPoint) {
+                quantizeMultiplier(static_cast<double>(accScale) / (*outScales)[j], multipliers[j], shifts[j]);
+            } else {
+                accScales[j] = accScale;
+            }
+        }
+
+        QuantizedLayer& layer = q.m_ownedLayers[l];
+        layer.inSize = inSize;
+        layer.outSize = outSize;
+        layer.activation = act;
+        layer.weights = qWeights.data();
+        layer.biases = qBiases.data();
+        layer.accScales = fixedPoint ? nullptr : accScales.data();
+        layer.multipliers = fixedPoint ? multipliers.data() : nullptr;
+        layer.shifts = fixedPoint ? shifts.data() : nullptr;
+        layer.inputMultipliers = q.m_ownedInputMultipliers[l].data();
+        layer.outScale = isOutput ? scaleFor(outputMax)
+                                  : *std::max_element(outScales->begin(), outScales->end());
+    }
+
+    q.m_model.numLayers = static_cast<int>(numLayers);
+    q.m_model.layers = q.m_ownedLayers.data();
+    q.initWorkspace();
+    return q;
+}
+
+void QuantizedNetwork::forward(const float* input, float* output) {
+    const QuantizedLayer* layers = m_model.layers;
+    const int numLayers = m_model.numLayers;
+
+    // La entrada float se cuantiza directamente a la escala común de la primera
+    // capa, `s_in = inputScales[i] / inputMultipliers[i]`, sin pasar por int8: el
+    // código de cada entrada se satura a su rango calibrado, ±127 veces su
+    // multiplicador, así que el acumulador conserva la misma cota
+    for (int i = 0; i < layers[0].inSize; i++) {
+        const float multiplier = static_cast<float>(layers[0].inputMultipliers[i]);
+        const float limit = 127.0f * multiplier;
+        float code = std::round(input[i] * (multiplier / m_model.inputScales[i]));
+        m_input[i] = static_cast<int32_t>(std::min(limit, std::max(-limit, code)));
+    }
+
+    const int8_t* activations = m_bufferB.data();
+    for (int l = 0; l < numLayers; l++) {
+        const QuantizedLayer& layer = layers[l];
+        const bool isOutput = (l == numLayers - 1);
+        int8_t* newActivations = (activations == m_bufferA.data()) ? m_bufferB.data() : m_bufferA.data();
+
+        // En las demás capas cada entrada int8 pasa a la escala común de la capa
+        for (int i = 0; l > 0 && i < layer.inSize; i++) {
+            m_input[i] = static_cast<int32_t>(activations[i]) * layer.inputMultipliers[i];
+        }
+
+        for (int j = 0; j < layer.outSize; j++) {
+            int32_t acc = layer.biases[j];
+            for (int i = 0; i < layer.inSize; i++) {
+                acc += m_input[i] * layer.weights[i * layer.outSize + j];
+            }
+
+            if (isOutput) {
+                // Última capa: activación en float sobre el valor real del acumulador
+                output[j] = applyActivation(acc * layer.accScales[j], layer.activation);
+                continue;
+            }
+
+            switch (layer.activation) {
+                case ActivationFunction::RELU:
+                    newActivations[j] = saturateInt8(std::max<int32_t>(0, requantize(acc, layer.multipliers[j], layer.shifts[j])));
+                    break;
+                case ActivationFunction::LINEAR:
+                    newActivations[j] = saturateInt8(requantize(acc, layer.multipliers[j], layer.shifts[j]));
+                    break;
+                default:
+                    newActivations[j] = quantizeValue(applyActivation(acc * layer.accScales[j], layer.activation),
+                                                      layer.outScale);
+                    break;
+            }
+        }
+
+        activations = newActivations;
+    }
+}
+
+std::vector<float> QuantizedNetwork::forward(const std::vector<float>& input) {
+    if (input.size() != static_cast<size_t>(inputSize())) {
+        throw std::runtime_error("El vector de entrada no coincide con la capa de entrada.");
+    }
+    std::vector<float> output(outputSize());
+    forward(input.data(), output.data());
+    return output;
+}
+
+size_t QuantizedNetwork::parameterBytes() const {
+    size_t bytes = m_model.layers[0].inSize * sizeof(float);
+    for (int l = 0; l < m_model.numLayers; l++) {
+        const QuantizedLayer& layer = m_model.layers[l];
+        bytes += layer.inSize * layer.outSize * sizeof(int8_t);
+        bytes += layer.inSize * sizeof(int32_t);
+        bytes += layer.outSize * sizeof(int32_t);
+        if (layer.accScales != nullptr)   bytes += layer.outSize * sizeof(float);
+        if (layer.multipliers != nullptr) bytes += layer.outSize * sizeof(int32_t);
+        if (layer.shifts != nullptr)      bytes += layer.outSize * sizeof(int8_t);
+    }
+    return bytes;
+}
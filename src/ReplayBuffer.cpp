@@ -0,0 +1,144 @@
+#include "ReplayBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+// Prioridad mínima: una muestra con pérdida 0 debe poder volver a salir
+static const float PRIORITY_EPSILON = 1e-4f;
+
+/**
+ * @brief Generador xorshift32, igual que el del barajado de `Trainer`.
+ */
+static inline uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+size_t ReplayBuffer::bytesFor(size_t capacity, size_t inputSize, size_t targetSize,
+                              size_t maxBatch, ReplaySampling sampling) {
+    size_t bytes = maxBatch * sizeof(size_t);
+    bytes += capacity * (inputSize + targetSize) * sizeof(float);
+    if (sampling == ReplaySampling::PRIORITIZED) {
+        bytes += 2 * capacity * sizeof(float);
+    }
+    return bytes;
+}
+
+size_t ReplayBuffer::capacityFor(size_t inputSize, size_t targetSize, size_t budgetBytes,
+                                 size_t maxBatch, ReplaySampling sampling) {
+    const size_t fixed = bytesFor(0, inputSize, targetSize, maxBatch, sampling);
+    const size_t perSample = bytesFor(1, inputSize, targetSize, 0, sampling);
+    return (budgetBytes > fixed) ? (budgetBytes - fixed) / perSample : 0;
+}
+
+ReplayBuffer::ReplayBuffer(size_t inputSize, size_t targetSize, size_t budgetBytes, size_t maxBatch,
+                           ReplaySampling sampling, float alpha, uint32_t seed)
+    : m_inputSize(inputSize),
+      m_targetSize(targetSize),
+      m_capacity(capacityFor(inputSize, targetSize, budgetBytes, maxBatch, sampling)),
+      m_maxBatch(maxBatch),
+      m_sampling(sampling),
+      m_alpha(alpha),
+      m_rngState(seed != 0 ? seed : 0x9E3779B9u)
+{
+    if (inputSize == 0 || targetSize == 0 || maxBatch == 0) {
+        throw std::runtime_error("Dimensiones del búfer de experiencias no válidas.");
+    }
+    if (m_capacity == 0) {
+        throw std::runtime_error("El presupuesto de memoria no admite ninguna muestra.");
+    }
+
+    // Los índices (size_t) van primero para que todo quede alineado
+    m_arena.assign(bytesFor(m_capacity, inputSize, targetSize, maxBatch, sampling), 0);
+    uint8_t* cursor = m_arena.data();
+    m_batchIndices = reinterpret_cast<size_t*>(cursor);
+    cursor += maxBatch * sizeof(size_t);
+    m_inputs = reinterpret_cast<float*>(cursor);
+    cursor += m_capacity * inputSize * sizeof(float);
+    m_targets = reinterpret_cast<float*>(cursor);
+    cursor += m_capacity * targetSize * sizeof(float);
+    if (sampling == ReplaySampling::PRIORITIZED) {
+        m_tree = reinterpret_cast<float*>(cursor);
+    }
+}
+
+void ReplayBuffer::setPriority(size_t slot, float loss) {
+    float priority = std::pow(std::fabs(loss) + PRIORITY_EPSILON, m_alpha);
+    if (!std::isfinite(priority)) {
+        priority = 1.0f;
+    }
+
+    // Los nodos internos se recalculan desde sus hijos (sin acumular errores de
+    // redondeo con sumas y restas de diferencias)
+    size_t node = m_capacity + slot;
+    m_tree[node] = priority;
+    for (node /= 2; node >= 1; node /= 2) {
+        m_tree[node] = m_tree[2 * node] + m_tree[2 * node + 1];
+    }
+}
+
+size_t ReplayBuffer::push(const float* input, const float* target, float loss) {
+    const size_t slot = m_next;
+    std::memcpy(m_inputs + slot * m_inputSize, input, m_inputSize * sizeof(float));
+    std::memcpy(m_targets + slot * m_targetSize, target, m_targetSize * sizeof(float));
+    if (m_tree != nullptr) {
+        setPriority(slot, loss);
+    }
+
+    m_next = (m_next + 1 == m_capacity) ? 0 : m_next + 1;
+    m_size = std::min(m_size + 1, m_capacity);
+    return slot;
+}
+
+size_t ReplayBuffer::samplePrioritized() {
+    // Valor uniforme en [0, total) y descenso por el árbol
+    float u = (nextRandom(m_rngState) >> 8) * (1.0f / 16777216.0f) * m_tree[1];
+    size_t node = 1;
+    while (node < m_capacity) {
+        const float left = m_tree[2 * node];
+        // Por redondeo `u` puede superar la suma: nunca se baja a una rama vacía
+        if (u < left || m_tree[2 * node + 1] <= 0.0f) {
+            node = 2 * node;
+        } else {
+            u -= left;
+            node = 2 * node + 1;
+        }
+    }
+    return node - m_capacity;
+}
+
+ReplayBatch ReplayBuffer::sample(size_t count) {
+    // Con reemplazo: el lote puede tener más filas que muestras guardadas
+    count = (m_size == 0) ? 0 : std::min(count, m_maxBatch);
+    for (size_t k = 0; k < count; k++) {
+        m_batchIndices[k] = (m_tree != nullptr) ? samplePrioritized()
+                                                : nextRandom(m_rngState) % m_size;
+    }
+
+    ReplayBatch batch;
+    batch.inputs = m_inputs;
+    batch.targets = m_targets;
+    batch.indices = m_batchIndices;
+    batch.count = count;
+    return batch;
+}
+
+void ReplayBuffer::updatePriorities(const ReplayBatch& batch, const float* losses) {
+    if (m_tree == nullptr) {
+        return;
+    }
+    for (size_t k = 0; k < batch.count; k++) {
+        setPriority(batch.indices[k], losses[k]);
+    }
+}
+
+void ReplayBuffer::clear() {
+    m_size = 0;
+    m_next = 0;
+    if (m_tree != nullptr) {
+        std::fill(m_tree, m_tree + 2 * m_capacity, 0.0f);
+    }
+}
@@ -0,0 +1,200 @@
+#include "Scheduler.h"
+
+#include <limits.h>
+#include <stdio.h>
+
+namespace {
+
+// Comparación de instantes de `micros()` válida aunque el contador dé la vuelta
+bool reached(unsigned long now, unsigned long instant) {
+    return static_cast<long>(now - instant) >= 0;
+}
+
+} // namespace
+
+int Scheduler::add(const char* name, TaskFunction function, void* context, const TaskConfig& config) {
+    if (m_count == MAX_TASKS) return -1;
+
+    Task& task = m_tasks[m_count];
+    task.name = name;
+    task.function = function;
+    task.context = context;
+    task.config = config;
+    task.pending = false;
+    task.deferred = false;
+    task.release = 0;
+    task.nextRelease = 0;
+    task.expectedRunUs = config.budgetUs;
+    m_count++;
+    resetStats();
+    return m_count - 1;
+}
+
+void Scheduler::begin() {
+    unsigned long now = micros();
+    for (int i = 0; i < m_count; ++i) {
+        m_tasks[i].pending = false;
+        m_tasks[i].nextRelease = now;
+    }
+}
+
+void Scheduler::trigger(int task) {
+    if (task < 0 || task >= m_count) return;
+    Task& t = m_tasks[task];
+    if (t.pending) {
+        t.skipped++;
+        return;
+    }
+    t.pending = true;
+    t.deferred = false;
+    t.release = micros();
+}
+
+void Scheduler::releaseDue(unsigned long now) {
+    for (int i = 0; i < m_count; ++i) {
+        Task& t = m_tasks[i];
+        if (t.config.periodUs == 0 || !reached(now, t.nextRelease)) continue;
+
+        // Si se perdieron periodos enteros, queda activada la activación más reciente
+        unsigned long missed = (now - t.nextRelease) / t.config.periodUs;
+        unsigned long due = t.nextRelease + missed * t.config.periodUs;
+        t.nextRelease = due + t.config.periodUs;
+        t.skipped += missed;
+
+        if (t.pending) {
+            t.skipped++;
+        } else {
+            t.pending = true;
+            t.deferred = false;
+            t.release = due;
+        }
+    }
+}
+
+bool Scheduler::fitsInSlack(const Task& task, unsigned long now) const {
+    for (int i = 0; i < m_count; ++i) {
+        const Task& other = m_tasks[i];
+        if (&other == &task || other.config.background || other.config.periodUs == 0 ||
+            other.config.priority <= task.config.priority) {
+            continue;
+        }
+        if (other.pending) return false;
+        unsigned long slack = reached(now, other.nextRelease) ? 0 : other.nextRelease - now;
+        if (slack < task.expectedRunUs) return false;
+    }
+    return true;
+}
+
+bool Scheduler::runOnce() {
+    unsigned long now = micros();
+    releaseDue(now);
+
+    int best = -1;
+    for (int i = 0; i < m_count; ++i) {
+        Task& t = m_tasks[i];
+        if (!t.pending) continue;
+        bool overdue = t.config.maxWaitUs > 0 && reached(now, t.release + t.config.maxWaitUs);
+        if (t.config.background && !overdue && !fitsInSlack(t, now)) {
+            if (!t.deferred) {
+                t.deferred = true;
+                t.deferredCount++;
+            }
+            continue;
+        }
+        if (best < 0 || t.config.priority > m_tasks[best].config.priority ||
+            (t.config.priority == m_tasks[best].config.priority &&
+             static_cast<long>(t.release - m_tasks[best].release) < 0)) {
+            best = i;
+        }
+    }
+    if (best < 0) return false;
+
+    // La tarea puede volver a activarse a sí misma mientras se ejecuta
+    Task& t = m_tasks[best];
+    unsigned long release = t.release;
+    if (t.config.background && !fitsInSlack(t, now)) t.forced++;
+    t.pending = false;
+    unsigned long start = micros();
+    t.function(t.context);
+    unsigned long end = micros();
+
+    unsigned long latency = start - release;
+    unsigned long run = end - start;
+    t.runs++;
+    t.latencySumUs += latency;
+    if (latency < t.minLatencyUs) t.minLatencyUs = latency;
+    if (latency > t.maxLatencyUs) t.maxLatencyUs = latency;
+    t.runSumUs += run;
+    if (run > t.maxRunUs) t.maxRunUs = run;
+    // La previsión baja despacio: una sola ejecución corta no la deja en el caso
+    // bueno, pero una larga (p.ej. borrar un sector) tampoco la fija para siempre
+    if (run >= t.expectedRunUs) {
+        t.expectedRunUs = run;
+    } else {
+        t.expectedRunUs -= (t.expectedRunUs - run + 3) / 4;
+    }
+    if (t.config.deadlineUs > 0 && end - release > t.config.deadlineUs) t.deadlineMisses++;
+    return true;
+}
+
+unsigned long Scheduler::timeToNextRelease() const {
+    unsigned long now = micros();
+    unsigned long wait = ULONG_MAX;
+    for (int i = 0; i < m_count; ++i) {
+        const Task& t = m_tasks[i];
+        if (t.config.periodUs == 0) continue;
+        if (reached(now, t.nextRelease)) return 0;
+        if (t.nextRelease - now < wait) wait = t.nextRelease - now;
+    }
+    return wait;
+}
+
+TaskStats Scheduler::stats(int task) const {
+    const Task& t = m_tasks[task];
+    TaskStats s;
+    s.runs = t.runs;
+    s.deadlineMisses = t.deadlineMisses;
+    s.skipped = t.skipped;
+    s.deferred = t.deferredCount;
+    s.forced = t.forced;
+    s.meanLatencyUs = t.runs ? static_cast<unsigned long>(t.latencySumUs / t.runs) : 0;
+    s.maxLatencyUs = t.maxLatencyUs;
+    s.jitterUs = t.runs ? t.maxLatencyUs - t.minLatencyUs : 0;
+    s.meanRunUs = t.runs ? static_cast<unsigned long>(t.runSumUs / t.runs) : 0;
+    s.maxRunUs = t.maxRunUs;
+    return s;
+}
+
+void Scheduler::resetStats() {
+    for (int i = 0; i < m_count; ++i) {
+        Task& t = m_tasks[i];
+        t.runs = 0;
+        t.deadlineMisses = 0;
+        t.skipped = 0;
+        t.deferredCount = 0;
+        t.forced = 0;
+        t.latencySumUs = 0;
+        t.minLatencyUs = ULONG_MAX;
+        t.maxLatencyUs = 0;
+        t.runSumUs = 0;
+        t.maxRunUs = 0;
+    }
+}
+
+void Scheduler::dump(SchedulerWriter writer, void* context) const {
+    char line[128];
+    snprintf(line, sizeof(line), "%-16s %8s %10s %10s %10s %10s %10s %6s %8s %9s %9s\n", "tarea",
+             "n", "lat.(us)", "max(us)", "jitter", "dur.(us)", "max(us)", "plazo", "saltadas",
+             "aplazadas", "forzadas");
+    writer(line, context);
+    for (int i = 0; i < m_count; ++i) {
+        TaskStats s = stats(i);
+        snprintf(line, sizeof(line),
+                 "%-16s %8lu %10lu %10lu %10lu %10lu %10lu %6lu %8lu %9lu %9lu\n",
+                 m_tasks[i].name, static_cast<unsigned long>(s.runs), s.meanLatencyUs,
+                 s.maxLatencyUs, s.jitterUs, s.meanRunUs, s.maxRunUs,
+                 static_cast<unsigned long>(s.deadlineMisses), static_cast<unsigned long>(s.skipped),
+                 static_cast<unsigned long>(s.deferred), static_cast<unsigned long>(s.forced));
+        writer(line, context);
+    }
+}
@@ -0,0 +1,251 @@
+#include "SparseNetwork.h"
+#include "NeuralNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+SparseNetwork::SparseNetwork(const SparseModel& model)
+    : m_model(model)
+{
+    if (m_model.numLayers < 1 || m_model.layers == nullptr) {
+        throw std::runtime_error("Modelo disperso sin capas.");
+    }
+    initWorkspace();
+}
+
+void SparseNetwork::initWorkspace() {
+    int maxWidth = 0;
+    for (int l = 0; l < m_model.numLayers; l++) {
+        maxWidth = std::max(maxWidth, m_model.layers[l].outSize);
+    }
+    m_bufferA.assign(maxWidth, 0.0f);
+    m_bufferB.assign(maxWidth, 0.0f);
+}
+
+SparseNetwork SparseNetwork::fromNetwork(const NeuralNetwork& network, float threshold) {
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size() - 1;
+    const ActivationMode mode = network.getActivationMode();
+
+    // 1️ Copia densa con la poda aplicada
+    std::vector<std::vector<float>> weights(numLayers);
+    std::vector<std::vector<float>> biases(numLayers);
+    for (size_t l = 0; l < numLayers; l++) {
+        weights[l].assign(network.weightsOf(l), network.weightsOf(l) + layers[l] * layers[l + 1]);
+        biases[l].assign(network.biasesOf(l), network.biasesOf(l) + layers[l + 1]);
+        for (float& w : weights[l]) {
+            if (std::fabs(w) <= threshold) {
+                w = 0.0f;
+            }
+        }
+    }
+
+    // alive[l][j]: la neurona j de la capa l (0 = entradas) se conserva
+    std::vector<std::vector<char>> alive(layers.size());
+    for (size_t l = 0; l < layers.size(); l++) {
+        alive[l].assign(layers[l], 1);
+    }
+
+    // 2️ Neuronas ocultas sin pesos de entrada: su salida es la constante act(b_j),
+    //    que se incorpora a los sesgos de la capa siguiente
+    for (size_t l = 0; l + 1 < numLayers; l++) {
+        const int inSize = layers[l];
+        const int outSize = layers[l + 1];
+        const int nextSize = layers[l + 2];
+        for (int j = 0; j < outSize; j++) {
+            bool hasInput = false;
+            for (int i = 0; i < inSize && !hasInput; i++) {
+                hasInput = alive[l][i] && weights[l][i * outSize + j] != 0.0f;
+            }
+            if (hasInput) {
+                continue;
+            }
+            float constant = applyActivation(biases[l][j], network.getActivation(l), mode);
+            if (constant != 0.0f) {
+                for (int k = 0; k < nextSize; k++) {
+                    biases[l + 1][k] += constant * weights[l + 1][j * nextSize + k];
+                }
+            }
+            alive[l + 1][j] = 0;
+        }
+    }
+
+    // 3️ Neuronas ocultas sin pesos de salida hacia neuronas vivas: no influyen en
+    //    nada. Se recorre hacia atrás para que la eliminación se propague
+    for (size_t l = numLayers - 1; l >= 1; l--) {
+        const int size = layers[l];
+        const int nextSize = layers[l + 1];
+        for (int j = 0; j < size; j++) {
+            bool hasOutput = false;
+            for (int k = 0; k < nextSize && !hasOutput; k++) {
+                hasOutput = alive[l + 1][k] && weights[l][j * nextSize + k] != 0.0f;
+            }
+            if (!hasOutput) {
+                alive[l][j] = 0;
+            }
+        }
+    }
+
+    // 4️ Compactación a CSR con los índices de las neuronas que quedan
+    SparseNetwork s;
+    s.m_activationMode = mode;
+    s.m_ownedLayers.resize(numLayers);
+    s.m_ownedRowStart.resize(numLayers);
+    s.m_ownedColumns.resize(numLayers);
+    s.m_ownedValues.resize(numLayers);
+    s.m_ownedBiases.resize(numLayers);
+
+    for (size_t l = 0; l < numLayers; l++) {
+        const int denseOut = layers[l + 1];
+        std::vector<int> columnOf(denseOut, -1);
+        int outSize = 0;
+        for (int j = 0; j < denseOut; j++) {
+            if (alive[l + 1][j]) {
+                columnOf[j] = outSize++;
+            }
+        }
+        if (outSize > UINT16_MAX + 1) {
+            throw std::runtime_error("Capa demasiado ancha para el formato disperso.");
+        }
+
+        std::vector<uint32_t>& rowStart = s.m_ownedRowStart[l];
+        std::vector<uint16_t>& columns = s.m_ownedColumns[l];
+        std::vector<float>& values = s.m_ownedValues[l];
+        std::vector<float>& layerBiases = s.m_ownedBiases[l];
+
+        rowStart.push_back(0);
+        for (int i = 0; i < layers[l]; i++) {
+            if (!alive[l][i]) {
+                continue;
+            }
+            for (int j = 0; j < denseOut; j++) {
+                float w = weights[l][i * denseOut + j];
+                if (columnOf[j] >= 0 && w != 0.0f) {
+                    columns.push_back(static_cast<uint16_t>(columnOf[j]));
+                    values.push_back(w);
+                }
+            }
+            rowStart.push_back(static_cast<uint32_t>(values.size()));
+        }
+        for (int j = 0; j < denseOut; j++) {
+            if (columnOf[j] >= 0) {
+                layerBiases.push_back(biases[l][j]);
+            }
+        }
+
+        SparseLayer& layer = s.m_ownedLayers[l];
+        layer.inSize = static_cast<int>(rowStart.size()) - 1;
+        layer.outSize = outSize;
+        layer.activation = network.getActivation(l);
+        layer.rowStart = rowStart.data();
+        layer.columns = columns.data();
+        layer.values = values.data();
+        layer.biases = layerBiases.data();
+    }
+
+    s.m_model.numLayers = static_cast<int>(numLayers);
+    s.m_model.layers = s.m_ownedLayers.data();
+    s.initWorkspace();
+    return s;
+}
+
+void SparseNetwork::forward(const float* input, float* output) {
+    const SparseLayer* layers = m_model.layers;
+    const int numLayers = m_model.numLayers;
+    const float* activations = input;
+
+    for (int l = 0; l < numLayers; l++) {
+        const SparseLayer& layer = layers[l];
+        float* out = (l == numLayers - 1) ? output
+                   : (activations == m_bufferA.data()) ? m_bufferB.data() : m_bufferA.data();
+
+        for (int j = 0; j < layer.outSize; j++) {
+            out[j] = 0.0f;
+        }
+        // Cada salida se acumula en el mismo orden de entradas que la capa densa
+        for (int i = 0; i < layer.inSize; i++) {
+            const float x = activations[i];
+            if (x == 0.0f) {
+                continue;
+            }
+            for (uint32_t k = layer.rowStart[i]; k < layer.rowStart[i + 1]; k++) {
+                out[layer.columns[k]] += x * layer.values[k];
+            }
+        }
+        for (int j = 0; j < layer.outSize; j++) {
+            out[j] += layer.biases[j];
+        }
+        applyActivation(out, layer.outSize, layer.activation, m_activationMode);
+
+        activations = out;
+    }
+}
+
+std::vector<float> SparseNetwork::forward(const std::vector<float>& input) {
+    if (input.size() != static_cast<size_t>(inputSize())) {
+        throw std::runtime_error("El vector de entrada no coincide con la capa de entrada.");
+    }
+    std::vector<float> output(outputSize());
+    forward(input.data(), output.data());
+    return output;
+}
+
+size_t SparseNetwork::nonZeros() const {
+    size_t count = 0;
+    for (int l = 0; l < m_model.numLayers; l++) {
+        const SparseLayer& layer = m_model.layers[l];
+        count += layer.rowStart[layer.inSize];
+    }
+    return count;
+}
+
+size_t SparseNetwork::parameterBytes() const {
+    size_t bytes = 0;
+    for (int l = 0; l < m_model.numLayers; l++) {
+        const SparseLayer& layer = m_model.layers[l];
+        const size_t nnz = layer.rowStart[layer.inSize];
+        bytes += (layer.inSize + 1) * sizeof(uint32_t);
+        bytes += nnz * (sizeof(uint16_t) + sizeof(float));
+        bytes += layer.outSize * sizeof(float);
+    }
+    return bytes;
+}
+
+size_t pruneByMagnitude(NeuralNetwork& network, float sparsity) {
+    if (sparsity < 0.0f || sparsity > 1.0f) {
+        throw std::runtime_error("La fracción de poda debe estar en [0, 1].");
+    }
+
+    const std::vector<int>& layers = network.getLayers();
+    const size_t numLayers = layers.size() - 1;
+    std::vector<std::vector<float>> weights(numLayers);
+    std::vector<std::vector<float>> biases(numLayers);
+    size_t zeros = 0;
+
+    for (size_t l = 0; l < numLayers; l++) {
+        const size_t count = static_cast<size_t>(layers[l]) * layers[l + 1];
+        weights[l].assign(network.weightsOf(l), network.weightsOf(l) + count);
+        biases[l].assign(network.biasesOf(l), network.biasesOf(l) + layers[l + 1]);
+
+        // Se anulan exactamente los `pruned` pesos de menor magnitud (los empates en
+        // el umbral se resuelven por posición para respetar la fracción pedida)
+        const size_t pruned = static_cast<size_t>(std::floor(sparsity * count + 0.5f));
+        std::vector<size_t> order(count);
+        for (size_t k = 0; k < count; k++) {
+            order[k] = k;
+        }
+        std::nth_element(order.begin(), order.begin() + pruned, order.end(),
+                         [&](size_t a, size_t b) {
+                             float ma = std::fabs(weights[l][a]);
+                             float mb = std::fabs(weights[l][b]);
+                             return ma < mb || (ma == mb && a < b);
+                         });
+        for (size_t k = 0; k < pruned; k++) {
+            weights[l][order[k]] = 0.0f;
+        }
+        zeros += std::count(weights[l].begin(), weights[l].end(), 0.0f);
+    }
+
+    network.setWeights(weights, biases);
+    return zeros;
+}
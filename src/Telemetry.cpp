@@ -0,0 +1,68 @@
+#include "Telemetry.h"
+#include "Crc32.h"
+#include <cstring>
+
+Telemetry::Telemetry(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_records.resize(size);
+    m_staging.resize(size * sizeof(TelemetryRecord));
+    m_mask = size - 1;
+}
+
+bool Telemetry::push(uint32_t timestampMs, const float* inputs, const float* outputs,
+                     int action, float loss) {
+    // La secuencia avanza también con los descartes: el decodificador ve el hueco
+    const uint32_t sequence = m_sequence++;
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    const uint32_t tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail > m_mask) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    TelemetryRecord& record = m_records[head & m_mask];
+    record.sync = TELEMETRY_SYNC;
+    record.version = TELEMETRY_VERSION;
+    record.action = static_cast<uint8_t>(action);
+    record.sequence = sequence;
+    record.timestampMs = timestampMs;
+    uint8_t motors = 0;
+    for (int i = 0; i < 4; i++) {
+        record.inputs[i] = inputs[i];
+        record.outputs[i] = outputs[i];
+        if (outputs[i] > 0.5f) motors |= static_cast<uint8_t>(1u << i);
+    }
+    record.loss = loss;
+    record.motors = motors;
+    record.reserved[0] = record.reserved[1] = record.reserved[2] = 0;
+
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t Telemetry::drain(TelemetryWriter writer, void* context, size_t maxRecords) {
+    const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    const uint32_t head = m_head.load(std::memory_order_acquire);
+    size_t count = head - tail;
+    if (count > maxRecords) count = maxRecords;
+    if (count == 0) return 0;
+
+    // El CRC se calcula aquí, fuera del ciclo de control
+    uint8_t* out = m_staging.data();
+    for (size_t i = 0; i < count; i++) {
+        TelemetryRecord& record = m_records[(tail + i) & m_mask];
+        record.crc = crc32(&record, TELEMETRY_CRC_OFFSET);
+        std::memcpy(out + i * sizeof(TelemetryRecord), &record, sizeof(TelemetryRecord));
+    }
+    m_tail.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+
+    writer(out, count * sizeof(TelemetryRecord), context);
+    return count;
+}
+
+size_t Telemetry::pending() const {
+    return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+}
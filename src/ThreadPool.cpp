@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    m_queues.reset(new Queue[numThreads]);
+    m_threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_pending = count;
+
+        // Reparto inicial por turnos; el robo equilibra la carga después
+        const size_t numThreads = m_threads.size();
+        for (size_t i = 0; i < count; i++) {
+            Queue& queue = m_queues[i % numThreads];
+            std::lock_guard<std::mutex> queueLock(queue.mutex);
+            queue.tasks.push_back(i);
+        }
+        m_generation++;
+    }
+    m_wakeup.notify_all();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_task = nullptr;
+}
+
+bool ThreadPool::popTask(size_t id, size_t& index) {
+    // Primero la cola propia, por el final (lo último repartido)
+    {
+        Queue& own = m_queues[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            index = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Robo: recorremos las demás colas y tomamos del principio
+    const size_t numThreads = m_threads.size();
+    for (size_t k = 1; k < numThreads; k++) {
+        Queue& victim = m_queues[(id + k) % numThreads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t id) {
+    size_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        size_t index;
+        while (popTask(id, index)) {
+            (*m_task)(index);
+            if (m_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_all();
+            }
+        }
+    }
+}
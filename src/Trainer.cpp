@@ -0,0 +1,188 @@
+#include "Trainer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Generador xorshift32: pequeño, sin memoria dinámica y reproducible en
+ *        cualquier plataforma (a diferencia de las distribuciones de <random>).
+ */
+static inline uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+Trainer::Trainer(NeuralNetwork& network, const TrainerConfig& config)
+    : m_network(network),
+      m_inputSize(network.getLayers().front()),
+      m_outputSize(network.getLayers().back()),
+      m_gradients(network.gradients()),
+      m_parameterCount(network.parameterCount()),
+      m_config(config),
+      m_rngState(config.seed != 0 ? config.seed : 0x9E3779B9u)
+{
+    if (m_config.batchSize == 0) {
+        throw std::runtime_error("El tamaño de lote debe ser mayor que cero.");
+    }
+
+    const size_t count = m_parameterCount;
+    if (m_config.optimizer != Optimizer::SGD) {
+        m_velocity.assign(count, 0.0f);
+    }
+    if (m_config.optimizer == Optimizer::ADAM) {
+        m_secondMoment.assign(count, 0.0f);
+    }
+}
+
+size_t Trainer::numSamples(const std::vector<float>& inputs, const std::vector<float>& targets) const {
+    const size_t count = inputs.size() / m_inputSize;
+    if (inputs.size() % m_inputSize != 0 || targets.size() != count * m_outputSize) {
+        throw std::runtime_error("El dataset no coincide con la topología de la red.");
+    }
+    return count;
+}
+
+float Trainer::accumulate(const float* inputs, const float* targets, const size_t* indices,
+                          size_t count, float* sampleLosses) {
+    float loss = 0.0f;
+    for (size_t k = 0; k < count; k++) {
+        size_t row = (indices != nullptr) ? indices[k] : k;
+        float sampleLoss = m_network.accumulateGradients(inputs + row * m_inputSize,
+                                                         targets + row * m_outputSize,
+                                                         m_gradients);
+        if (sampleLosses != nullptr) {
+            sampleLosses[k] = sampleLoss;
+        }
+        loss += sampleLoss;
+    }
+    return loss;
+}
+
+void Trainer::applyOptimizer(size_t count) {
+    m_step++;
+    const float scale = 1.0f / static_cast<float>(count); // Gradiente medio del lote
+    const float lr = m_config.learningRate;
+    float* g = m_gradients;
+    float* p = m_network.mutableParameters();
+    const size_t n = m_parameterCount;
+
+    // Una pasada: estado del optimizador, parámetro y gradiente a cero para el
+    // siguiente lote
+    switch (m_config.optimizer) {
+        case Optimizer::SGD:
+            for (size_t i = 0; i < n; i++) {
+                p[i] += -lr * (g[i] * scale);
+                g[i] = 0.0f;
+            }
+            break;
+
+        case Optimizer::MOMENTUM: {
+            float* v = m_velocity.data();
+            const float mu = m_config.momentum;
+            for (size_t i = 0; i < n; i++) {
+                v[i] = mu * v[i] + g[i] * scale;
+                p[i] += -lr * v[i];
+                g[i] = 0.0f;
+            }
+            break;
+        }
+
+        case Optimizer::ADAM: {
+            float* m = m_velocity.data();
+            float* v = m_secondMoment.data();
+            const float b1 = m_config.beta1;
+            const float b2 = m_config.beta2;
+            const float correction1 = 1.0f - std::pow(b1, static_cast<float>(m_step));
+            const float correction2 = 1.0f - std::pow(b2, static_cast<float>(m_step));
+            const float stepSize = lr * std::sqrt(correction2) / correction1;
+            const float eps = m_config.epsilon * std::sqrt(correction2);
+            for (size_t i = 0; i < n; i++) {
+                float grad = g[i] * scale;
+                m[i] = b1 * m[i] + (1.0f - b1) * grad;
+                v[i] = b2 * v[i] + (1.0f - b2) * grad * grad;
+                p[i] += -stepSize * m[i] / (std::sqrt(v[i]) + eps);
+                g[i] = 0.0f;
+            }
+            break;
+        }
+    }
+}
+
+float Trainer::trainBatch(const float* inputs, const float* targets, size_t count) {
+    if (count == 0) {
+        return 0.0f;
+    }
+    float loss = accumulate(inputs, targets, nullptr, count);
+    applyOptimizer(count);
+    return loss / count;
+}
+
+float Trainer::trainBatch(const float* inputs, const float* targets, const size_t* indices,
+                          size_t count, float* sampleLosses) {
+    if (count == 0) {
+        return 0.0f;
+    }
+    float loss = accumulate(inputs, targets, indices, count, sampleLosses);
+    applyOptimizer(count);
+    return loss / count;
+}
+
+float Trainer::trainEpoch(const std::vector<float>& inputs, const std::vector<float>& targets) {
+    const size_t count = numSamples(inputs, targets);
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    if (m_order.size() != count) {
+        m_order.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            m_order[i] = i;
+        }
+    }
+    if (m_config.shuffle) {
+        // Fisher-Yates
+        for (size_t i = count - 1; i > 0; i--) {
+            std::swap(m_order[i], m_order[nextRandom(m_rngState) % (i + 1)]);
+        }
+    }
+
+    float loss = 0.0f;
+    for (size_t start = 0; start < count; start += m_config.batchSize) {
+        size_t batch = std::min(m_config.batchSize, count - start);
+        loss += accumulate(inputs.data(), targets.data(), m_order.data() + start, batch);
+        applyOptimizer(batch);
+    }
+    return loss / count;
+}
+
+float Trainer::evaluate(const std::vector<float>& inputs, const std::vector<float>& targets) {
+    const size_t count = numSamples(inputs, targets);
+    if (count == 0) {
+        return 0.0f;
+    }
+
+    std::vector<float> input(m_inputSize);
+    std::vector<float> target(m_outputSize);
+    std::vector<float> output(m_outputSize);
+    float total = 0.0f;
+    for (size_t row = 0; row < count; row++) {
+        std::copy(inputs.begin() + row * m_inputSize, inputs.begin() + (row + 1) * m_inputSize, input.begin());
+        std::copy(targets.begin() + row * m_outputSize, targets.begin() + (row + 1) * m_outputSize, target.begin());
+        m_network.forward(input.data(), output.data());
+        total += m_network.calculateError(output, target, ErrorFunction::MSE);
+    }
+    return total / count;
+}
+
+size_t Trainer::fit(const std::vector<float>& inputs, const std::vector<float>& targets,
+                    size_t maxEpochs, float targetMse) {
+    for (size_t epoch = 1; epoch <= maxEpochs; epoch++) {
+        trainEpoch(inputs, targets);
+        if (evaluate(inputs, targets) <= targetMse) {
+            return epoch;
+        }
+    }
+    return 0;  // No converge: distinto de llegar justo en la última época
+}
@@ -1,20 +1,19 @@
 #include <Arduino.h>
 #include "HCSR04.h"
-#include "Motor.h"
+#include "MotorGroup.h"
 #include "NeuralNetwork.h"
+#include "Actions.h"
+#include "Checkpoint.h"
+#include "Perf.h"
+#include "ReplayBuffer.h"
+#include "Scheduler.h"
+#include "Telemetry.h"
+#include "Trainer.h"
 #include "pesos_red_neuronal.h"
 
 
 const float learningRate = 0.01f; // Controla qué tan rápido se ajustan los pesos
 
-// Valores esperados (Ejemplo: motores encendidos o apagados según una regla)
-std::vector<std::vector<float>> targetOptions = {
-    {1,0,1,0},  // Adelante
-    {0,1,0,1},  // Atrás
-    {1,0,0,1},  // Izquierda
-    {0,1,1,0}   // Derecha
-};
-int findClosestMatch(const std::vector<float>& input, const std::vector<std::vector<float>>& targetOptions);
 // -----------------------------------------------------------------------------
 // 1. Configura la topología de la red.
 //    - 4 entradas (dist. Izq, dist. Der, dur. Izq, dur. Der).
@@ -31,44 +30,238 @@ NeuralNetwork redNeuronal({4, 8, 4},
 // -----------------------------------------------------------------------------
 HCSR04 sensorDerecho(5, 18);
 HCSR04 sensorIzquierdo(19, 21);
-Motor motores[] = { Motor(26), Motor(25), Motor(33), Motor(32) };
+HCSR04* const sensores[] = { &sensorIzquierdo, &sensorDerecho };
+RangingScheduler medidor(sensores, 2);
+// Los cuatro motores como un grupo: una orden de 4 bits por ciclo, solo se escriben
+// los pines que cambian (ver MotorGroup.h). Para arrancar y parar con rampa PWM,
+// pasar un MotorGroupConfig con `pwm = true`.
+const uint8_t pinesMotores[] = { 26, 25, 33, 32 };
+MotorGroup motores(pinesMotores, 4);
 
 // -----------------------------------------------------------------------------
-// 3. Variables de tiempo
+// 3. Planificador: cada etapa del ciclo es una tarea con su periodo, plazo y
+//    prioridad (ver Scheduler.h), en lugar de un único intervalo para todo
+//    - sensado (40 Hz): si los sensores completaron una ronda, activa la inferencia
+//    - inferencia: red, motores y telemetría con cada lectura nueva
+//    - entrenamiento: de fondo, en la holgura hasta el siguiente sensado
+//    - punto de control y compactación del registro (de fondo: borrar un sector
+//      de flash tarda decenas de ms y no debe retrasar el sensado)
+//    - mantenimiento (telemetría, rampa de los motores)
+//    Una tarea de fondo que no cabe en la holgura espera como mucho su espera
+//    máxima; después se ejecuta igual y retrasa una vez al sensado. Así un borrado
+//    de flash (~45 ms, más que todo el periodo de sensado) no la bloquea para siempre
 // -----------------------------------------------------------------------------
-unsigned long tiempoAnterior = 0;
-const unsigned long intervaloMedicion = 100;
+Scheduler planificador;
+const unsigned long periodoSensado = 25000;            // us (40 Hz)
+const unsigned long plazoSensado = 5000;               // us
+const unsigned long plazoInferencia = 10000;           // us desde la lectura
+const unsigned long presupuestoEntrenamiento = 2000;   // us, hasta medir la duración real
+const unsigned long esperaEntrenamiento = 100000;      // us, espera máxima
+const unsigned long periodoPuntoControl = 10000000;    // us (10 s)
+const unsigned long periodoCompactacion = 100000;      // us
+// us, hasta medir la duración real (un sector borrado o un trozo escrito)
+const unsigned long presupuestoCompactacion = 45000;
+// us, espera máxima del punto de control y de cada paso de la compactación. Los
+// pasos que no caben se cuentan en "aplazadas" y los que se ejecutan igual en
+// "forzadas"; cada borrado forzado cuesta una lectura de los sensores
+const unsigned long esperaRegistro = 250000;
+const unsigned long periodoMantenimiento = 1000;       // us
+int tareaInferencia = -1;
+int tareaEntrenamiento = -1;
+
+// Estado compartido entre tareas
 unsigned long tiempoInicioDerecha = 0;
 unsigned long tiempoInicioIzquierda = 0;
+unsigned long rondaAnterior = 0;
+unsigned long tiempoLectura = 0;
+float input[4];
+float output[4];
+int closestMatch = 0;
+// La última inferencia aún no se entrenó y sus activaciones siguen en la red
+bool muestraPendiente = false;
+
+// -----------------------------------------------------------------------------
+// 4. Telemetría: registros binarios por ciclo (ver Telemetry.h). Para obtener
+//    el CSV de siempre: tools/telemetry_decoder < captura.bin > datos.csv
+// -----------------------------------------------------------------------------
+Telemetry telemetria(32);
+
+// -----------------------------------------------------------------------------
+// 5. Memoria de experiencias: además de la última muestra, cada entrenamiento repasa
+//    un mini-lote de muestras anteriores elegidas según su error (ver ReplayBuffer.h)
+// -----------------------------------------------------------------------------
+const size_t presupuestoMemoria = 4096;  // Bytes de RAM para las experiencias
+const size_t tamanoLote = 8;
+ReplayBuffer memoria(4, 4, presupuestoMemoria, tamanoLote, ReplaySampling::PRIORITIZED);
+
+static TrainerConfig configuracionRepaso() {
+    TrainerConfig config;
+    config.optimizer = Optimizer::SGD;
+    config.learningRate = learningRate;
+    config.batchSize = tamanoLote;
+    return config;
+}
+Trainer repaso(redNeuronal, configuracionRepaso());
+float perdidasLote[tamanoLote];
+
+// -----------------------------------------------------------------------------
+// 6. Puntos de control: lo aprendido en línea sobrevive a un reinicio. Cada
+//    `periodoPuntoControl` se guardan solo los parámetros que cambiaron (ver
+//    Checkpoint.h); la compactación avanza en su propia tarea de fondo.
+//    Deltas cuantizados: el SGD en línea toca todos los parámetros en cada ciclo,
+//    así que un delta XOR sin pérdidas ocupa casi lo mismo que una base (~93 % en
+//    tools/checkpoint_bench); cuantizados a `pasoPuntoControl` ocupan ~58 %, y cada
+//    parámetro restaurado se aparta como mucho medio paso (5e-5) de lo aprendido.
+//    Los cambios menores que medio paso no se escriben, pero tampoco se pierden:
+//    se acumulan hasta el siguiente punto de control
+// -----------------------------------------------------------------------------
+#ifdef ESP_PLATFORM
+PartitionCheckpointStorage almacenamiento("ckpt_a", "ckpt_b");
+#else
+// En el PC, cada borrado y escritura consume en el reloj simulado lo que tardaría
+// en la flash del ESP32
+static void esperarFlash(unsigned long us) {
+    delayMicroseconds(us);
+}
+static FlashTiming tiemposFlash() {
+    FlashTiming tiempos;
+    tiempos.wait = esperarFlash;
+    return tiempos;
+}
+MemoryCheckpointStorage almacenamiento(8192, 4096, tiemposFlash());
+#endif
+const float pasoPuntoControl = 1e-4f;
+
+static CheckpointConfig configuracionRegistro() {
+    CheckpointConfig config;
+    config.encoding = DeltaEncoding::QUANTIZED;
+    config.quantStep = pasoPuntoControl;
+    return config;
+}
+CheckpointLog registro(almacenamiento, redNeuronal.parameterCount(), configuracionRegistro());
+
+static size_t escribirSerie(const uint8_t* datos, size_t bytes, void*) {
+    return Serial.write(datos, bytes);
+}
+
+// -----------------------------------------------------------------------------
+// Tareas
+// -----------------------------------------------------------------------------
+static void tareaSensado(void*) {
+    // Solo hay lectura nueva cuando los dos sensores completaron una ronda
+    if (medidor.cycles() == rondaAnterior) return;
+    rondaAnterior = medidor.cycles();
+
+    PERF_BEGIN(Stage::SENSING);
+    tiempoLectura = millis();
+    float distanciaIzquierda = medidor.distance(0);
+    float distanciaDerecha = medidor.distance(1);
+
+    if (distanciaDerecha > 0) tiempoInicioDerecha = tiempoLectura;
+    if (distanciaIzquierda > 0) tiempoInicioIzquierda = tiempoLectura;
+
+    input[0] = distanciaIzquierda;
+    input[1] = distanciaDerecha;
+    input[2] = (tiempoLectura - tiempoInicioIzquierda) / 1000.0f;
+    input[3] = (tiempoLectura - tiempoInicioDerecha) / 1000.0f;
+    PERF_END(Stage::SENSING);
+
+    planificador.trigger(tareaInferencia);
+}
+
+static void tareaInferenciaCiclo(void*) {
+    PERF_SCOPE(Stage::CYCLE);
 
-int findClosestMatch(const std::vector<float>& input, const std::vector<std::vector<float>>& targetOptions) {
-    if (targetOptions.empty() || input.size() != 4) {
-        return -1; // Error
+    // Forward pass (conserva las activaciones para el entrenamiento)
+    PERF_BEGIN(Stage::FORWARD);
+    redNeuronal.forwardTrain(input, output);
+    PERF_END(Stage::FORWARD);
+
+    PERF_BEGIN(Stage::SELECTION);
+    closestMatch = findClosestMatch(output, targetOptions);
+    const float* objetivo = targetOptions[closestMatch].data();
+    PERF_END(Stage::SELECTION);
+
+    PERF_BEGIN(Stage::ACTUATION);
+    uint32_t orden = 0;
+    for (int i = 0; i < 4; i++) {
+        if (output[i] > 0.5f) orden |= 1u << i;
     }
+    motores.command(orden);
+    PERF_END(Stage::ACTUATION);
 
-    int closestIndex = -1;
-    float minDistance = 99999.0f; // En Arduino, evitar std::numeric_limits<float>::max()
+    // MSE antes de entrenar (el mismo que devolverá `backward`): prioridad de la
+    // muestra en la memoria y error de la telemetría
+    float error = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        float diferencia = output[i] - objetivo[i];
+        error += diferencia * diferencia;
+    }
+    error /= 4;
+    memoria.push(input, objetivo, error);
 
-    for (size_t i = 0; i < targetOptions.size(); i++) {
-        float distance = 0.0f;
-        for (size_t j = 0; j < 4; j++) {
-            float diff = input[j] - targetOptions[i][j];
-            distance += diff * diff; // Distancia euclidiana
-        }
+    PERF_BEGIN(Stage::TELEMETRY);
+    telemetria.push(tiempoLectura, input, output, closestMatch, error);
+    PERF_END(Stage::TELEMETRY);
 
-        if (distance < minDistance) {
-            minDistance = distance;
-            closestIndex = i;
-        }
+    muestraPendiente = true;
+    planificador.trigger(tareaEntrenamiento);
+}
+
+static void tareaEntrenamientoCiclo(void*) {
+    PERF_SCOPE(Stage::TRAINING);
+
+    // Retropropagación con descenso de gradiente fusionado, con la misma regla de
+    // gradiente que el repaso de `Trainer`. Si ya hubo otra inferencia, la muestra
+    // anterior solo queda en la memoria
+    if (muestraPendiente) {
+        redNeuronal.backward(targetOptions[closestMatch].data(), learningRate);
+        muestraPendiente = false;
     }
 
-    return closestIndex;
+    // Repaso: un mini-lote de la memoria sin copiarlo; las pérdidas obtenidas pasan
+    // a ser las nuevas prioridades
+    if (memoria.size() >= tamanoLote) {
+        ReplayBatch lote = memoria.sample(tamanoLote);
+        repaso.trainBatch(lote.inputs, lote.targets, lote.indices, lote.count, perdidasLote);
+        memoria.updatePriorities(lote, perdidasLote);
+    }
+}
+
+static void tareaPuntoControl(void*) {
+    registro.checkpoint(redNeuronal);
+}
+
+static void tareaCompactacion(void*) {
+    registro.compactStep();
+}
+
+static void tareaMantenimiento(void*) {
+    // Vaciar la telemetría en una sola escritura, solo lo que quepa en el búfer
+    size_t espacio = Serial.availableForWrite() / sizeof(TelemetryRecord);
+    telemetria.drain(escribirSerie, nullptr, espacio);
+
+    motores.update();
+}
+
+static TaskConfig configuracionTarea(unsigned long periodoUs, unsigned long plazoUs,
+                                     uint8_t prioridad, bool deFondo,
+                                     unsigned long presupuestoUs = 0,
+                                     unsigned long esperaMaximaUs = 0) {
+    TaskConfig config;
+    config.periodUs = periodoUs;
+    config.deadlineUs = plazoUs;
+    config.priority = prioridad;
+    config.background = deFondo;
+    config.budgetUs = presupuestoUs;
+    config.maxWaitUs = esperaMaximaUs;
+    return config;
 }
 
 void setup() {
+    // Búfer de transmisión para que el drenado de la telemetría no bloquee
+    Serial.setTxBufferSize(1024);
     Serial.begin(115200);
-    // Encabezados para la salida serial (opcional)
-    Serial.println("distancia_izquierda,distancia_derecha,duracion_izquierda,duracion_derecha,IN1,IN2,IN3,IN4");
 
     // -------------------------------------------------------------------------
     // Cargar los pesos y sesgos desde el archivo 'pesos_red_neuronal.h'
@@ -85,56 +278,50 @@ void setup() {
 
     // Asignar los pesos y sesgos a la red neuronal
     redNeuronal.setWeights(weights, biases);
+
+    // Sin particiones (otra tabla de particiones) no se guarda nada: avisarlo
+    if (almacenamiento.regionSize() == 0) {
+        Serial.println("AVISO: sin particiones ckpt_a/ckpt_b, no se guardará lo aprendido");
+    }
+
+    // Si hay un estado guardado, sustituye a los pesos de fábrica
+    if (!registro.restore(redNeuronal)) {
+        registro.reset(redNeuronal);
+    }
+    // La base del primer arranque (o la compactación que deja pendiente `restore`)
+    // se escribe ya: aún no hay sensado que retrasar. Si el medio falla, lo que
+    // quede lo sigue intentando la tarea de compactación
+    for (int paso = 0; paso < 100 && !registro.compactStep(); paso++) {
+    }
+
+    // Mediciones por interrupción: loop() ya no se bloquea esperando el eco
+    medidor.begin();
+    motores.begin();
+
+    planificador.add("sensado", tareaSensado, nullptr,
+                     configuracionTarea(periodoSensado, plazoSensado, 4, false));
+    tareaInferencia = planificador.add("inferencia", tareaInferenciaCiclo, nullptr,
+                                       configuracionTarea(0, plazoInferencia, 3, false));
+    tareaEntrenamiento = planificador.add("entrenamiento", tareaEntrenamientoCiclo, nullptr,
+                                          configuracionTarea(0, 0, 2, true, presupuestoEntrenamiento,
+                                                             esperaEntrenamiento));
+    planificador.add("punto de control", tareaPuntoControl, nullptr,
+                     configuracionTarea(periodoPuntoControl, 0, 1, true, 0, esperaRegistro));
+    planificador.add("compactacion", tareaCompactacion, nullptr,
+                     configuracionTarea(periodoCompactacion, 0, 1, true, presupuestoCompactacion,
+                                        esperaRegistro));
+    planificador.add("mantenimiento", tareaMantenimiento, nullptr,
+                     configuracionTarea(periodoMantenimiento, 0, 0, false));
+    planificador.begin();
+
+    // Con -DPERF_STATS: cuenta las inferencias que no caben en su plazo
+    PERF_DEADLINE(Stage::CYCLE, plazoInferencia * 1000ULL);
 }
 
 void loop() {
-    unsigned long tiempoActual = millis();
-
-    if (tiempoActual - tiempoAnterior >= intervaloMedicion) {
-        tiempoAnterior = tiempoActual;
-
-        // Leer sensores
-        float distanciaDerecha = sensorDerecho.medirDistancia();
-        float distanciaIzquierda = sensorIzquierdo.medirDistancia();
-
-        if (distanciaDerecha > 0) tiempoInicioDerecha = tiempoActual;
-        if (distanciaIzquierda > 0) tiempoInicioIzquierda = tiempoActual;
-
-        float duracionDerecha = (tiempoActual - tiempoInicioDerecha) / 1000.0f;
-        float duracionIzquierda = (tiempoActual - tiempoInicioIzquierda) / 1000.0f;
-
-        // 1️ Entrada a la red neuronal
-        std::vector<float> input = {distanciaIzquierda, distanciaDerecha, duracionIzquierda, duracionDerecha};
-        
-        // 2️ Forward pass
-        std::vector<float> output = redNeuronal.forward(input);
-
-        int closestMatch = findClosestMatch(output, targetOptions);
-        Serial.println(closestMatch);
-        std::vector<float> targetOutputs = targetOptions[closestMatch];
-        // 3️ Calcular error con MSE
-        float error = redNeuronal.calculateError(output, targetOutputs, ErrorFunction::MSE);
-
-        std::vector<std::vector<float>> grad_weights, grad_biases;
-        redNeuronal.computeGradients(input, targetOutputs, grad_weights, grad_biases);
-
-        // 5️ Ajustar pesos con descenso de gradiente
-        redNeuronal.updateWeights(grad_weights, grad_biases, learningRate);
-
-        // 6️ Imprimir información de depuración
-        // Serial.print(distanciaIzquierda); Serial.print(",");
-        // Serial.print(distanciaDerecha); Serial.print(",");
-        // Serial.print(duracionIzquierda); Serial.print(",");
-        // Serial.print(duracionDerecha);
-        for (int i = 0; i < 4; i++) {
-            bool motorOn = (output[i] > 0.5f);
-            motores[i].setEstado(motorOn);
-            Serial.print(",");
-            Serial.print(motorOn ? 1 : 0);
-        }
-        // Serial.print(", Error: ");
-        // Serial.println(error);
+    // Cada tarea lista se ejecuta una vez; entre una y otra se atienden los sensores
+    medidor.poll();
+    while (planificador.runOnce()) {
+        medidor.poll();
     }
 }
-
-
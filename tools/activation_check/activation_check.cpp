@@ -0,0 +1,157 @@
+// -----------------------------------------------------------------------------
+// Verificación de las activaciones aproximadas (herramienta de PC, no se compila
+// para el ESP32)
+//
+// 1. Mide el error absoluto máximo de cada `ActivationMode` frente a std::exp /
+//    std::tanh en un barrido denso de [-30, 30].
+// 2. Ejecuta la red de 'pesos_red_neuronal.h' con cada modo sobre un conjunto de
+//    entradas y cuenta las decisiones de motor (`output[i] > 0.5f`) y las acciones
+//    (`findClosestMatch`) que difieren del cálculo exacto.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/activation_check/activation_check.cpp src/NeuralNetwork.cpp
+//       src/Kernels.cpp src/Activations.cpp src/Actions.cpp -o activation_check
+//
+// Uso:
+//   ./activation_check [registro.csv]
+//
+// El CSV sigue el formato de la salida serial (4 primeras columnas: distancias y
+// duraciones). Sin CSV se usa una rejilla de distancias de 2 a 400 cm (y sin eco)
+// con duraciones de 0 a 10 s. Devuelve 1 si LUT o RATIONAL cambian alguna decisión.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Actions.h"
+#include "NeuralNetwork.h"
+#include "pesos_red_neuronal.h"
+
+static const ActivationMode MODES[] = {ActivationMode::EXACT, ActivationMode::LUT,
+                                       ActivationMode::RATIONAL, ActivationMode::HARD};
+static const char* const MODE_NAMES[] = {"EXACT", "LUT", "RATIONAL", "HARD"};
+static const int NUM_MODES = 4;
+
+static std::vector<std::vector<float>> readCsv(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", path);
+        std::exit(1);
+    }
+
+    std::vector<std::vector<float>> rows;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<float> row;
+        while (row.size() < 4 && std::getline(ss, cell, ',')) {
+            char* end = nullptr;
+            float value = std::strtof(cell.c_str(), &end);
+            if (end == cell.c_str()) {
+                break; // Encabezado u otra línea no numérica
+            }
+            row.push_back(value);
+        }
+        if (row.size() == 4) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+static std::vector<std::vector<float>> sensorGrid() {
+    std::vector<float> distances = {-1.0f};
+    for (float d = 2.0f; d <= 400.0f; d += 6.0f) distances.push_back(d);
+    const float durations[] = {0.0f, 0.1f, 0.5f, 1.0f, 3.0f, 10.0f};
+
+    std::vector<std::vector<float>> rows;
+    for (float left : distances) {
+        for (float right : distances) {
+            for (float dl : durations) {
+                for (float dr : durations) {
+                    rows.push_back({left, right, dl, dr});
+                }
+            }
+        }
+    }
+    return rows;
+}
+
+static void reportFunctionErrors() {
+    std::printf("Error absoluto máximo en [-30, 30]:\n");
+    std::printf("  %-9s %12s %12s\n", "modo", "sigmoid", "tanh");
+    for (int m = 0; m < NUM_MODES; m++) {
+        double sigmoidError = 0.0;
+        double tanhError = 0.0;
+        for (int k = -3000000; k <= 3000000; k++) {
+            float x = k * 1e-5f;
+            double exactSigmoid = 1.0 / (1.0 + std::exp(-static_cast<double>(x)));
+            double exactTanh = std::tanh(static_cast<double>(x));
+            sigmoidError = std::max(sigmoidError,
+                std::fabs(applyActivation(x, ActivationFunction::SIGMOID, MODES[m]) - exactSigmoid));
+            tanhError = std::max(tanhError,
+                std::fabs(applyActivation(x, ActivationFunction::TANH, MODES[m]) - exactTanh));
+        }
+        std::printf("  %-9s %12.3g %12.3g\n", MODE_NAMES[m], sigmoidError, tanhError);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::vector<float>> rows = (argc > 1) ? readCsv(argv[1]) : sensorGrid();
+    if (rows.empty()) {
+        std::fprintf(stderr, "No hay entradas que evaluar\n");
+        return 1;
+    }
+
+    reportFunctionErrors();
+
+    NeuralNetwork net({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    net.setWeights({std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+                    std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+                   {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+                    std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+
+    // Salidas exactas de referencia
+    std::vector<float> reference(rows.size() * 4);
+    for (size_t r = 0; r < rows.size(); r++) {
+        net.forward(rows[r].data(), &reference[r * 4]);
+    }
+
+    std::printf("\nRed {4,8,4} sobre %zu entradas (%s):\n", rows.size(),
+                (argc > 1) ? argv[1] : "rejilla sintética");
+    std::printf("  %-9s %14s %18s %16s\n", "modo", "error salida", "motores distintos",
+                "acciones distintas");
+
+    bool approximateMismatch = false;
+    for (int m = 1; m < NUM_MODES; m++) {
+        net.setActivationMode(MODES[m]);
+        double maxError = 0.0;
+        size_t motorMismatches = 0;
+        size_t actionMismatches = 0;
+        float output[4];
+        for (size_t r = 0; r < rows.size(); r++) {
+            const float* exact = &reference[r * 4];
+            net.forward(rows[r].data(), output);
+            for (int i = 0; i < 4; i++) {
+                maxError = std::max(maxError, static_cast<double>(std::fabs(output[i] - exact[i])));
+                if ((output[i] > 0.5f) != (exact[i] > 0.5f)) motorMismatches++;
+            }
+            if (findClosestMatch(output, targetOptions) != findClosestMatch(exact, targetOptions)) {
+                actionMismatches++;
+            }
+        }
+        std::printf("  %-9s %14.3g %18zu %16zu\n", MODE_NAMES[m], maxError, motorMismatches,
+                    actionMismatches);
+        if (MODES[m] != ActivationMode::HARD && (motorMismatches || actionMismatches)) {
+            approximateMismatch = true;
+        }
+    }
+    return approximateMismatch ? 1 : 0;
+}
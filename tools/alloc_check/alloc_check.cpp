@@ -0,0 +1,190 @@
+// -----------------------------------------------------------------------------
+// Comprobación de que la inferencia no reserva memoria (herramienta de PC, no se
+// compila para el ESP32)
+//
+// Sustituye los `operator new` / `operator delete` globales por versiones que
+// cuentan las reservas y ejecuta muchas veces `forward(const float*, float*)`:
+// - con la red recién construida (pesos y sesgos iniciales constantes, 0.1f),
+// - tras `setWeights` con los pesos de 'pesos_red_neuronal.h',
+// - tras `setParameters` y con cada `ActivationMode`,
+// - con parámetros externos (`forward(input, output, parameters)`),
+// - y el ciclo de entrenamiento en línea de main.cpp (`forwardTrain` + `backward`).
+// Para varias topologías, incluida una con una activación por capa.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/alloc_check/alloc_check.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp -o alloc_check
+//
+// Uso:
+//   ./alloc_check [llamadas]     (por defecto 10000 llamadas por caso)
+//
+// Devuelve 1 si alguna llamada reserva memoria.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "pesos_red_neuronal.h"
+
+// -----------------------------------------------------------------------------
+// Reservas contadas
+// -----------------------------------------------------------------------------
+static unsigned long g_allocations = 0;
+
+static void* countedAlloc(std::size_t size) {
+    g_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+static void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    g_allocations++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    void* p = std::aligned_alloc(align, rounded ? rounded : align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    g_allocations++;
+    return std::malloc(size ? size : 1);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    g_allocations++;
+    return std::malloc(size ? size : 1);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlignedAlloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// -----------------------------------------------------------------------------
+
+static bool g_ok = true;
+
+/**
+ * @brief Ejecuta `call` `calls` veces e informa de las reservas que hizo.
+ */
+template <typename Call>
+static void expectNoAllocations(const char* topology, const char* what, int calls, Call call) {
+    unsigned long before = g_allocations;
+    for (int i = 0; i < calls; i++) {
+        call(i);
+    }
+    unsigned long allocations = g_allocations - before;
+    std::printf("  %-14s %-36s %10lu\n", topology, what, allocations);
+    if (allocations != 0) {
+        g_ok = false;
+    }
+}
+
+/**
+ * @brief Entradas variadas dentro del rango de los sensores (cm y s).
+ */
+static void fillInput(std::vector<float>& input, int call) {
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = static_cast<float>((call * 37 + static_cast<int>(i) * 11) % 400);
+    }
+}
+
+static void checkNetwork(const char* topology, NeuralNetwork& net, int calls) {
+    std::vector<float> input(net.getLayers().front());
+    std::vector<float> output(net.getLayers().back());
+    std::vector<float> target(net.getLayers().back(), 0.5f);
+
+    expectNoAllocations(topology, "forward", calls, [&](int i) {
+        fillInput(input, i);
+        net.forward(input.data(), output.data());
+    });
+
+    // Parámetros externos (p.ej. una instantánea de ParameterStore)
+    std::vector<float> parameters(net.parameterCount());
+    net.copyParameters(parameters.data());
+    expectNoAllocations(topology, "forward (parámetros externos)", calls, [&](int i) {
+        fillInput(input, i);
+        net.forward(input.data(), output.data(), parameters.data());
+    });
+
+    for (size_t i = 0; i < parameters.size(); i++) {
+        parameters[i] *= 0.5f;
+    }
+    net.setParameters(parameters.data());
+    expectNoAllocations(topology, "forward tras setParameters", calls, [&](int i) {
+        fillInput(input, i);
+        net.forward(input.data(), output.data());
+    });
+
+    static const ActivationMode MODES[] = {ActivationMode::LUT, ActivationMode::RATIONAL,
+                                           ActivationMode::HARD, ActivationMode::EXACT};
+    static const char* const LABELS[] = {"forward LUT", "forward RATIONAL", "forward HARD",
+                                         "forward EXACT"};
+    for (int m = 0; m < 4; m++) {
+        net.setActivationMode(MODES[m]);
+        expectNoAllocations(topology, LABELS[m], calls, [&](int i) {
+            fillInput(input, i);
+            net.forward(input.data(), output.data());
+        });
+    }
+
+    // Ciclo de main.cpp: inferencia que conserva activaciones y paso de SGD
+    expectNoAllocations(topology, "forwardTrain + backward", calls, [&](int i) {
+        fillInput(input, i);
+        net.forwardTrain(input.data(), output.data());
+        net.backward(target.data(), 1e-6f);
+    });
+}
+
+int main(int argc, char** argv) {
+    int calls = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    if (calls <= 0) calls = 10000;
+
+    std::printf("Reservas de memoria en %d llamadas por caso:\n", calls);
+    std::printf("  %-14s %-36s %10s\n", "topología", "caso", "reservas");
+
+    // Red del vehículo, recién construida y tras cargar los pesos de fábrica
+    NeuralNetwork vehicle({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+
+    // El contador funciona: la versión con vectores reserva su resultado
+    unsigned long before = g_allocations;
+    std::vector<float> result = vehicle.forward(std::vector<float>(4, 1.0f));
+    if (g_allocations == before) {
+        std::printf("FALLO: no se cuentan las reservas de memoria\n");
+        return 1;
+    }
+
+    checkNetwork("{4,8,4}", vehicle, calls);
+
+    vehicle.setWeights({std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+                        std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+                       {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+                        std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+    checkNetwork("{4,8,4} pesos", vehicle, calls);
+
+    NeuralNetwork mixed({4, 16, 8, 2}, {ActivationFunction::TANH, ActivationFunction::RELU,
+                                        ActivationFunction::LINEAR});
+    checkNetwork("{4,16,8,2}", mixed, calls);
+
+    NeuralNetwork wide({16, 64, 16}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    checkNetwork("{16,64,16}", wide, calls);
+
+    std::printf("%s\n", g_ok ? "OK" : "FALLO: alguna llamada reservó memoria");
+    return g_ok ? 0 : 1;
+}
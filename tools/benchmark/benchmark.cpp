@@ -0,0 +1,916 @@
+// -----------------------------------------------------------------------------
+// Benchmarks de la API de NeuralNetwork (herramienta de PC, no se compila para el ESP32)
+//
+// Mide ns/op, reservas de memoria/op y bytes/op de forward, forwardBatch (por fila,
+// con la aceleración respecto a `forward` fila a fila, y comprobando que coincide
+// bit a bit con él), computeGradients, updateWeights, calculateError (MSE, MAE,
+// CROSS_ENTROPY) y setWeights, para la topología del vehículo {4,8,4} y otras más
+// anchas y profundas. También mide el coste por llamada de SIGMOID y TANH en cada
+// `ActivationMode`, `forward` de {4,8,4} con cada modo y `forward` de una red con
+// una activación distinta por capa.
+// Por último compara `forward` denso con `SparseNetwork` tras podar el 0, 50, 75 y
+// 90 % de los pesos (latencia y bytes de modelo), y mide `ReplayBuffer`: inserción,
+// muestreo de mini-lotes de 8 (uniforme y priorizado) y un paso de repaso completo
+// con 4 KB (el presupuesto del vehículo) y 64 KB. También compara `Population` (K
+// redes {4,8,4} intercaladas) con un bucle de K `NeuralNetwork::forward`, para una
+// entrada y para evaluar una traza de 100 filas (en serie y con un grupo de hilos);
+// ahí ns/op es por evaluación de una red. `Trainer` se mide sobre un dataset
+// sintético con semilla fija: muestras/s de `trainEpoch` con SGD, MOMENTUM y ADAM
+// en lotes de 32, y épocas y tiempo de `fit` hasta un MSE de 0.001. `ParallelTrainer`
+// se mide con 1, 2, 4... hasta `hardware_concurrency` hilos (muestras/s y aceleración
+// respecto a un hilo), y se comprueba que dos ejecuciones con la misma semilla y
+// el mismo número de hilos dejan parámetros idénticos bit a bit. Los núcleos
+// `dot`, `axpy`, `mulAdd`, `outer` y `matmulRows` se miden con cada conjunto de
+// instrucciones que soporte la CPU (`kernels::setIsa`), con la aceleración respecto
+// a SCALAR, y se comprueba que cada variante coincide con la escalar dentro de la
+// tolerancia de Kernels.h.
+// El resultado va en JSON a stdout (o a --output) para poder comparar versiones;
+// la tabla legible va a stderr. Devuelve 1 si alguna comprobación falla.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -pthread -Iinclude tools/benchmark/benchmark.cpp
+//       src/NeuralNetwork.cpp src/Kernels.cpp src/Activations.cpp
+//       src/SparseNetwork.cpp src/ReplayBuffer.cpp src/Trainer.cpp
+//       src/Population.cpp src/ThreadPool.cpp src/ParallelTrainer.cpp -o benchmark
+//
+// Uso:
+//   ./benchmark [--filter texto] [--min-time ms] [--repeat N] [--output archivo.json]
+//
+// Las reservas se cuentan sustituyendo operator new/delete en este programa. El
+// tiempo es la mediana de `--repeat` mediciones de al menos `--min-time` ms cada una.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Kernels.h"
+#include "NeuralNetwork.h"
+#include "ParallelTrainer.h"
+#include "Population.h"
+#include "ReplayBuffer.h"
+#include "SparseNetwork.h"
+#include "ThreadPool.h"
+#include "Trainer.h"
+
+// -----------------------------------------------------------------------------
+// Contadores de memoria dinámica
+// -----------------------------------------------------------------------------
+static uint64_t g_allocCount = 0;
+static uint64_t g_allocBytes = 0;
+
+// Todas las variantes reservan con malloc (o aligned_alloc) y liberan con free,
+// para que cada pareja new/delete sea coherente
+static void* countedAlloc(size_t size) {
+    g_allocCount++;
+    g_allocBytes += size;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+static void* countedAlignedAlloc(size_t size, std::align_val_t alignment) {
+    g_allocCount++;
+    g_allocBytes += size;
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded ? rounded : align)) return p;
+    throw std::bad_alloc();
+}
+
+static void* countedAllocNothrow(size_t size) noexcept {
+    g_allocCount++;
+    g_allocBytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAllocNothrow(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAllocNothrow(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Evita que el compilador elimine el trabajo medido
+volatile float g_sink;
+
+struct Options {
+    std::string filter;
+    double minTimeMs = 200.0;
+    int repeat = 5;
+    const char* output = nullptr;
+};
+
+struct Result {
+    std::string name;
+    std::vector<int> topology;
+    size_t parameters;
+    size_t modelBytes;  // Pesos, sesgos e índices tal como se almacenan
+    uint64_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+    double speedup = 0.0;  // Respecto a la referencia de su grupo (0 = sin referencia)
+    size_t epochs = 0;     // Entrenamientos hasta un objetivo (0 = no aplica)
+};
+
+bool g_ok = true;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::fprintf(stderr, "FALLO: %s\n", what.c_str());
+        g_ok = false;
+    }
+}
+
+uint32_t g_rng = 0x12345678u;
+
+float randomUnit() {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return (g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+std::vector<float> randomVector(size_t n, float lo, float hi) {
+    std::vector<float> v(n);
+    for (float& x : v) x = lo + (hi - lo) * randomUnit();
+    return v;
+}
+
+double runFor(const std::function<void()>& op, uint64_t iterations) {
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) op();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Mide una operación: calibra el número de iteraciones para que cada
+ *        medición dure al menos `minTimeMs`, toma la mediana de `repeat`
+ *        mediciones y cuenta las reservas en una pasada aparte.
+ * @param opsPerCall Operaciones que hace cada llamada a `op` (los resultados son por operación).
+ */
+Result measure(const std::string& name, const std::vector<int>& topology, size_t parameters,
+               const Options& options, const std::function<void()>& op,
+               uint64_t opsPerCall = 1) {
+    op();  // Calentamiento (buffers perezosos, caché)
+
+    uint64_t iterations = 1;
+    double minNs = options.minTimeMs * 1e6;
+    for (;;) {
+        double ns = runFor(op, iterations);
+        if (ns >= minNs || iterations >= (1ull << 32)) break;
+        double factor = ns > 0.0 ? 1.2 * minNs / ns : 10.0;
+        iterations = static_cast<uint64_t>(iterations * std::min(std::max(factor, 1.5), 10.0)) + 1;
+    }
+
+    std::vector<double> samples;
+    for (int r = 0; r < options.repeat; ++r) {
+        samples.push_back(runFor(op, iterations) / (iterations * opsPerCall));
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+
+    const uint64_t allocIterations = 1000;
+    uint64_t count0 = g_allocCount;
+    uint64_t bytes0 = g_allocBytes;
+    for (uint64_t i = 0; i < allocIterations; ++i) op();
+    uint64_t allocs = g_allocCount - count0;
+    uint64_t bytes = g_allocBytes - bytes0;
+    const uint64_t totalOps = allocIterations * opsPerCall;
+
+    Result result;
+    result.name = name;
+    result.topology = topology;
+    result.parameters = parameters;
+    result.modelBytes = parameters * sizeof(float);
+    result.iterations = iterations * opsPerCall;
+    result.nsPerOp = samples[samples.size() / 2];
+    result.allocsPerOp = static_cast<double>(allocs) / totalOps;
+    result.bytesPerOp = static_cast<double>(bytes) / totalOps;
+    return result;
+}
+
+std::string topologyName(const std::vector<int>& topology) {
+    std::string s = "{";
+    for (size_t i = 0; i < topology.size(); ++i) {
+        if (i) s += ",";
+        s += std::to_string(topology[i]);
+    }
+    return s + "}";
+}
+
+bool selected(const Options& options, const std::string& name, const std::vector<int>& topology) {
+    std::string full = name + " " + topologyName(topology);
+    return options.filter.empty() || full.find(options.filter) != std::string::npos;
+}
+
+void report(const Result& r) {
+    std::fprintf(stderr,
+                 "%-26s %-22s %12.1f ns/op %12.0f op/s %8.2f allocs/op %10.1f B/op %9zu B modelo",
+                 r.name.c_str(), topologyName(r.topology).c_str(), r.nsPerOp,
+                 r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0, r.allocsPerOp, r.bytesPerOp,
+                 r.modelBytes);
+    if (r.speedup > 0.0) std::fprintf(stderr, " %6.2fx", r.speedup);
+    if (r.epochs > 0) std::fprintf(stderr, " %6zu épocas", r.epochs);
+    std::fprintf(stderr, "\n");
+}
+
+const kernels::Isa ISAS[] = {kernels::Isa::SCALAR, kernels::Isa::SSE2, kernels::Isa::AVX2,
+                             kernels::Isa::AVX512};
+
+/**
+ * @brief `dot`, `axpy`, `mulAdd` (vectores de n floats), `outer` (n x n) y
+ *        `matmulRows` (4 filas por una matriz n x n en paneles) con cada variante
+ *        soportada. ns/op es por llamada; la aceleración es respecto a SCALAR con
+ *        el mismo tamaño. Antes de medir, compara cada variante con la escalar:
+ *        `axpy`, `mulAdd`, `outer` y `matmulRows` bit a bit, `dot` dentro de
+ *        `2 * n * FLT_EPSILON * sum(|a[i] * b[i]|)`.
+ */
+void benchmarkKernels(const Options& options, std::vector<Result>& results) {
+    const kernels::Isa original = kernels::activeIsa();
+    const size_t sizes[] = {64, 1024};
+    const char* const names[] = {"dot", "axpy", "mulAdd", "outer", "matmulRows"};
+    const std::vector<int> none;
+
+    for (size_t n : sizes) {
+        std::vector<float> a = randomVector(n, -1.0f, 1.0f);
+        std::vector<float> b = randomVector(n, -1.0f, 1.0f);
+        std::vector<float> y(n);
+        std::vector<float> A(n * n);
+        const float alpha = 1e-7f;  // Mantiene acotados los acumuladores entre iteraciones
+        std::vector<float> rows = randomVector(kernels::kMaxRows * n, -1.0f, 1.0f);
+        std::vector<float> W = randomVector(n * n, -1.0f, 1.0f);
+        std::vector<float> panels(kernels::panelSize(n, n));
+        kernels::packPanels(W.data(), n, n, panels.data());
+        std::vector<float> product(kernels::kMaxRows * n);
+
+        // Referencia escalar de la comprobación
+        kernels::setIsa(kernels::Isa::SCALAR);
+        const float dotScalar = kernels::dot(a.data(), b.data(), n);
+        double dotBound = 0.0;
+        for (size_t i = 0; i < n; i++) dotBound += std::fabs(a[i] * b[i]);
+        dotBound *= 2.0 * n * FLT_EPSILON;
+        std::vector<float> axpyScalar(b);
+        kernels::axpy(0.5f, a.data(), axpyScalar.data(), n);
+        std::vector<float> mulAddScalar(b);
+        kernels::mulAdd(a.data(), b.data(), mulAddScalar.data(), n);
+        std::vector<float> outerScalar(n * n, 0.25f);
+        kernels::outer(0.5f, a.data(), n, b.data(), n, outerScalar.data());
+        std::vector<float> matmulScalar(kernels::kMaxRows * n);
+        kernels::matmulRows(rows.data(), kernels::kMaxRows, n, panels.data(), n, matmulScalar.data());
+
+        double scalarNs[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        for (kernels::Isa isa : ISAS) {
+            if (!kernels::setIsa(isa)) continue;
+            const std::string suffix = std::to_string(n) + "_" + kernels::isaName(isa);
+
+            const float dotValue = kernels::dot(a.data(), b.data(), n);
+            check(std::fabs(dotValue - dotScalar) <= dotBound,
+                  "dot_" + suffix + " se aparta de la versión escalar más de la tolerancia");
+            std::vector<float> out(b);
+            kernels::axpy(0.5f, a.data(), out.data(), n);
+            check(out == axpyScalar, "axpy_" + suffix + " no coincide bit a bit con la escalar");
+            out = b;
+            kernels::mulAdd(a.data(), b.data(), out.data(), n);
+            check(out == mulAddScalar, "mulAdd_" + suffix + " no coincide bit a bit con la escalar");
+            out.assign(n * n, 0.25f);
+            kernels::outer(0.5f, a.data(), n, b.data(), n, out.data());
+            check(out == outerScalar, "outer_" + suffix + " no coincide bit a bit con la escalar");
+            kernels::matmulRows(rows.data(), kernels::kMaxRows, n, panels.data(), n, product.data());
+            check(product == matmulScalar,
+                  "matmulRows_" + suffix + " no coincide bit a bit con la escalar");
+
+            const std::function<void()> ops[5] = {
+                [&] { g_sink = kernels::dot(a.data(), b.data(), n); },
+                [&] {
+                    kernels::axpy(alpha, a.data(), y.data(), n);
+                    g_sink = y[0];
+                },
+                [&] {
+                    kernels::mulAdd(a.data(), b.data(), y.data(), n);
+                    g_sink = y[0];
+                },
+                [&] {
+                    kernels::outer(alpha, a.data(), n, b.data(), n, A.data());
+                    g_sink = A[0];
+                },
+                [&] {
+                    kernels::matmulRows(rows.data(), kernels::kMaxRows, n, panels.data(), n,
+                                        product.data());
+                    g_sink = product[0];
+                },
+            };
+            for (int k = 0; k < 5; ++k) {
+                const std::string name = std::string("kernel_") + names[k] + "_" + suffix;
+                if (!selected(options, name, none)) continue;
+                std::fill(y.begin(), y.end(), 0.0f);
+                results.push_back(measure(name, none, k >= 3 ? n * n : n, options, ops[k]));
+                if (isa == kernels::Isa::SCALAR) scalarNs[k] = results.back().nsPerOp;
+                if (scalarNs[k] > 0.0) results.back().speedup = scalarNs[k] / results.back().nsPerOp;
+                report(results.back());
+            }
+        }
+    }
+    kernels::setIsa(original);
+}
+
+const ActivationMode MODES[] = {ActivationMode::EXACT, ActivationMode::LUT,
+                                ActivationMode::RATIONAL, ActivationMode::HARD};
+const char* const MODE_NAMES[] = {"EXACT", "LUT", "RATIONAL", "HARD"};
+
+/**
+ * @brief Coste por valor de SIGMOID y TANH con cada modo, y `forward` de la red
+ *        del vehículo con cada modo.
+ */
+void benchmarkActivations(const Options& options, std::vector<Result>& results) {
+    const int n = 256;
+    std::vector<float> x = randomVector(n, -8.0f, 8.0f);
+    std::vector<float> y(n);
+    const std::vector<int> none;
+
+    for (int m = 0; m < 4; ++m) {
+        const ActivationMode mode = MODES[m];
+        const ActivationFunction funcs[] = {ActivationFunction::SIGMOID, ActivationFunction::TANH};
+        const char* const funcNames[] = {"sigmoid", "tanh"};
+        for (int f = 0; f < 2; ++f) {
+            std::string name = std::string("activation_") + funcNames[f] + "_" + MODE_NAMES[m];
+            if (!selected(options, name, none)) continue;
+            const ActivationFunction func = funcs[f];
+            results.push_back(measure(name, none, 0, options, [&] {
+                for (int i = 0; i < n; ++i) y[i] = applyActivation(x[i], func, mode);
+                g_sink = y[n - 1];
+            }, n));
+            report(results.back());
+        }
+    }
+
+    // Pila mixta: una activación distinta por capa, cada una con su núcleo
+    const std::vector<int> mixed = {16, 128, 128, 4};
+    NeuralNetwork mixedNet(mixed, {ActivationFunction::TANH, ActivationFunction::RELU,
+                                   ActivationFunction::LINEAR});
+    std::vector<float> mixedInput = randomVector(16, -1.0f, 1.0f);
+    float mixedOutput[4];
+    if (selected(options, "forward_ptr_mixed", mixed)) {
+        results.push_back(measure("forward_ptr_mixed", mixed, mixedNet.parameterCount(), options, [&] {
+            mixedNet.forward(mixedInput.data(), mixedOutput);
+            g_sink = mixedOutput[0];
+        }));
+        report(results.back());
+    }
+
+    const std::vector<int> topology = {4, 8, 4};
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    std::vector<float> input = randomVector(4, 0.0f, 100.0f);
+    float output[4];
+    for (int m = 0; m < 4; ++m) {
+        std::string name = std::string("forward_ptr_") + MODE_NAMES[m];
+        if (!selected(options, name, topology)) continue;
+        net.setActivationMode(MODES[m]);
+        results.push_back(measure(name, topology, net.parameterCount(), options, [&] {
+            net.forward(input.data(), output);
+            g_sink = output[0];
+        }));
+        report(results.back());
+    }
+}
+
+void benchmarkTopology(const std::vector<int>& topology, const Options& options,
+                       std::vector<Result>& results) {
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    const size_t inSize = topology.front();
+    const size_t outSize = topology.back();
+    const size_t parameters = net.parameterCount();
+
+    std::vector<std::vector<float>> weights;
+    std::vector<std::vector<float>> biases;
+    for (size_t l = 0; l + 1 < topology.size(); ++l) {
+        float scale = 1.0f / topology[l];
+        weights.push_back(randomVector(static_cast<size_t>(topology[l]) * topology[l + 1], -scale, scale));
+        biases.push_back(randomVector(topology[l + 1], -0.1f, 0.1f));
+    }
+    net.setWeights(weights, biases);
+
+    std::vector<float> input = randomVector(inSize, 0.0f, 100.0f);
+    std::vector<float> target = randomVector(outSize, 0.0f, 1.0f);
+    std::vector<float> output(outSize);
+    std::vector<float> prediction = randomVector(outSize, 0.05f, 0.95f);
+
+    std::vector<std::vector<float>> gradWeights;
+    std::vector<std::vector<float>> gradBiases;
+    net.computeGradients(input, target, gradWeights, gradBiases);
+
+    // Devuelve ns/op (0 si el filtro la excluye); con `referenceNs`, la aceleración
+    auto run = [&](const std::string& name, const std::function<void()>& op,
+                   uint64_t opsPerCall = 1, double referenceNs = 0.0) {
+        if (!selected(options, name, topology)) return 0.0;
+        results.push_back(measure(name, topology, parameters, options, op, opsPerCall));
+        if (referenceNs > 0.0) results.back().speedup = referenceNs / results.back().nsPerOp;
+        report(results.back());
+        return results.back().nsPerOp;
+    };
+
+    run("forward", [&] { g_sink = net.forward(input)[0]; });
+    // Por fila: op/s son filas/s, y forwardBatch lleva la aceleración respecto a forward_ptr
+    double rowNs = run("forward_ptr", [&] {
+        net.forward(input.data(), output.data());
+        g_sink = output[0];
+    });
+    const size_t batchRows = 64;
+    std::vector<float> batchInput = randomVector(batchRows * inSize, 0.0f, 100.0f);
+    std::vector<float> batchOutput(batchRows * outSize);
+    run("forwardBatch_64", [&] {
+        net.forwardBatch(batchInput.data(), batchRows, batchOutput.data());
+        g_sink = batchOutput[0];
+    }, batchRows, rowNs);
+    if (selected(options, "forwardBatch_64", topology)) {
+        // Debe coincidir bit a bit con `forward` fila a fila, también con filas sueltas
+        const size_t checkRows = batchRows + 3;
+        std::vector<float> checkInput = randomVector(checkRows * inSize, 0.0f, 100.0f);
+        std::vector<float> batched(checkRows * outSize);
+        std::vector<float> single(checkRows * outSize);
+        net.forwardBatch(checkInput.data(), checkRows, batched.data());
+        for (size_t row = 0; row < checkRows; row++) {
+            net.forward(checkInput.data() + row * inSize, single.data() + row * outSize);
+        }
+        check(batched == single, "forwardBatch " + topologyName(topology) +
+                                 " no coincide bit a bit con forward");
+    }
+    run("computeGradients", [&] {
+        net.computeGradients(input, target, gradWeights, gradBiases);
+        g_sink = gradWeights[0][0];
+    });
+    // Tasa 0: mide el coste sin que los pesos diverjan entre iteraciones
+    run("updateWeights", [&] { net.updateWeights(gradWeights, gradBiases, 0.0f); });
+    run("calculateError_MSE", [&] {
+        g_sink = net.calculateError(prediction, target, ErrorFunction::MSE);
+    });
+    run("calculateError_MAE", [&] {
+        g_sink = net.calculateError(prediction, target, ErrorFunction::MAE);
+    });
+    run("calculateError_CROSS_ENTROPY", [&] {
+        g_sink = net.calculateError(prediction, target, ErrorFunction::CROSS_ENTROPY);
+    });
+    run("setWeights", [&] { net.setWeights(weights, biases); });
+
+    // Carga y guardado con el orden plano, y un paso completo del optimizador
+    std::vector<float> flat(parameters);
+    const std::vector<float> zeros(parameters, 0.0f);
+    run("copyParameters", [&] {
+        net.copyParameters(flat.data());
+        g_sink = flat[0];
+    });
+    run("setParameters", [&] { net.setParameters(flat.data()); });
+    run("addToParameters", [&] { net.addToParameters(zeros.data()); });
+    TrainerConfig config;
+    config.learningRate = 0.0f;
+    Trainer trainer(net, config);
+    run("trainBatch_ADAM_1", [&] { g_sink = trainer.trainBatch(input.data(), target.data(), 1); });
+}
+
+/**
+ * @brief `forward` denso frente a `SparseNetwork` con distintos grados de poda.
+ *        La referencia densa es `forward_ptr` de `benchmarkTopology`: su coste no
+ *        depende de cuántos pesos sean cero.
+ */
+void benchmarkSparse(const std::vector<int>& topology, const Options& options,
+                     std::vector<Result>& results) {
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    std::vector<std::vector<float>> weights;
+    std::vector<std::vector<float>> biases;
+    for (size_t l = 0; l + 1 < topology.size(); ++l) {
+        float scale = 1.0f / topology[l];
+        weights.push_back(randomVector(static_cast<size_t>(topology[l]) * topology[l + 1], -scale, scale));
+        biases.push_back(randomVector(topology[l + 1], -0.1f, 0.1f));
+    }
+
+    std::vector<float> input = randomVector(topology.front(), 0.0f, 100.0f);
+    std::vector<float> output(topology.back());
+    const int levels[] = {0, 50, 75, 90};
+    for (int level : levels) {
+        std::string name = "forward_sparse_" + std::to_string(level);
+        if (!selected(options, name, topology)) continue;
+        net.setWeights(weights, biases);
+        pruneByMagnitude(net, level / 100.0f);
+        SparseNetwork sparse = SparseNetwork::fromNetwork(net);
+        results.push_back(measure(name, topology, sparse.nonZeros(), options, [&] {
+            sparse.forward(input.data(), output.data());
+            g_sink = output[0];
+        }));
+        results.back().modelBytes = sparse.parameterBytes();
+        report(results.back());
+    }
+}
+
+/**
+ * @brief Inserción y muestreo de `ReplayBuffer` lleno, y un paso de repaso (muestreo,
+ *        `Trainer::trainBatch` y actualización de prioridades) sobre la red {4,8,4}.
+ *        `model_bytes` es la memoria del búfer.
+ */
+void benchmarkReplay(const Options& options, std::vector<Result>& results) {
+    const std::vector<int> topology = {4, 8, 4};
+    const size_t batch = 8;
+    const size_t budgets[] = {4096, 65536};
+    const ReplaySampling samplings[] = {ReplaySampling::UNIFORM, ReplaySampling::PRIORITIZED};
+    const char* const samplingNames[] = {"UNIFORM", "PRIORITIZED"};
+
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    TrainerConfig config;
+    config.optimizer = Optimizer::SGD;
+    config.learningRate = 0.0f;  // Mide el coste sin que los pesos diverjan
+    Trainer trainer(net, config);
+
+    std::vector<float> inputs = randomVector(1024 * 4, 0.0f, 100.0f);
+    std::vector<float> targets = randomVector(1024 * 4, 0.0f, 1.0f);
+    std::vector<float> losses = randomVector(1024, 0.0f, 0.5f);
+    float batchLosses[batch];
+
+    for (size_t budget : budgets) {
+        for (int m = 0; m < 2; ++m) {
+            const std::string suffix = std::string(samplingNames[m]) + "_" +
+                                       std::to_string(budget / 1024) + "KB";
+            ReplayBuffer replay(4, 4, budget, batch, samplings[m]);
+            size_t row = 0;
+            auto pushNext = [&] {
+                replay.push(&inputs[row * 4], &targets[row * 4], losses[row]);
+                row = (row + 1) & 1023;
+            };
+            while (replay.size() < replay.capacity()) pushNext();
+
+            auto run = [&](const std::string& name, const std::function<void()>& op, uint64_t opsPerCall) {
+                if (!selected(options, name, topology)) return;
+                results.push_back(measure(name, topology, replay.capacity(), options, op, opsPerCall));
+                results.back().modelBytes = replay.memoryBytes();
+                report(results.back());
+            };
+
+            run("replay_push_" + suffix, pushNext, 1);
+            run("replay_sample_8_" + suffix, [&] {
+                g_sink = static_cast<float>(replay.sample(batch).indices[0]);
+            }, 1);
+            run("replay_train_8_" + suffix, [&] {
+                ReplayBatch lote = replay.sample(batch);
+                trainer.trainBatch(lote.inputs, lote.targets, lote.indices, lote.count, batchLosses);
+                replay.updatePriorities(lote, batchLosses);
+                g_sink = batchLosses[0];
+            }, 1);
+        }
+    }
+}
+
+/**
+ * @brief K redes {4,8,4} con pesos perturbados: `Population` frente a un bucle de K
+ *        `NeuralNetwork`. Los resultados son por evaluación de una red (una fila).
+ */
+void benchmarkPopulation(const Options& options, std::vector<Result>& results) {
+    const std::vector<int> topology = {4, 8, 4};
+    const size_t sizes[] = {64, 256};
+    const size_t numRows = 100;
+    const size_t numThreads = std::max(2u, std::thread::hardware_concurrency());
+    ThreadPool pool(numThreads);
+
+    std::vector<float> trace = randomVector(numRows * 4, 0.0f, 100.0f);
+    std::vector<float> targets = randomVector(numRows * 4, 0.0f, 1.0f);
+
+    for (size_t K : sizes) {
+        Population population(topology, K);
+        std::vector<NeuralNetwork> networks(K, NeuralNetwork(topology));
+        for (size_t k = 0; k < K; ++k) {
+            std::vector<std::vector<float>> weights = {randomVector(32, -0.25f, 0.25f),
+                                                       randomVector(32, -0.125f, 0.125f)};
+            std::vector<std::vector<float>> biases = {randomVector(8, -0.1f, 0.1f),
+                                                      randomVector(4, -0.1f, 0.1f)};
+            networks[k].setWeights(weights, biases);
+            population.setMember(k, networks[k]);
+        }
+        std::vector<float> outputs(K * 4);
+        std::vector<float> losses(K);
+        const size_t parameters = population.parameterCount() * K;
+
+        auto run = [&](const std::string& name, const std::function<void()>& op, uint64_t opsPerCall) {
+            if (!selected(options, name, topology)) return;
+            results.push_back(measure(name, topology, parameters, options, op, opsPerCall));
+            report(results.back());
+        };
+        const std::string suffix = std::to_string(K);
+
+        run("population_forward_" + suffix, [&] {
+            population.forward(&trace[0], outputs.data());
+            g_sink = outputs[0];
+        }, K);
+        run("network_loop_forward_" + suffix, [&] {
+            for (size_t k = 0; k < K; ++k) {
+                networks[k].forward(&trace[0], &outputs[k * 4]);
+            }
+            g_sink = outputs[0];
+        }, K);
+        run("population_evaluate_" + suffix, [&] {
+            population.evaluate(trace.data(), targets.data(), numRows, ErrorFunction::MSE, losses.data());
+            g_sink = losses[0];
+        }, K * numRows);
+        run("population_evaluate_" + suffix + "_t" + std::to_string(numThreads), [&] {
+            population.evaluate(trace.data(), targets.data(), numRows, ErrorFunction::MSE,
+                                losses.data(), &pool);
+            g_sink = losses[0];
+        }, K * numRows);
+        run("network_loop_evaluate_" + suffix, [&] {
+            for (size_t k = 0; k < K; ++k) {
+                float loss = 0.0f;
+                for (size_t r = 0; r < numRows; ++r) {
+                    float output[4];
+                    networks[k].forward(&trace[r * 4], output);
+                    float rowError = 0.0f;
+                    for (int j = 0; j < 4; ++j) {
+                        float error = output[j] - targets[r * 4 + j];
+                        rowError += error * error;
+                    }
+                    loss += rowError / 4;
+                }
+                losses[k] = loss / numRows;
+            }
+            g_sink = losses[0];
+        }, K * numRows);
+    }
+}
+
+const Optimizer OPTIMIZERS[] = {Optimizer::SGD, Optimizer::MOMENTUM, Optimizer::ADAM};
+const char* const OPTIMIZER_NAMES[] = {"SGD", "MOMENTUM", "ADAM"};
+// Tasas con las que cada optimizador llega al objetivo del dataset de maestro
+const float LEARNING_RATES[] = {0.5f, 0.05f, 0.01f};
+
+/**
+ * @brief Dataset con semilla fija: entradas uniformes en [0, 1] y como objetivos las
+ *        salidas de una red "maestra" de la misma topología con pesos en [-2, 2].
+ *        Las redes alumnas parten de `initial` (pesos en [-0.5, 0.5]).
+ */
+struct TeacherDataset {
+    std::vector<float> inputs;
+    std::vector<float> targets;
+    std::vector<float> initial;
+};
+
+TeacherDataset teacherDataset(const std::vector<int>& topology, size_t count) {
+    g_rng = 0x2468ace1u;
+    NeuralNetwork teacher(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    teacher.setParameters(randomVector(teacher.parameterCount(), -2.0f, 2.0f).data());
+
+    TeacherDataset data;
+    data.inputs = randomVector(count * topology.front(), 0.0f, 1.0f);
+    data.targets.resize(count * topology.back());
+    for (size_t r = 0; r < count; ++r) {
+        teacher.forward(&data.inputs[r * topology.front()], &data.targets[r * topology.back()]);
+    }
+    data.initial = randomVector(teacher.parameterCount(), -0.5f, 0.5f);
+    return data;
+}
+
+TrainerConfig trainerConfig(int optimizer, size_t batchSize) {
+    TrainerConfig config;
+    config.optimizer = OPTIMIZERS[optimizer];
+    config.learningRate = LEARNING_RATES[optimizer];
+    config.batchSize = batchSize;
+    config.seed = 1;
+    return config;
+}
+
+/**
+ * @brief Muestras/s de `Trainer::trainEpoch` (ns/op por muestra) y, para la red del
+ *        vehículo, `Trainer::fit` hasta `targetMse` desde los mismos pesos
+ *        iniciales: ns/op es el tiempo total y `epochs` las épocas necesarias (sin
+ *        `epochs` y con la comprobación fallida si no converge).
+ */
+void benchmarkTraining(const Options& options, std::vector<Result>& results) {
+    const size_t numSamples = 512;
+    const size_t batchSize = 32;
+    const std::vector<std::vector<int>> topologies = {{4, 8, 4}, {4, 64, 64, 4}};
+
+    for (const std::vector<int>& topology : topologies) {
+        TeacherDataset data = teacherDataset(topology, numSamples);
+        for (int o = 0; o < 3; ++o) {
+            const std::string name = std::string("trainEpoch_") + OPTIMIZER_NAMES[o] + "_" +
+                                     std::to_string(batchSize);
+            if (!selected(options, name, topology)) continue;
+            NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            net.setParameters(data.initial.data());
+            Trainer trainer(net, trainerConfig(o, batchSize));
+            results.push_back(measure(name, topology, net.parameterCount(), options, [&] {
+                g_sink = trainer.trainEpoch(data.inputs, data.targets);
+            }, numSamples));
+            report(results.back());
+        }
+    }
+
+    const std::vector<int> topology = {4, 8, 4};
+    const float targetMse = 0.001f;
+    const size_t maxEpochs = 5000;
+    TeacherDataset data = teacherDataset(topology, numSamples);
+    for (int o = 0; o < 3; ++o) {
+        const std::string name = std::string("fit_") + OPTIMIZER_NAMES[o];
+        if (!selected(options, name, topology)) continue;
+        // Cada llamada dura cientos de ms: mediana de `repeat` llamadas, sin calibrar
+        size_t epochs = 0;
+        float mse = 0.0f;
+        uint64_t allocs = 0;
+        uint64_t bytes = 0;
+        std::vector<double> samples;
+        for (int r = 0; r < options.repeat; ++r) {
+            uint64_t count0 = g_allocCount;
+            uint64_t bytes0 = g_allocBytes;
+            Clock::time_point start = Clock::now();
+            NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            net.setParameters(data.initial.data());
+            Trainer trainer(net, trainerConfig(o, batchSize));
+            epochs = trainer.fit(data.inputs, data.targets, maxEpochs, targetMse);
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            allocs = g_allocCount - count0;
+            bytes = g_allocBytes - bytes0;
+            mse = trainer.evaluate(data.inputs, data.targets);
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+
+        Result result;
+        result.name = name;
+        result.topology = topology;
+        result.parameters = data.initial.size();
+        result.modelBytes = result.parameters * sizeof(float);
+        result.iterations = options.repeat;
+        result.nsPerOp = samples[samples.size() / 2];
+        result.allocsPerOp = static_cast<double>(allocs);
+        result.bytesPerOp = static_cast<double>(bytes);
+        result.epochs = epochs;
+        results.push_back(result);
+        report(results.back());
+        check(epochs > 0 && mse <= targetMse, name + " no llega al MSE objetivo en " +
+                                                  std::to_string(maxEpochs) + " épocas");
+    }
+}
+
+/**
+ * @brief `ParallelTrainer::trainEpoch` sobre {16,128,16} en lotes de 256 con 1, 2,
+ *        4... hasta `hardware_concurrency` hilos: ns/op por muestra y aceleración
+ *        respecto a un hilo. Después, con 1, 2, 4 y `hardware_concurrency` hilos
+ *        (aunque haya menos núcleos), dos entrenamientos de 3 épocas con la misma
+ *        semilla deben dejar exactamente los mismos parámetros.
+ */
+void benchmarkParallel(const Options& options, std::vector<Result>& results) {
+    const std::vector<int> topology = {16, 128, 16};
+    const size_t numSamples = 2048;
+    const size_t batchSize = 256;
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    TeacherDataset data = teacherDataset(topology, numSamples);
+
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < hardware; t *= 2) counts.push_back(t);
+    counts.push_back(hardware);
+
+    double singleNs = 0.0;
+    for (size_t threads : counts) {
+        const std::string name = "parallel_trainEpoch_t" + std::to_string(threads);
+        if (!selected(options, name, topology)) continue;
+        NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+        net.setParameters(data.initial.data());
+        ParallelTrainer trainer(net, threads, trainerConfig(2, batchSize));
+        results.push_back(measure(name, topology, net.parameterCount(), options, [&] {
+            g_sink = trainer.trainEpoch(data.inputs, data.targets);
+        }, numSamples));
+        if (threads == 1) singleNs = results.back().nsPerOp;
+        if (singleNs > 0.0) results.back().speedup = singleNs / results.back().nsPerOp;
+        report(results.back());
+    }
+
+    if (!selected(options, "parallel_determinism", topology)) return;
+    std::vector<size_t> checked = {1, 2, 4, hardware};
+    std::sort(checked.begin(), checked.end());
+    checked.erase(std::unique(checked.begin(), checked.end()), checked.end());
+    for (size_t threads : checked) {
+        std::vector<float> parameters[2];
+        for (int run = 0; run < 2; ++run) {
+            NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            net.setParameters(data.initial.data());
+            ParallelTrainer trainer(net, threads, trainerConfig(2, batchSize));
+            for (int epoch = 0; epoch < 3; ++epoch) {
+                trainer.trainEpoch(data.inputs, data.targets);
+            }
+            parameters[run].resize(net.parameterCount());
+            net.copyParameters(parameters[run].data());
+        }
+        bool identical = std::memcmp(parameters[0].data(), parameters[1].data(),
+                                     parameters[0].size() * sizeof(float)) == 0;
+        std::fprintf(stderr, "parallel_determinism_t%-4zu %-22s %s\n", threads,
+                     topologyName(topology).c_str(), identical ? "idénticos" : "DISTINTOS");
+        check(identical, "ParallelTrainer con " + std::to_string(threads) +
+                             " hilos no es determinista");
+    }
+}
+
+void writeJson(FILE* out, const std::vector<Result>& results) {
+    std::fprintf(out, "{\n  \"schema\": 2,\n");
+#ifdef __VERSION__
+    std::fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    std::fprintf(out, "  \"isa\": \"%s\",\n", kernels::isaName(kernels::activeIsa()));
+    std::fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(out, "    {\"name\": \"%s\", \"topology\": [", r.name.c_str());
+        for (size_t l = 0; l < r.topology.size(); ++l) {
+            std::fprintf(out, "%s%d", l ? ", " : "", r.topology[l]);
+        }
+        std::fprintf(out,
+                     "], \"parameters\": %zu, \"iterations\": %llu, \"ns_per_op\": %.2f,"
+                     " \"ops_per_s\": %.1f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f,"
+                     " \"model_bytes\": %zu",
+                     r.parameters, static_cast<unsigned long long>(r.iterations), r.nsPerOp,
+                     r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0, r.allocsPerOp, r.bytesPerOp,
+                     r.modelBytes);
+        if (r.speedup > 0.0) std::fprintf(out, ", \"speedup\": %.3f", r.speedup);
+        if (r.epochs > 0) std::fprintf(out, ", \"epochs\": %zu", r.epochs);
+        std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Uso: %s [--filter texto] [--min-time ms] [--repeat N] [--output archivo.json]\n",
+                 program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--filter") && hasValue) {
+            options.filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--min-time") && hasValue) {
+            options.minTimeMs = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--repeat") && hasValue) {
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--output") && hasValue) {
+            options.output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    // {4,8,4} es la red del vehículo; el resto barre anchura y profundidad.
+    const std::vector<std::vector<int>> topologies = {
+        {4, 8, 4},
+        {4, 32, 4},
+        {4, 64, 64, 4},
+        {4, 16, 16, 16, 16, 4},
+        {16, 128, 16},
+        {32, 256, 256, 8},
+    };
+
+    std::vector<Result> results;
+    for (const std::vector<int>& topology : topologies) {
+        benchmarkTopology(topology, options, results);
+    }
+    benchmarkActivations(options, results);
+    for (const std::vector<int>& topology : topologies) {
+        benchmarkSparse(topology, options, results);
+    }
+    benchmarkReplay(options, results);
+    benchmarkPopulation(options, results);
+    benchmarkTraining(options, results);
+    benchmarkParallel(options, results);
+    benchmarkKernels(options, results);
+
+    FILE* out = stdout;
+    if (options.output != nullptr) {
+        out = std::fopen(options.output, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "No se pudo escribir %s\n", options.output);
+            return 1;
+        }
+    }
+    writeJson(out, results);
+    if (out != stdout) std::fclose(out);
+    return g_ok ? 0 : 1;
+}
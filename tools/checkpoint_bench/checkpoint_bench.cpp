@@ -0,0 +1,350 @@
+// -----------------------------------------------------------------------------
+// Medidas y pruebas de CheckpointLog (herramienta de PC, no se compila para el ESP32)
+//
+// 1. Tamaño: entrena en línea la red del vehículo {4,8,4} (y una más ancha) con
+//    entradas aleatorias, guarda un punto de control cada `--pasos` pasos y mide los
+//    bytes por punto de control con deltas XOR y cuantizados frente a guardar todos
+//    los parámetros, las compactaciones y el tiempo de `restore` desde archivo
+//    (FileCheckpointStorage en el directorio temporal). Comprueba que lo restaurado
+//    coincide con la red: exacto con XOR, con error <= paso / 2 cuantizado.
+// 2. Cortes de corriente: con un medio que deja de escribir tras N bytes, corta
+//    la escritura de un delta y de una compactación a medias, "reinicia" y comprueba
+//    que `restore` devuelve el último estado completo y que el registro sigue
+//    funcionando después.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude tools/checkpoint_bench/checkpoint_bench.cpp
+//       src/Checkpoint.cpp src/Crc32.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp -o checkpoint_bench
+//
+// Uso:
+//   ./checkpoint_bench [--puntos 200] [--pasos 100] [--paso-cuantizado 1e-4]
+//
+// Devuelve 1 si alguna comprobación falla.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "NeuralNetwork.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static bool g_ok = true;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FALLO: %s\n", what);
+        g_ok = false;
+    }
+}
+
+static std::vector<float> parametersOf(const NeuralNetwork& net) {
+    std::vector<float> p(net.parameterCount());
+    net.copyParameters(p.data());
+    return p;
+}
+
+/**
+ * @brief Carga pesos aleatorios propios (restore necesita pesos propios).
+ */
+static void randomize(NeuralNetwork& net, const std::vector<int>& topology, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<std::vector<float>> weights, biases;
+    for (size_t l = 0; l + 1 < topology.size(); l++) {
+        weights.emplace_back(topology[l] * topology[l + 1]);
+        biases.emplace_back(topology[l + 1]);
+        for (float& w : weights.back()) w = dist(rng);
+        for (float& b : biases.back()) b = dist(rng);
+    }
+    net.setWeights(weights, biases);
+}
+
+/**
+ * @brief `steps` pasos de entrenamiento con muestras aleatorias normalizadas.
+ */
+static void train(NeuralNetwork& net, const std::vector<int>& topology, std::mt19937& rng,
+                  int steps) {
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> input(topology.front());
+    std::vector<float> target(topology.back());
+    for (int s = 0; s < steps; s++) {
+        for (float& x : input) x = dist(rng);
+        for (float& t : target) t = dist(rng) > 0.5f ? 1.0f : 0.0f;
+        net.trainStep(input.data(), target.data(), 0.01f);
+    }
+}
+
+/**
+ * @brief Completa la compactación pendiente. Con el medio "apagado" nunca termina,
+ *        así que se limita el número de pasos.
+ */
+static void drain(CheckpointLog& log, int maxSteps = 100000) {
+    for (int step = 0; step < maxSteps && !log.compactStep(); step++) {
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 1. Tamaño de los puntos de control y tiempo de restauración
+// -----------------------------------------------------------------------------
+
+static void sizeTest(const std::vector<int>& topology, DeltaEncoding encoding, int numCheckpoints,
+                     int stepsPerCheckpoint, float quantStep) {
+    const std::string base = std::string(P_tmpdir) + "/checkpoint_bench";
+    const std::string pathA = base + "_a.bin";
+    const std::string pathB = base + "_b.bin";
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    randomize(net, topology, 1);
+    const size_t n = net.parameterCount();
+    const size_t fullBytes = 12 + n * sizeof(float);
+    // Región de ~32 bases completas, redondeada a sectores de 4 KB
+    const size_t regionSize = ((32 * fullBytes + 20) / 4096 + 1) * 4096;
+
+    CheckpointConfig config;
+    config.encoding = encoding;
+    config.quantStep = quantStep;
+
+    std::mt19937 rng(2);
+    uint64_t deltaBytes = 0;
+    size_t maxBytes = 0;
+    CheckpointStats stats;
+    {
+        FileCheckpointStorage storage(pathA.c_str(), pathB.c_str(), regionSize);
+        CheckpointLog log(storage, n, config);
+        log.reset(net);
+        drain(log);
+        for (int c = 0; c < numCheckpoints; c++) {
+            train(net, topology, rng, stepsPerCheckpoint);
+            uint32_t before = log.stats().checkpoints;
+            check(log.checkpoint(net), "punto de control pospuesto sin compactación en curso");
+            if (log.stats().checkpoints != before) {
+                deltaBytes += log.stats().lastBytes;
+                maxBytes = std::max(maxBytes, log.stats().lastBytes);
+            }
+            // Los ratos libres de loop() bastan para terminar la compactación
+            drain(log);
+        }
+        stats = log.stats();
+    }
+
+    // "Reinicio": otra red y otro registro sobre los mismos archivos
+    FileCheckpointStorage storage(pathA.c_str(), pathB.c_str(), regionSize);
+    CheckpointLog log(storage, n, config);
+    NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    randomize(restored, topology, 3);
+    Clock::time_point start = Clock::now();
+    bool ok = log.restore(restored);
+    double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    check(ok, "restore no encontró ninguna región válida");
+
+    std::vector<float> expected = parametersOf(net);
+    std::vector<float> actual = parametersOf(restored);
+    float maxError = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        maxError = std::max(maxError, std::fabs(expected[i] - actual[i]));
+    }
+    if (encoding == DeltaEncoding::XOR) {
+        check(std::memcmp(expected.data(), actual.data(), n * sizeof(float)) == 0,
+              "la restauración XOR no es exacta");
+    } else {
+        check(maxError <= quantStep * 0.5f * 1.001f, "error de la restauración cuantizada > paso / 2");
+    }
+
+    std::string name;
+    for (size_t l = 0; l < topology.size(); l++) {
+        name += (l ? "," : "{") + std::to_string(topology[l]);
+    }
+    name += "}";
+    const double average = stats.checkpoints ? static_cast<double>(deltaBytes) / stats.checkpoints : 0.0;
+    std::printf("  %-12s %-11s %6zu %6u %9.1f %6zu %7zu %6.1f %%  %5u %8.1f %10.2e\n",
+                name.c_str(), encoding == DeltaEncoding::XOR ? "XOR" : "cuantizado", n,
+                stats.checkpoints, average, maxBytes, fullBytes, 100.0 * average / fullBytes,
+                stats.compactions, micros, maxError);
+
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+}
+
+// -----------------------------------------------------------------------------
+// 2. Cortes de corriente
+// -----------------------------------------------------------------------------
+
+/**
+ * @class PowerCutStorage
+ * @brief Medio en RAM que, tras `cutAfter` bytes escritos, deja de escribir y de
+ *        borrar (la escritura en curso queda a medias), como un corte de corriente.
+ */
+class PowerCutStorage : public CheckpointStorage {
+public:
+    explicit PowerCutStorage(size_t regionSize) : m_memory(regionSize) {}
+
+    size_t regionSize() const override { return m_memory.regionSize(); }
+    size_t sectorSize() const override { return m_memory.sectorSize(); }
+
+    bool read(int region, size_t offset, void* data, size_t size) override {
+        return m_memory.read(region, offset, data, size);
+    }
+
+    bool write(int region, size_t offset, const void* data, size_t size) override {
+        if (m_budget >= 0) {
+            size_t allowed = std::min(size, static_cast<size_t>(m_budget));
+            m_memory.write(region, offset, data, allowed);
+            m_budget -= static_cast<long>(allowed);
+            if (allowed < size) {
+                return false;
+            }
+            return true;
+        }
+        return m_memory.write(region, offset, data, size);
+    }
+
+    bool eraseSector(int region, size_t sector) override {
+        return m_budget != 0 && m_memory.eraseSector(region, sector);
+    }
+
+    void cutAfter(long bytes) { m_budget = bytes; }
+    void powerOn() { m_budget = -1; }
+
+private:
+    MemoryCheckpointStorage m_memory;
+    long m_budget = -1;  // -1 = sin corte
+};
+
+static bool sameParameters(const NeuralNetwork& a, const std::vector<float>& expected) {
+    std::vector<float> p = parametersOf(a);
+    return std::memcmp(p.data(), expected.data(), p.size() * sizeof(float)) == 0;
+}
+
+static void powerCutTest() {
+    const std::vector<int> topology = {4, 8, 4};
+    NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    randomize(net, topology, 4);
+    const size_t n = net.parameterCount();
+    PowerCutStorage storage(4096);
+    std::mt19937 rng(5);
+    int failures = 0;
+    auto expect = [&](bool condition, const char* what) {
+        check(condition, what);
+        failures += condition ? 0 : 1;
+    };
+
+    // Sin nada guardado no hay nada que restaurar
+    {
+        CheckpointLog log(storage, n);
+        NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+        randomize(restored, topology, 6);
+        expect(!log.restore(restored), "restore aceptó un medio vacío");
+        log.reset(net);
+        drain(log);
+        train(net, topology, rng, 50);
+        expect(log.checkpoint(net), "primer punto de control");
+    }
+    std::vector<float> saved = parametersOf(net);
+
+    // Delta cortado a mitad: se recupera el anterior y se compacta a la otra región
+    for (long cut : {0L, 5L, 12L, 40L}) {
+        {
+            CheckpointLog log(storage, n);
+            NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            randomize(restored, topology, 6);
+            expect(log.restore(restored) && sameParameters(restored, saved), "restore antes del corte");
+            drain(log);
+            train(net, topology, rng, 50);
+            storage.cutAfter(cut);
+            log.checkpoint(net);
+            storage.powerOn();
+        }
+        CheckpointLog log(storage, n);
+        NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+        randomize(restored, topology, 6);
+        expect(log.restore(restored) && sameParameters(restored, saved), "restore tras cortar un delta");
+        drain(log);
+        expect(log.ready(), "el registro no queda listo tras un corte");
+        // Después del corte se puede seguir guardando
+        expect(log.checkpoint(restored), "punto de control tras el corte");
+        net.setParameters(saved.data());
+    }
+
+    // Compactación cortada en cada punto (borrado, cabeceras, base): la región
+    // anterior sigue siendo la válida
+    uint32_t cuts = 0;
+    for (long cut = 0; cut <= 400; cut += 16) {
+        {
+            CheckpointLog log(storage, n);
+            NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            randomize(restored, topology, 6);
+            expect(log.restore(restored), "restore antes de compactar");
+            drain(log);
+            saved = parametersOf(restored);
+            train(restored, topology, rng, 20);
+            storage.cutAfter(cut);
+            log.reset(restored);  // Compactación hacia la otra región
+            drain(log, 1000);
+            storage.powerOn();
+            cuts++;
+        }
+        CheckpointLog log(storage, n);
+        NeuralNetwork restored(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+        randomize(restored, topology, 6);
+        // Si la compactación terminó se restaura lo nuevo; si no, exactamente lo anterior
+        bool ok = log.restore(restored);
+        std::vector<float> now = parametersOf(restored);
+        expect(ok, "restore tras cortar una compactación");
+        if (cut < 32 + static_cast<long>(n * sizeof(float))) {
+            expect(std::memcmp(now.data(), saved.data(), n * sizeof(float)) == 0,
+                   "una compactación incompleta cambió el estado restaurado");
+        }
+    }
+
+    std::printf("Cortes de corriente: 4 deltas y %u compactaciones cortadas, %d fallos\n", cuts, failures);
+}
+
+int main(int argc, char** argv) {
+    int numCheckpoints = 200;
+    int stepsPerCheckpoint = 100;
+    float quantStep = 1e-4f;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--puntos") && hasValue) {
+            numCheckpoints = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--pasos") && hasValue) {
+            stepsPerCheckpoint = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--paso-cuantizado") && hasValue) {
+            quantStep = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Uso: %s [--puntos 200] [--pasos 100] [--paso-cuantizado 1e-4]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    if (!(quantStep > 0.0f)) {
+        std::fprintf(stderr, "El paso cuantizado debe ser positivo.\n");
+        return 2;
+    }
+
+    std::printf("Puntos de control cada %d pasos de entrenamiento (%d puntos):\n", stepsPerCheckpoint,
+                numCheckpoints);
+    std::printf("  %-12s %-11s %6s %6s %9s %6s %7s %8s  %5s %8s %10s\n", "topología", "delta",
+                "param.", "puntos", "B/punto", "max", "B base", "relat.", "comp.", "rest. us",
+                "error max");
+    for (const std::vector<int>& topology : {std::vector<int>{4, 8, 4}, std::vector<int>{16, 64, 16}}) {
+        sizeTest(topology, DeltaEncoding::XOR, numCheckpoints, stepsPerCheckpoint, quantStep);
+        sizeTest(topology, DeltaEncoding::QUANTIZED, numCheckpoints, stepsPerCheckpoint, quantStep);
+    }
+
+    powerCutTest();
+
+    std::printf("%s\n", g_ok ? "OK" : "FALLO");
+    return g_ok ? 0 : 1;
+}
@@ -0,0 +1,371 @@
+// -----------------------------------------------------------------------------
+// Reproducción de trazas con InferenceCache (herramienta de PC, no se compila para
+// el ESP32)
+//
+// 1. Lee las entradas de una captura binaria de telemetría (registros de
+//    Telemetry.h, p.ej. la de la simulación) o, sin archivo, genera una traza de
+//    crucero: sin eco durante tramos largos y distancias estables con ruido.
+// 2. Para varias resoluciones de cuantización (distancias en cm, duraciones en s)
+//    reproduce la traza con la red de 'pesos_red_neuronal.h' y compara
+//    `forward` + `findClosestMatch` en cada ciclo con `InferenceCache::infer`:
+//    tasa de aciertos, ns por ciclo, forwards ahorrados, y cuántas acciones y qué
+//    error de salida introduce cuantizar frente a la entrada sin redondear.
+// 3. Comprobaciones: la salida de la caché es idéntica bit a bit a `forward` sobre
+//    la entrada cuantizada (aciertos y fallos, también con una tabla pequeña que
+//    obliga a sustituir entradas); `setWeights` invalida la tabla; y con
+//    entrenamiento en línea (`backward` tras cada ciclo, como en main.cpp) nunca
+//    se devuelve una salida de parámetros anteriores.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/inference_cache_bench/inference_cache_bench.cpp src/InferenceCache.cpp
+//       src/NeuralNetwork.cpp src/Kernels.cpp src/Activations.cpp src/Actions.cpp
+//       src/Crc32.cpp -o inference_cache_bench
+//
+// Uso:
+//   ./inference_cache_bench [--traza captura.bin] [--capacidad 64] [--repeticiones 20]
+//
+// Devuelve 1 si alguna comprobación falla.
+// -----------------------------------------------------------------------------
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Actions.h"
+#include "Crc32.h"
+#include "InferenceCache.h"
+#include "NeuralNetwork.h"
+#include "Telemetry.h"
+#include "pesos_red_neuronal.h"
+
+namespace {
+
+const size_t INPUTS = 4;
+const size_t OUTPUTS = 4;
+
+bool g_ok = true;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FALLO: %s\n", what);
+        g_ok = false;
+    }
+}
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+float uniform(uint32_t& state) {
+    return static_cast<float>(nextRandom(state) & 0xFFFFFF) / 16777216.0f;
+}
+
+/**
+ * @brief Entradas de los registros con CRC correcto; se resincroniza tras bytes
+ *        corruptos buscando la palabra de sincronismo.
+ */
+bool readTrace(const char* path, std::vector<float>& rows) {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + n);
+    std::fclose(file);
+
+    size_t pos = 0;
+    while (pos + sizeof(TelemetryRecord) <= data.size()) {
+        TelemetryRecord record;
+        std::memcpy(&record, &data[pos], sizeof(record));
+        if (record.sync != TELEMETRY_SYNC || record.version != TELEMETRY_VERSION ||
+            crc32(&record, TELEMETRY_CRC_OFFSET) != record.crc) {
+            pos++;
+            continue;
+        }
+        rows.insert(rows.end(), record.inputs, record.inputs + INPUTS);
+        pos += sizeof(TelemetryRecord);
+    }
+    return true;
+}
+
+/**
+ * @brief Traza de crucero a 40 Hz: tramos sin eco (-1) en los que la duración crece
+ *        desde la última lectura, y tramos con una pared a distancia casi constante.
+ */
+std::vector<float> syntheticTrace(size_t count) {
+    std::vector<float> rows;
+    rows.reserve(count * INPUTS);
+    uint32_t rng = 2024;
+    float wall[2] = { 60.0f, 60.0f };
+    float sinceEcho[2] = { 0.0f, 0.0f };
+    bool echo[2] = { false, false };
+    for (size_t k = 0; k < count; ++k) {
+        for (int s = 0; s < 2; ++s) {
+            if (nextRandom(rng) % 200 == 0) {
+                echo[s] = !echo[s];
+                wall[s] = 20.0f + 200.0f * uniform(rng);
+            }
+            if (echo[s]) {
+                wall[s] += (uniform(rng) - 0.5f) * 0.6f;
+                sinceEcho[s] = 0.0f;
+            } else {
+                sinceEcho[s] += 0.025f;
+            }
+        }
+        rows.push_back(echo[0] ? wall[0] : -1.0f);
+        rows.push_back(echo[1] ? wall[1] : -1.0f);
+        rows.push_back(sinceEcho[0]);
+        rows.push_back(sinceEcho[1]);
+    }
+    return rows;
+}
+
+void loadDeployedWeights(NeuralNetwork& net) {
+    net.setWeights({std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+                    std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+                   {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+                    std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+}
+
+std::vector<float> resolutionFor(float distanceCm, float durationS) {
+    return { distanceCm, distanceCm, durationS, durationS };
+}
+
+void snap(const float* input, const std::vector<float>& resolution, float* snapped) {
+    for (size_t i = 0; i < INPUTS; ++i) snapped[i] = std::nearbyint(input[i] / resolution[i]) * resolution[i];
+}
+
+bool sameBits(const float* a, const float* b, size_t n) {
+    return std::memcmp(a, b, n * sizeof(float)) == 0;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+volatile int g_sink;
+
+/**
+ * @brief ns por ciclo sin caché: `forward` + `findClosestMatch` sobre la entrada tal cual.
+ */
+double timeUncached(NeuralNetwork& net, const std::vector<float>& rows, int repeats) {
+    size_t count = rows.size() / INPUTS;
+    float output[OUTPUTS];
+    int acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (size_t k = 0; k < count; ++k) {
+            net.forward(&rows[k * INPUTS], output);
+            acc += findClosestMatch(output, targetOptions);
+        }
+    }
+    double seconds = secondsSince(start);
+    g_sink = acc;
+    return seconds * 1e9 / (static_cast<double>(count) * repeats);
+}
+
+/**
+ * @brief ns por ciclo con la caché; cada repetición empieza con la tabla vacía para
+ *        que la tasa de aciertos sea la de una sola pasada.
+ */
+double timeCached(InferenceCache& cache, const std::vector<float>& rows, int repeats) {
+    size_t count = rows.size() / INPUTS;
+    float output[OUTPUTS];
+    int acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        cache.clear();
+        for (size_t k = 0; k < count; ++k) acc += cache.infer(&rows[k * INPUTS], output);
+    }
+    double seconds = secondsSince(start);
+    g_sink = acc;
+    return seconds * 1e9 / (static_cast<double>(count) * repeats);
+}
+
+void sweepResolutions(const std::vector<float>& rows, size_t capacity, int repeats) {
+    static const float RESOLUTIONS[][2] = { { 0.5f, 0.05f }, { 1.0f, 0.1f }, { 2.0f, 0.25f }, { 5.0f, 0.5f } };
+    size_t count = rows.size() / INPUTS;
+
+    NeuralNetwork net({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    loadDeployedWeights(net);
+    double uncachedNs = timeUncached(net, rows, repeats);
+
+    std::printf("Resolución (cm, s)   aciertos  forwards ahorrados  ns/ciclo (sin caché %.1f)  "
+                "acciones distintas  error máx. salida\n", uncachedNs);
+    for (const auto& res : RESOLUTIONS) {
+        std::vector<float> resolution = resolutionFor(res[0], res[1]);
+        InferenceCache cache(net, resolution, capacity, &targetOptions);
+
+        // Una pasada para la tasa de aciertos, la exactitud y el efecto de cuantizar
+        uint32_t differentActions = 0;
+        uint32_t mismatches = 0;
+        float maxError = 0.0f;
+        float output[OUTPUTS];
+        float raw[OUTPUTS];
+        float snapped[INPUTS];
+        float reference[OUTPUTS];
+        for (size_t k = 0; k < count; ++k) {
+            const float* input = &rows[k * INPUTS];
+            int action = cache.infer(input, output);
+
+            snap(input, resolution, snapped);
+            net.forward(snapped, reference);
+            if (!sameBits(output, reference, OUTPUTS) || action != findClosestMatch(reference, targetOptions)) {
+                mismatches++;
+            }
+
+            net.forward(input, raw);
+            if (action != findClosestMatch(raw, targetOptions)) differentActions++;
+            for (size_t j = 0; j < OUTPUTS; ++j) maxError = std::fmax(maxError, std::fabs(output[j] - raw[j]));
+        }
+        InferenceCacheStats s = cache.stats();
+        check(mismatches == 0, "la caché no coincide con forward sobre la entrada cuantizada");
+        check(s.hits + s.misses == s.lookups && s.lookups == count, "contadores de la caché incoherentes");
+
+        double cachedNs = timeCached(cache, rows, repeats);
+        char label[32];
+        std::snprintf(label, sizeof(label), "(%.1f, %.2f)", res[0], res[1]);
+        std::printf("  %-18s %7.1f %%  %9u de %-7zu  %9.1f (x%.2f)            %6u (%.1f %%)   %.4f\n",
+                    label, 100.0 * s.hitRate(), s.hits, count, cachedNs, uncachedNs / cachedNs,
+                    differentActions, 100.0 * differentActions / count, maxError);
+    }
+    InferenceCache sizing(net, resolutionFor(1.0f, 0.1f), capacity, &targetOptions);
+    std::printf("Tabla de %zu entradas: %zu bytes\n", sizing.capacity(), sizing.memoryBytes());
+}
+
+/**
+ * @brief Tabla de 4 entradas sobre la traza: obliga a sustituir entradas y la
+ *        salida debe seguir siendo la de `forward` sobre la entrada cuantizada.
+ */
+void testEviction(const std::vector<float>& rows) {
+    NeuralNetwork net({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    loadDeployedWeights(net);
+    std::vector<float> resolution = resolutionFor(1.0f, 0.1f);
+    InferenceCache cache(net, resolution, 4, &targetOptions);
+
+    uint32_t mismatches = 0;
+    float output[OUTPUTS];
+    float snapped[INPUTS];
+    float reference[OUTPUTS];
+    for (size_t k = 0; k < rows.size() / INPUTS; ++k) {
+        int action = cache.infer(&rows[k * INPUTS], output);
+        snap(&rows[k * INPUTS], resolution, snapped);
+        net.forward(snapped, reference);
+        if (!sameBits(output, reference, OUTPUTS) || action != findClosestMatch(reference, targetOptions)) {
+            mismatches++;
+        }
+    }
+    InferenceCacheStats s = cache.stats();
+    std::printf("Tabla de %zu entradas: %.1f %% aciertos, %u sustituciones, %u discrepancias\n",
+                cache.capacity(), 100.0 * s.hitRate(), s.evictions, mismatches);
+    check(mismatches == 0, "la caché devuelve una salida incorrecta tras sustituir entradas");
+    check(s.evictions > 0, "la tabla pequeña no llega a sustituir entradas");
+}
+
+void testInvalidation() {
+    NeuralNetwork net({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    loadDeployedWeights(net);
+    InferenceCache cache(net, resolutionFor(1.0f, 0.1f), 16, &targetOptions);
+    const float input[INPUTS] = { 80.2f, -1.0f, 0.0f, 1.31f };
+    float output[OUTPUTS];
+
+    cache.infer(input, output);
+    cache.infer(input, output);
+    check(cache.stats().hits == 1, "la segunda consulta igual no acierta");
+
+    // Mismos pesos: la red no compara valores, cualquier `setWeights` invalida
+    loadDeployedWeights(net);
+    cache.infer(input, output);
+    check(cache.stats().hits == 1 && cache.stats().invalidations == 1, "setWeights no invalida la caché");
+
+    net.setActivationMode(ActivationMode::LUT);
+    cache.infer(input, output);
+    check(cache.stats().hits == 1 && cache.stats().invalidations == 2, "setActivationMode no invalida la caché");
+    net.setActivationMode(ActivationMode::EXACT);
+}
+
+/**
+ * @brief Entrenamiento en línea como en main.cpp: cada ciclo infiere con la caché,
+ *        hace `forwardTrain` + `backward` hacia la acción elegida y la siguiente
+ *        consulta debe ver los pesos nuevos.
+ */
+void testOnlineTraining(const std::vector<float>& rows) {
+    NeuralNetwork net({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    loadDeployedWeights(net);
+    std::vector<float> resolution = resolutionFor(1.0f, 0.1f);
+    InferenceCache cache(net, resolution, 64, &targetOptions);
+
+    size_t count = rows.size() / INPUTS;
+    if (count > 2000) count = 2000;
+    uint32_t stale = 0;
+    float output[OUTPUTS];
+    float snapped[INPUTS];
+    float reference[OUTPUTS];
+    float trained[OUTPUTS];
+    for (size_t k = 0; k < count; ++k) {
+        const float* input = &rows[k * INPUTS];
+        int action = cache.infer(input, output);
+        snap(input, resolution, snapped);
+        net.forward(snapped, reference);
+        if (!sameBits(output, reference, OUTPUTS)) stale++;
+
+        net.forwardTrain(input, trained);
+        net.backward(targetOptions[action].data(), 0.01f);
+    }
+    InferenceCacheStats s = cache.stats();
+    std::printf("Entrenamiento en línea (%zu ciclos): %u aciertos, %u invalidaciones, %u salidas obsoletas\n",
+                count, s.hits, s.invalidations, stale);
+    check(stale == 0, "la caché devuelve salidas de pesos anteriores");
+    check(s.hits == 0 && s.invalidations + 1 == count, "la caché no se invalida tras cada backward");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    size_t capacity = 64;
+    int repeats = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--traza") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (std::strcmp(argv[i], "--capacidad") == 0 && i + 1 < argc) {
+            capacity = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--repeticiones") == 0 && i + 1 < argc) {
+            repeats = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Uso: %s [--traza captura.bin] [--capacidad N] [--repeticiones N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats <= 0) repeats = 1;
+
+    std::vector<float> rows;
+    if (path != nullptr) {
+        if (!readTrace(path, rows)) {
+            std::fprintf(stderr, "No se pudo abrir %s\n", path);
+            return 2;
+        }
+        std::printf("Traza %s: %zu registros\n", path, rows.size() / INPUTS);
+    } else {
+        rows = syntheticTrace(5000);
+        std::printf("Traza sintética de crucero: %zu ciclos\n", rows.size() / INPUTS);
+    }
+    if (rows.empty()) {
+        std::fprintf(stderr, "La traza no tiene registros válidos\n");
+        return 2;
+    }
+
+    sweepResolutions(rows, capacity, repeats);
+    testEviction(rows);
+    testInvalidation();
+    testOnlineTraining(rows);
+
+    std::printf("%s\n", g_ok ? "OK" : "FALLO");
+    return g_ok ? 0 : 1;
+}
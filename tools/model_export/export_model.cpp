@@ -0,0 +1,49 @@
+// -----------------------------------------------------------------------------
+// Exportador de modelos (herramienta de PC, no se compila para el ESP32)
+//
+// Convierte los pesos de 'pesos_red_neuronal.h' al formato binario de
+// ModelFormat.h, que puede cargarse sin recompilar con `MappedModel` (Linux) o
+// grabarse en una partición de flash y usarse con `FlashModel` (ESP32).
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/model_export/export_model.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp src/ModelFormat.cpp src/Crc32.cpp -o export_model
+//
+// Uso:
+//   ./export_model modelo.bin
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+#include "ModelFormat.h"
+#include "NeuralNetwork.h"
+#include "pesos_red_neuronal.h"
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Uso: %s modelo.bin\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        // Misma red que en src/main.cpp
+        NeuralNetwork redNeuronal({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+        redNeuronal.setWeights(
+            {std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+             std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+            {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+             std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+
+        saveModel(redNeuronal, argv[1]);
+
+        // Verificamos que el archivo se puede volver a cargar
+        MappedModel model(argv[1]);
+        std::fprintf(stderr, "Modelo escrito en %s (%zu capas)\n", argv[1], model.view().layers.size());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
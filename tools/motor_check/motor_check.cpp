@@ -0,0 +1,286 @@
+// -----------------------------------------------------------------------------
+// Pruebas de MotorGroup sobre el HAL simulado (herramienta de PC, no se compila
+// para el ESP32)
+//
+// 1. Traza de órdenes como las del vehículo (acciones de targetOptions, que se
+//    repiten varios ciclos seguidos): operaciones GPIO por ciclo aplicándolas con
+//    un `Motor::setEstado` por motor y con `MotorGroup::command`, y estados
+//    espurios vistos en los pines.
+// 2. Las 256 transiciones entre órdenes de 4 bits: ningún estado espurio y los
+//    pines acaban con la orden pedida.
+// 3. PWM con rampa: transiciones entre acciones con `update()` cada milisegundo;
+//    sin estados espurios, cada ciclo de trabajo llega a su objetivo en el tiempo
+//    de la rampa y, terminada, `update()` no escribe nada.
+//
+// Un estado intermedio es espurio si no es parte ni de la orden anterior ni de la
+// nueva (p.ej. IN1 e IN2 en alto al pasar de {1,0} a {0,1}). Se observa tras cada
+// operación de salida con `simSetGpioObserver`.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/ArduinoSim tools/motor_check/motor_check.cpp
+//       src/MotorGroup.cpp src/Motor.cpp src/Actions.cpp lib/ArduinoSim/ArduinoSim.cpp
+//       -o motor_check
+//
+// Uso:
+//   ./motor_check [--ciclos 10000] [--rampa-ms 50]
+//
+// Devuelve 1 si alguna comprobación falla.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Arduino.h"
+#include "ArduinoSim.h"
+#include "Actions.h"
+#include "Motor.h"
+#include "MotorGroup.h"
+
+namespace {
+
+const uint8_t PINS[] = { 26, 25, 33, 32 };  // Los de main.cpp
+const int MOTORS = 4;
+
+bool g_ok = true;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FALLO: %s\n", what);
+        g_ok = false;
+    }
+}
+
+/**
+ * @brief Transición en curso: cada estado observado en los pines debe ser parte
+ *        de `from` o de `to`.
+ */
+struct Transition {
+    uint32_t from = 0;
+    uint32_t to = 0;
+    uint32_t glitches = 0;
+};
+
+uint32_t pinState() {
+    uint32_t bits = 0;
+    for (int i = 0; i < MOTORS; ++i) {
+        if (simPinLevel(PINS[i]) == HIGH) bits |= 1u << i;
+    }
+    return bits;
+}
+
+void observe(void* context) {
+    Transition* t = static_cast<Transition*>(context);
+    uint32_t s = pinState();
+    if ((s & ~t->from) != 0 && (s & ~t->to) != 0) t->glitches++;
+}
+
+uint32_t actionBits(int action) {
+    uint32_t bits = 0;
+    for (int i = 0; i < MOTORS; ++i) {
+        if (targetOptions[action][i] > 0.5f) bits |= 1u << i;
+    }
+    return bits;
+}
+
+uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+struct TraceResult {
+    uint32_t operations = 0;
+    uint32_t maxPerTick = 0;
+    uint32_t glitches = 0;
+    uint32_t wrongOutputs = 0;
+};
+
+/**
+ * @brief Aplica la misma traza con `apply` y cuenta operaciones y estados espurios.
+ */
+template <typename Apply>
+TraceResult runTrace(const uint32_t* trace, int ticks, Apply apply) {
+    TraceResult result;
+    Transition t;
+    simSetGpioObserver(observe, &t);
+    for (int k = 0; k < ticks; ++k) {
+        t.from = pinState();
+        t.to = trace[k];
+        uint32_t before = simGpioOperations();
+        apply(trace[k]);
+        uint32_t ops = simGpioOperations() - before;
+        result.operations += ops;
+        if (ops > result.maxPerTick) result.maxPerTick = ops;
+        if (pinState() != trace[k]) result.wrongOutputs++;
+    }
+    result.glitches = t.glitches;
+    simSetGpioObserver(nullptr, nullptr);
+    return result;
+}
+
+void printTrace(const char* name, const TraceResult& r, int ticks) {
+    std::printf("  %-26s %6.2f operaciones/ciclo (max %u)  %5u estados espurios\n", name,
+                static_cast<double>(r.operations) / ticks, r.maxPerTick, r.glitches);
+}
+
+void testTrace(int ticks) {
+    // Cada acción se mantiene unos ciclos, como al seguir un pasillo
+    uint32_t* trace = new uint32_t[ticks];
+    uint32_t rng = 12345;
+    int action = 0;
+    int changes = 0;
+    for (int k = 0; k < ticks; ++k) {
+        if (nextRandom(rng) % 5 == 0) {
+            int next = static_cast<int>(nextRandom(rng) % targetOptions.size());
+            if (next != action) changes++;
+            action = next;
+        }
+        trace[k] = actionBits(action);
+    }
+
+    Motor motors[] = { Motor(PINS[0]), Motor(PINS[1]), Motor(PINS[2]), Motor(PINS[3]) };
+    for (int i = 0; i < MOTORS; ++i) motors[i].setEstado(false);
+    TraceResult legacy = runTrace(trace, ticks, [&](uint32_t bits) {
+        for (int i = 0; i < MOTORS; ++i) motors[i].setEstado((bits >> i) & 1u);
+    });
+
+    MotorGroup group(PINS, MOTORS);
+    group.begin();
+    TraceResult batched = runTrace(trace, ticks, [&](uint32_t bits) { group.command(bits); });
+
+    std::printf("Traza de %d ciclos con %d cambios de acción:\n", ticks, changes);
+    printTrace("Motor (un pin por motor)", legacy, ticks);
+    printTrace("MotorGroup", batched, ticks);
+
+    check(legacy.wrongOutputs == 0 && batched.wrongOutputs == 0, "la traza no deja los pines con la orden");
+    check(batched.glitches == 0, "MotorGroup produce estados espurios en la traza");
+    check(batched.maxPerTick <= 4, "MotorGroup usa más de 4 escrituras en un ciclo");
+    check(batched.operations < legacy.operations, "MotorGroup no reduce las operaciones GPIO");
+    delete[] trace;
+}
+
+void testAllTransitions() {
+    MotorGroup group(PINS, MOTORS);
+    group.begin();
+    uint32_t glitches = 0;
+    uint32_t wrong = 0;
+    uint32_t repeatedWrites = 0;
+    for (uint32_t from = 0; from < 16; ++from) {
+        for (uint32_t to = 0; to < 16; ++to) {
+            group.command(from);
+            Transition t;
+            t.from = from;
+            t.to = to;
+            simSetGpioObserver(observe, &t);
+            group.command(to);
+            uint32_t before = simGpioOperations();
+            group.command(to);
+            repeatedWrites += simGpioOperations() - before;
+            simSetGpioObserver(nullptr, nullptr);
+            glitches += t.glitches;
+            if (pinState() != to || group.state() != to) wrong++;
+        }
+    }
+    std::printf("Transiciones de 4 bits: 256, %u estados espurios, %u salidas incorrectas, "
+                "%u escrituras al repetir la orden\n", glitches, wrong, repeatedWrites);
+    check(glitches == 0, "estado espurio en alguna transición de 4 bits");
+    check(wrong == 0, "alguna transición de 4 bits deja los pines mal");
+    check(repeatedWrites == 0, "repetir la orden escribe en los pines");
+}
+
+void testRamp(unsigned long rampMs) {
+    MotorGroupConfig config;
+    config.pwm = true;
+    config.rampMs = rampMs;
+    MotorGroup group(PINS, MOTORS, config);
+    group.begin();
+    const uint32_t maxDuty = (1u << config.resolutionBits) - 1;
+
+    // Acciones y "todo apagado"
+    uint32_t orders[5] = { 0 };
+    for (size_t a = 0; a < targetOptions.size() && a < 4; ++a) orders[a + 1] = actionBits(static_cast<int>(a));
+
+    uint32_t glitches = 0;
+    uint32_t unfinished = 0;
+    uint32_t wrong = 0;
+    uint32_t idleWrites = 0;
+    uint32_t operations = 0;
+    unsigned long slowestMs = 0;
+    for (int a = 0; a < 5; ++a) {
+        for (int b = 0; b < 5; ++b) {
+            if (a == b) continue;
+            group.command(orders[a]);
+            int guard = 0;
+            while (!group.settled() && guard++ < 10000) {
+                simAdvanceMicros(1000);
+                group.update();
+            }
+
+            Transition t;
+            t.from = orders[a];
+            t.to = orders[b];
+            simSetGpioObserver(observe, &t);
+            uint32_t before = simGpioOperations();
+            unsigned long start = millis();
+            group.command(orders[b]);
+            int steps = 0;
+            while (!group.settled() && steps++ < 10000) {
+                simAdvanceMicros(1000);
+                group.update();
+            }
+            unsigned long elapsed = millis() - start;
+            operations += simGpioOperations() - before;
+            if (elapsed > slowestMs) slowestMs = elapsed;
+            if (!group.settled()) unfinished++;
+
+            for (int i = 0; i < MOTORS; ++i) {
+                uint32_t goal = (orders[b] >> i) & 1u ? maxDuty : 0;
+                if (simPinDuty(PINS[i]) != goal) wrong++;
+            }
+            before = simGpioOperations();
+            for (int k = 0; k < 100; ++k) {
+                simAdvanceMicros(1000);
+                group.update();
+            }
+            idleWrites += simGpioOperations() - before;
+            simSetGpioObserver(nullptr, nullptr);
+            glitches += t.glitches;
+        }
+    }
+
+    std::printf("PWM con rampa de %lu ms: 20 transiciones, %.1f ledcWrite por transición, "
+                "max %lu ms hasta el objetivo, %u estados espurios, %u escrituras en reposo\n",
+                rampMs, operations / 20.0, slowestMs, glitches, idleWrites);
+    check(glitches == 0, "estado espurio durante la rampa");
+    check(unfinished == 0 && wrong == 0, "la rampa no llega al ciclo pedido");
+    // Parar y luego arrancar: como mucho dos rampas (más un ms de redondeo cada una)
+    check(slowestMs <= 2 * rampMs + 2, "la rampa tarda más de lo configurado");
+    check(idleWrites == 0, "update() escribe con la rampa terminada");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int ticks = 10000;
+    unsigned long rampMs = 50;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ciclos") == 0 && i + 1 < argc) {
+            ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rampa-ms") == 0 && i + 1 < argc) {
+            rampMs = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Uso: %s [--ciclos N] [--rampa-ms MS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (ticks <= 0) ticks = 1;
+
+    testTrace(ticks);
+    testAllTransitions();
+    testRamp(rampMs);
+    testRamp(0);
+
+    std::printf("%s\n", g_ok ? "OK" : "FALLO");
+    return g_ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// -----------------------------------------------------------------------------
+// Cuantizador post-entrenamiento (herramienta de PC, no se compila para el ESP32)
+//
+// Toma los pesos float de 'pesos_red_neuronal.h', calibra las escalas int8 con un
+// CSV de lecturas de sensores y escribe en stdout un encabezado con el modelo
+// cuantizado listo para `QuantizedNetwork`. El informe de precisión va a stderr.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/quantizer/quantizer.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp src/QuantizedNetwork.cpp src/Actions.cpp -o quantizer
+//
+// Uso:
+//   ./quantizer calibracion.csv [evaluacion.csv] [--per-layer]
+//       > lib/pesos_red_neuronal/pesos_red_neuronal_q8.h
+//
+// El CSV sigue el formato de la salida serial: las 4 primeras columnas son
+// distancia_izquierda, distancia_derecha, duracion_izquierda, duracion_derecha;
+// el resto se ignora, igual que las líneas no numéricas (encabezados). Conviene
+// que incluya lecturas sin eco (-1) y duraciones largas: los rangos de las
+// neuronas ocultas se ajustan a lo que aparece en la calibración.
+// -----------------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Actions.h"
+#include "NeuralNetwork.h"
+#include "QuantizedNetwork.h"
+#include "pesos_red_neuronal.h"
+
+static std::vector<std::vector<float>> readCsv(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", path);
+        std::exit(1);
+    }
+
+    std::vector<std::vector<float>> rows;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<float> row;
+        while (row.size() < 4 && std::getline(ss, cell, ',')) {
+            char* end = nullptr;
+            float value = std::strtof(cell.c_str(), &end);
+            if (end == cell.c_str()) {
+                break; // Encabezado u otra línea no numérica
+            }
+            row.push_back(value);
+        }
+        if (row.size() == 4) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+static void writeArray(const char* type, const char* name, int index,
+                       const std::vector<std::string>& values) {
+    std::printf("static const %s %s_%d[] = {\n", type, name, index);
+    for (size_t i = 0; i < values.size(); i++) {
+        std::printf("%s%s", values[i].c_str(), (i + 1 < values.size()) ? ", " : "\n");
+    }
+    std::printf("};\n\n");
+}
+
+template <typename T>
+static std::vector<std::string> formatInts(const T* data, int n) {
+    std::vector<std::string> out;
+    for (int i = 0; i < n; i++) {
+        out.push_back(std::to_string(static_cast<long>(data[i])));
+    }
+    return out;
+}
+
+static std::string formatFloat(float x) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9gf", x);
+    return buf;
+}
+
+static const char* activationName(ActivationFunction act) {
+    switch (act) {
+        case ActivationFunction::RELU:    return "ActivationFunction::RELU";
+        case ActivationFunction::SIGMOID: return "ActivationFunction::SIGMOID";
+        case ActivationFunction::TANH:    return "ActivationFunction::TANH";
+        case ActivationFunction::LINEAR:
+        default:                          return "ActivationFunction::LINEAR";
+    }
+}
+
+static void writeHeader(const QuantizedModel& model) {
+    std::printf("#ifndef PESOS_RED_NEURONAL_Q8_H\n#define PESOS_RED_NEURONAL_Q8_H\n\n");
+    std::printf("// Generado por tools/quantizer a partir de pesos_red_neuronal.h\n\n");
+    std::printf("#include \"QuantizedNetwork.h\"\n\n");
+
+    for (int l = 0; l < model.numLayers; l++) {
+        const QuantizedLayer& layer = model.layers[l];
+        std::printf("// Capa %d (%d -> %d)\n", l, layer.inSize, layer.outSize);
+        writeArray("int8_t", "PESOS_Q8_CAPA", l, formatInts(layer.weights, layer.inSize * layer.outSize));
+        writeArray("int32_t", "SESGOS_Q8_CAPA", l, formatInts(layer.biases, layer.outSize));
+        if (layer.accScales != nullptr) {
+            std::vector<std::string> scales;
+            for (int j = 0; j < layer.outSize; j++) {
+                scales.push_back(formatFloat(layer.accScales[j]));
+            }
+            writeArray("float", "ESCALAS_Q8_CAPA", l, scales);
+        }
+        if (layer.multipliers != nullptr) {
+            writeArray("int32_t", "MULT_Q8_CAPA", l, formatInts(layer.multipliers, layer.outSize));
+            writeArray("int8_t", "SHIFT_Q8_CAPA", l, formatInts(layer.shifts, layer.outSize));
+        }
+        writeArray("int32_t", "MULT_ENTRADA_Q8_CAPA", l, formatInts(layer.inputMultipliers, layer.inSize));
+    }
+
+    std::vector<std::string> inputScales;
+    for (int i = 0; i < model.layers[0].inSize; i++) {
+        inputScales.push_back(formatFloat(model.inputScales[i]));
+    }
+    std::printf("// Escala de cada entrada\n");
+    std::printf("static const float ESCALAS_Q8_ENTRADA[] = {\n");
+    for (size_t i = 0; i < inputScales.size(); i++) {
+        std::printf("%s%s", inputScales[i].c_str(), (i + 1 < inputScales.size()) ? ", " : "\n");
+    }
+    std::printf("};\n\n");
+
+    std::printf("static const QuantizedLayer CAPAS_Q8[] = {\n");
+    for (int l = 0; l < model.numLayers; l++) {
+        const QuantizedLayer& layer = model.layers[l];
+        std::string scales = layer.accScales ? "ESCALAS_Q8_CAPA_" + std::to_string(l) : "nullptr";
+        std::string mults = layer.multipliers ? "MULT_Q8_CAPA_" + std::to_string(l) : "nullptr";
+        std::string shifts = layer.shifts ? "SHIFT_Q8_CAPA_" + std::to_string(l) : "nullptr";
+        std::printf("    {%d, %d, %s, PESOS_Q8_CAPA_%d, SESGOS_Q8_CAPA_%d, %s, %s, %s, MULT_ENTRADA_Q8_CAPA_%d, %s},\n",
+                    layer.inSize, layer.outSize, activationName(layer.activation), l, l,
+                    scales.c_str(), mults.c_str(), shifts.c_str(), l, formatFloat(layer.outScale).c_str());
+    }
+    std::printf("};\n\n");
+    std::printf("static const QuantizedModel MODELO_Q8 = {%d, CAPAS_Q8, ESCALAS_Q8_ENTRADA};\n\n",
+                model.numLayers);
+    std::printf("#endif // PESOS_RED_NEURONAL_Q8_H\n");
+}
+
+int main(int argc, char** argv) {
+    const char* calibrationPath = nullptr;
+    const char* evaluationPath = nullptr;
+    QuantizationGranularity granularity = QuantizationGranularity::PER_CHANNEL;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--per-layer") == 0) {
+            granularity = QuantizationGranularity::PER_LAYER;
+        } else if (calibrationPath == nullptr) {
+            calibrationPath = argv[i];
+        } else {
+            evaluationPath = argv[i];
+        }
+    }
+    if (calibrationPath == nullptr) {
+        std::fprintf(stderr, "Uso: %s calibracion.csv [evaluacion.csv] [--per-layer]\n", argv[0]);
+        return 1;
+    }
+
+    // Misma red que en src/main.cpp
+    NeuralNetwork redNeuronal({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    redNeuronal.setWeights(
+        {std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+         std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+        {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+         std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+
+    std::vector<std::vector<float>> calibration = readCsv(calibrationPath);
+    std::vector<std::vector<float>> evaluation = evaluationPath ? readCsv(evaluationPath) : calibration;
+    if (calibration.empty() || evaluation.empty()) {
+        std::fprintf(stderr, "El CSV no contiene filas válidas de 4 entradas.\n");
+        return 1;
+    }
+
+    QuantizedNetwork quantized = QuantizedNetwork::fromNetwork(redNeuronal, calibration, granularity);
+    writeHeader(quantized.model());
+
+    // Informe de precisión: acuerdo de la acción decodificada y de cada motor
+    size_t actionMatches = 0;
+    size_t motorMatches = 0;
+    float maxAbsError = 0.0f;
+    for (const std::vector<float>& input : evaluation) {
+        std::vector<float> floatOut = redNeuronal.forward(input);
+        std::vector<float> quantOut = quantized.forward(input);
+        if (findClosestMatch(floatOut, targetOptions) == findClosestMatch(quantOut, targetOptions)) {
+            actionMatches++;
+        }
+        for (size_t i = 0; i < floatOut.size(); i++) {
+            motorMatches += ((floatOut[i] > 0.5f) == (quantOut[i] > 0.5f)) ? 1 : 0;
+            maxAbsError = std::max(maxAbsError, std::fabs(floatOut[i] - quantOut[i]));
+        }
+    }
+
+    size_t floatBytes = sizeof(PESOS_CAPA_0) + sizeof(PESOS_CAPA_1) + sizeof(SESGOS_CAPA_0) + sizeof(SESGOS_CAPA_1);
+    std::fprintf(stderr, "Calibración: %zu muestras, evaluación: %zu muestras (%s)\n",
+                 calibration.size(), evaluation.size(),
+                 granularity == QuantizationGranularity::PER_LAYER ? "por capa" : "por canal");
+    std::fprintf(stderr, "Acuerdo de findClosestMatch: %.2f %%\n", 100.0 * actionMatches / evaluation.size());
+    std::fprintf(stderr, "Acuerdo de motores (>0.5):   %.2f %%\n", 100.0 * motorMatches / (evaluation.size() * 4));
+    std::fprintf(stderr, "Error absoluto máximo:       %.6f\n", maxAbsError);
+    std::fprintf(stderr, "Parámetros: %zu bytes float -> %zu bytes int8\n", floatBytes, quantized.parameterBytes());
+    return 0;
+}
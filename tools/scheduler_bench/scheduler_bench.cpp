@@ -0,0 +1,421 @@
+// -----------------------------------------------------------------------------
+// Ritmo sostenido del bucle de control con Scheduler, sobre el reloj simulado de
+// lib/ArduinoSim (herramienta de PC, no se compila para el ESP32)
+//
+// Cada tarea consume un coste fijo de tiempo simulado (opciones --coste-*), así que
+// el resultado es determinista. Para varias frecuencias de sensado compara:
+// - Sincronizado: una sola tarea periódica que sensa, infiere, entrena y actúa,
+//   como el antiguo loop() con `intervaloMedicion`.
+// - Multifrecuencia: sensado periódico, inferencia con cada lectura y entrenamiento
+//   de fondo en la holgura, como main.cpp.
+// Ambos con la tarea de mantenimiento de main.cpp cada milisegundo.
+//
+// Columnas: inferencias y entrenamientos por segundo, latencia máxima de la
+// lectura a los motores, y activaciones perdidas o plazos incumplidos del camino
+// de control. "Ritmo sostenido" es la mayor frecuencia que infiere todas las
+// lecturas sin incumplir plazos.
+//
+// Comprueba que las tareas de fondo no retrasan al sensado, que la latencia hasta
+// los motores no pasa de la cota de un planificador cooperativo y que el ritmo
+// sostenido multifrecuencia no es menor que el sincronizado.
+//
+// Después, a 40 Hz, añade la compactación del registro de puntos de control de
+// main.cpp: cada 2 s hace falta una, que borra 4 sectores (--coste-borrado, más que
+// el periodo de sensado) y escribe la base por trozos; el primer entrenamiento dura
+// --coste-entrenamiento-largo. Con y sin espera máxima (`maxWaitUs`) de las tareas
+// de fondo, comprueba que con ella todas las compactaciones terminan y el
+// entrenamiento no se queda sin ejecutar. Al final mide en el PC el coste de
+// `runOnce`.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/ArduinoSim
+//       tools/scheduler_bench/scheduler_bench.cpp src/Scheduler.cpp
+//       lib/ArduinoSim/ArduinoSim.cpp -o scheduler_bench
+//
+// Uso:
+//   ./scheduler_bench [--segundos 20] [--coste-sensado 20] [--coste-inferencia 80]
+//                     [--coste-entrenamiento 900] [--coste-mantenimiento 30]
+//                     [--coste-borrado 45000] [--coste-entrenamiento-largo 30000]
+//
+// Devuelve 1 si alguna comprobación falla.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Arduino.h"
+#include "ArduinoSim.h"
+#include "Scheduler.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+bool g_ok = true;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FALLO: %s\n", what);
+        g_ok = false;
+    }
+}
+
+/**
+ * @brief Tiempo simulado (us) que consume cada tarea por ejecución.
+ */
+struct Costs {
+    unsigned long sensing = 20;
+    unsigned long inference = 80;   // Red, selección, motores y telemetría
+    unsigned long training = 900;   // backward y mini-lote de repaso
+    unsigned long maintenance = 30;
+    unsigned long erase = 45000;        // Borrar un sector de flash de 4 KB
+    unsigned long flashWrite = 1400;    // Escribir un trozo de 512 bytes (2 páginas)
+    unsigned long longTraining = 30000; // Primer entrenamiento, más largo que el periodo
+};
+
+struct Result {
+    double inferencesPerSecond = 0.0;
+    double trainingsPerSecond = 0.0;
+    unsigned long maxActuationUs = 0;  // De la lectura a los motores
+    unsigned long maxSensingLatencyUs = 0;
+    uint32_t lost = 0;                 // Activaciones perdidas y plazos incumplidos
+    bool sustained = false;
+};
+
+/**
+ * @brief Estado de una ejecución, compartido por las tareas.
+ */
+struct Bench {
+    Scheduler scheduler;
+    Costs costs;
+    int inferenceTask = -1;
+    int trainingTask = -1;
+    unsigned long sampleUs = 0;
+    unsigned long maxActuationUs = 0;
+    uint32_t samples = 0;
+    uint32_t inferences = 0;
+    uint32_t trainings = 0;
+    // Compactación (solo en `runFlash`)
+    int compactionSteps = 0;       // Pasos que faltan de la compactación en curso
+    uint64_t nextCompactionUs = 0;
+    uint32_t compactionsRequested = 0;
+    uint32_t compactionsDone = 0;
+};
+
+// Compactación de main.cpp: 4 sectores borrados, cabeceras y un trozo de parámetros
+const int ERASE_STEPS = 4;
+const int COMPACTION_STEPS = ERASE_STEPS + 2;
+const uint64_t COMPACTION_EVERY_US = 2000000;
+
+void spend(unsigned long us) {
+    simAdvanceMicros(us);
+}
+
+void actuate(Bench& b) {
+    b.inferences++;
+    b.maxActuationUs = std::max(b.maxActuationUs, micros() - b.sampleUs);
+}
+
+void lockstepTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    b.sampleUs = micros();
+    b.samples++;
+    spend(b.costs.sensing);
+    spend(b.costs.inference);
+    // El antiguo loop() entrenaba antes de mover los motores
+    spend(b.costs.training);
+    b.trainings++;
+    actuate(b);
+}
+
+void sensingTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    b.sampleUs = micros();
+    b.samples++;
+    spend(b.costs.sensing);
+    b.scheduler.trigger(b.inferenceTask);
+}
+
+void inferenceTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    spend(b.costs.inference);
+    actuate(b);
+    b.scheduler.trigger(b.trainingTask);
+}
+
+void trainingTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    spend(b.costs.training);
+    b.trainings++;
+}
+
+void longFirstTrainingTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    spend(b.trainings == 0 ? b.costs.longTraining : b.costs.training);
+    b.trainings++;
+}
+
+// Pide una compactación cada `COMPACTION_EVERY_US` si no hay otra en curso (como
+// los puntos de control de main.cpp al llenar la región)
+void flashMaintenanceTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    if (b.compactionSteps == 0 && simNowMicros() >= b.nextCompactionUs) {
+        b.compactionSteps = COMPACTION_STEPS;
+        b.compactionsRequested++;
+        b.nextCompactionUs += COMPACTION_EVERY_US;
+    }
+    spend(b.costs.maintenance);
+}
+
+void compactionTask(void* context) {
+    Bench& b = *static_cast<Bench*>(context);
+    if (b.compactionSteps == 0) return;
+
+    // Como `CheckpointLog::compactStep`: un sector borrado o un trozo escrito por paso
+    spend(COMPACTION_STEPS - b.compactionSteps < ERASE_STEPS ? b.costs.erase : b.costs.flashWrite);
+    if (--b.compactionSteps == 0) b.compactionsDone++;
+}
+
+void maintenanceTask(void* context) {
+    spend(static_cast<Bench*>(context)->costs.maintenance);
+}
+
+TaskConfig taskConfig(unsigned long periodUs, unsigned long deadlineUs, uint8_t priority,
+                      bool background, unsigned long budgetUs = 0) {
+    TaskConfig config;
+    config.periodUs = periodUs;
+    config.deadlineUs = deadlineUs;
+    config.priority = priority;
+    config.background = background;
+    config.budgetUs = budgetUs;
+    return config;
+}
+
+/**
+ * @brief Ejecuta el planificador sobre el reloj simulado; sin tareas listas, el
+ *        reloj salta a la siguiente activación.
+ */
+void drive(Scheduler& scheduler, uint64_t durationUs) {
+    uint64_t end = simNowMicros() + durationUs;
+    while (simNowMicros() < end) {
+        if (!scheduler.runOnce()) {
+            unsigned long wait = scheduler.timeToNextRelease();
+            simAdvanceMicros(wait == 0 ? 1 : std::min<uint64_t>(wait, end - simNowMicros()));
+        }
+    }
+}
+
+Result run(bool multiRate, double rateHz, const Costs& costs, double seconds) {
+    Bench* b = new Bench();
+    b->costs = costs;
+    const unsigned long periodUs = static_cast<unsigned long>(1e6 / rateHz + 0.5);
+
+    // El camino de control debe terminar antes de la siguiente lectura
+    int sensing = -1;
+    int control = -1;
+    if (multiRate) {
+        sensing = b->scheduler.add("sensado", sensingTask, b, taskConfig(periodUs, periodUs, 4, false));
+        b->inferenceTask = b->scheduler.add("inferencia", inferenceTask, b, taskConfig(0, periodUs, 3, false));
+        b->trainingTask = b->scheduler.add("entrenamiento", trainingTask, b, taskConfig(0, 0, 2, true, costs.training));
+        control = b->inferenceTask;
+    } else {
+        sensing = b->scheduler.add("ciclo", lockstepTask, b, taskConfig(periodUs, periodUs, 4, false));
+        control = sensing;
+    }
+    b->scheduler.add("mantenimiento", maintenanceTask, b, taskConfig(1000, 0, 0, false));
+    b->scheduler.begin();
+    drive(b->scheduler, static_cast<uint64_t>(seconds * 1e6));
+
+    Result r;
+    r.inferencesPerSecond = b->inferences / seconds;
+    r.trainingsPerSecond = b->trainings / seconds;
+    r.maxActuationUs = b->maxActuationUs;
+    TaskStats s = b->scheduler.stats(sensing);
+    TaskStats c = b->scheduler.stats(control);
+    r.maxSensingLatencyUs = s.maxLatencyUs;
+    r.lost = s.skipped + s.deadlineMisses + (control != sensing ? c.skipped + c.deadlineMisses : 0);
+    // Todas las lecturas llegan a los motores, salvo la última si el tiempo se acaba
+    r.sustained = r.lost == 0 && b->inferences + 1 >= b->samples;
+    delete b;
+    return r;
+}
+
+struct FlashResult {
+    uint32_t compactionsRequested = 0;
+    uint32_t compactionsDone = 0;
+    uint32_t compactionsForced = 0;
+    double inferencesPerSecond = 0.0;
+    double trainingsPerSecond = 0.0;
+    unsigned long maxSensingLatencyUs = 0;
+    uint32_t sensingLost = 0;
+};
+
+/**
+ * @brief Tareas de main.cpp a 40 Hz con la compactación del registro, con las
+ *        esperas máximas dadas para el entrenamiento y la compactación (0 = sin límite).
+ */
+FlashResult runFlash(const Costs& costs, double seconds, unsigned long trainingWaitUs,
+                     unsigned long compactionWaitUs) {
+    Bench* b = new Bench();
+    b->costs = costs;
+    b->nextCompactionUs = simNowMicros();
+    const unsigned long periodUs = 25000;
+
+    TaskConfig training = taskConfig(0, 0, 2, true, costs.training);
+    training.maxWaitUs = trainingWaitUs;
+    TaskConfig compaction = taskConfig(100000, 0, 1, true, costs.erase);
+    compaction.maxWaitUs = compactionWaitUs;
+
+    int sensing = b->scheduler.add("sensado", sensingTask, b, taskConfig(periodUs, 5000, 4, false));
+    b->inferenceTask = b->scheduler.add("inferencia", inferenceTask, b, taskConfig(0, 10000, 3, false));
+    b->trainingTask = b->scheduler.add("entrenamiento", longFirstTrainingTask, b, training);
+    int compactionId = b->scheduler.add("compactacion", compactionTask, b, compaction);
+    b->scheduler.add("mantenimiento", flashMaintenanceTask, b, taskConfig(1000, 0, 0, false));
+    b->scheduler.begin();
+    drive(b->scheduler, static_cast<uint64_t>(seconds * 1e6));
+
+    FlashResult r;
+    r.compactionsRequested = b->compactionsRequested;
+    r.compactionsDone = b->compactionsDone;
+    r.compactionsForced = b->scheduler.stats(compactionId).forced;
+    r.inferencesPerSecond = b->inferences / seconds;
+    r.trainingsPerSecond = b->trainings / seconds;
+    TaskStats s = b->scheduler.stats(sensing);
+    r.maxSensingLatencyUs = s.maxLatencyUs;
+    r.sensingLost = s.skipped;
+    delete b;
+    return r;
+}
+
+void printFlash(const char* label, const FlashResult& r) {
+    std::printf("%-18s %6u/%-6u %9u %9.1f %9.1f %8lu us %9u\n", label, r.compactionsDone,
+                r.compactionsRequested, r.compactionsForced, r.inferencesPerSecond,
+                r.trainingsPerSecond, r.maxSensingLatencyUs, r.sensingLost);
+}
+
+void emptyTask(void*) {}
+
+void selfTriggerTask(void* context) {
+    Scheduler& s = *static_cast<Scheduler*>(context);
+    s.trigger(0);
+}
+
+/**
+ * @brief Coste en el PC de elegir y ejecutar una tarea vacía con 5 registradas.
+ */
+double dispatchNs() {
+    Scheduler* s = new Scheduler();
+    s->add("a", selfTriggerTask, s, taskConfig(0, 0, 3, false));
+    s->add("b", emptyTask, nullptr, taskConfig(1000000000UL, 0, 4, false));
+    s->add("c", emptyTask, nullptr, taskConfig(0, 0, 2, true));
+    s->add("d", emptyTask, nullptr, taskConfig(1000000000UL, 0, 1, true));
+    s->add("e", emptyTask, nullptr, taskConfig(1000000000UL, 0, 0, false));
+    s->begin();
+    s->trigger(0);
+    for (int i = 0; i < 10; ++i) s->runOnce();  // Activaciones iniciales de b, d y e
+
+    const int n = 2000000;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < n; ++i) s->runOnce();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / n;
+    delete s;
+    return ns;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Costs costs;
+    double seconds = 20.0;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--segundos") && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--coste-sensado") && hasValue) {
+            costs.sensing = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--coste-inferencia") && hasValue) {
+            costs.inference = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--coste-entrenamiento") && hasValue) {
+            costs.training = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--coste-mantenimiento") && hasValue) {
+            costs.maintenance = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--coste-borrado") && hasValue) {
+            costs.erase = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--coste-entrenamiento-largo") && hasValue) {
+            costs.longTraining = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr,
+                         "Uso: %s [--segundos S] [--coste-sensado US] [--coste-inferencia US]"
+                         " [--coste-entrenamiento US] [--coste-mantenimiento US]"
+                         " [--coste-borrado US] [--coste-entrenamiento-largo US]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0.0) seconds = 1.0;
+
+    std::printf("Costes simulados (us): sensado %lu, inferencia %lu, entrenamiento %lu, "
+                "mantenimiento %lu; %.0f s por frecuencia\n\n",
+                costs.sensing, costs.inference, costs.training, costs.maintenance, seconds);
+    std::printf("%8s | %-44s | %-44s\n", "", "sincronizado", "multifrecuencia");
+    std::printf("%8s | %9s %9s %10s %12s | %9s %9s %10s %12s\n", "Hz", "infer/s", "entren/s",
+                "motores", "perdidas", "infer/s", "entren/s", "motores", "perdidas");
+
+    const double rates[] = { 10, 20, 40, 100, 200, 400, 700, 1000, 1500, 2500, 4000, 6000, 8000 };
+    double lockstepMax = 0.0;
+    double multiRateMax = 0.0;
+    // Cota sin expropiación: la latencia de una tarea es como mucho lo que dura la
+    // tarea más larga que no es de fondo (aquí, la inferencia o el mantenimiento)
+    const unsigned long blocking = std::max(costs.inference, costs.maintenance);
+    for (double rate : rates) {
+        Result lockstep = run(false, rate, costs, seconds);
+        Result multi = run(true, rate, costs, seconds);
+        std::printf("%8.0f | %9.1f %9.1f %8lu us %12u | %9.1f %9.1f %8lu us %12u\n", rate,
+                    lockstep.inferencesPerSecond, lockstep.trainingsPerSecond,
+                    lockstep.maxActuationUs, lockstep.lost, multi.inferencesPerSecond,
+                    multi.trainingsPerSecond, multi.maxActuationUs, multi.lost);
+
+        if (lockstep.sustained) lockstepMax = rate;
+        if (multi.sustained) {
+            multiRateMax = rate;
+            check(multi.maxActuationUs <= costs.sensing + blocking + costs.inference,
+                  "la latencia hasta los motores supera la cota cooperativa");
+        }
+        check(multi.maxSensingLatencyUs <= blocking,
+              "una tarea de fondo retrasó el sensado");
+    }
+
+    std::printf("\nRitmo sostenido: sincronizado %.0f Hz, multifrecuencia %.0f Hz\n", lockstepMax,
+                multiRateMax);
+    check(multiRateMax >= lockstepMax, "el ritmo multifrecuencia es menor que el sincronizado");
+
+    Result reference = run(true, 40, costs, seconds);
+    check(reference.sustained, "no se sostienen 40 Hz de sensado");
+    check(reference.trainingsPerSecond >= 0.99 * reference.inferencesPerSecond,
+          "a 40 Hz el entrenamiento no acompaña a la inferencia");
+
+    // Compactación con borrados más largos que el periodo de sensado (espera
+    // máxima de main.cpp: 100 ms el entrenamiento, 250 ms la compactación)
+    std::printf("\nCompactación a 40 Hz (borrado %lu us, primer entrenamiento %lu us)\n",
+                costs.erase, costs.longTraining);
+    std::printf("%-18s %13s %9s %9s %9s %11s %9s\n", "", "compact.", "forzadas", "infer/s",
+                "entren/s", "sensado", "perdidas");
+    FlashResult unbounded = runFlash(costs, seconds, 0, 0);
+    FlashResult bounded = runFlash(costs, seconds, 100000, 250000);
+    printFlash("sin espera maxima", unbounded);
+    printFlash("con espera maxima", bounded);
+    check(bounded.compactionsDone + 1 >= bounded.compactionsRequested,
+          "con espera máxima, la compactación no termina");
+    check(bounded.trainingsPerSecond >= 0.95 * bounded.inferencesPerSecond,
+          "con espera máxima, un entrenamiento largo deja sin entrenar");
+    // Un paso forzado retrasa el sensado como mucho lo que dura
+    check(bounded.maxSensingLatencyUs <= std::max(costs.erase, costs.longTraining) + blocking,
+          "un paso forzado retrasó el sensado más de lo que dura");
+
+    std::printf("runOnce en el PC: %.1f ns por tarea ejecutada (5 tareas registradas)\n",
+                dispatchNs());
+    std::printf("%s\n", g_ok ? "OK" : "FALLO");
+    return g_ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+// -----------------------------------------------------------------------------
+// Prueba de estrés de ParameterStore (herramienta de PC, no se compila para el ESP32)
+//
+// 1. Consistencia: un entrenador suma 1 a todos los parámetros y publica, mientras
+//    varios lectores toman instantáneas y comprueban que todos los parámetros valen
+//    exactamente su número de versión, antes y después de usarlas en `forward`
+//    (ni copias a medio escribir ni sobrescritas mientras se leen), y que las
+//    versiones que ve cada lector nunca retroceden.
+// 2. Latencia: percentiles de una inferencia de la red del vehículo {4,8,4} sin
+//    entrenador, con un entrenador concurrente que publica instantáneas, y con la
+//    alternativa de proteger una única red con un mutex.
+//
+// Compilación con ThreadSanitizer (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O1 -g -fsanitize=thread -pthread -Iinclude
+//       tools/snapshot_stress/snapshot_stress.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp src/ParameterStore.cpp -o snapshot_stress
+//
+// Para latencias representativas, compilar con -O2 y sin -fsanitize.
+//
+// Uso:
+//   ./snapshot_stress [--segundos 2] [--lectores N]
+//
+// Devuelve 1 si algún lector observa una instantánea inconsistente.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "ParameterStore.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct ReaderStats {
+    uint64_t reads = 0;
+    uint64_t errors = 0;
+    uint32_t lastVersion = 0;
+};
+
+/**
+ * @brief Comprueba que los `n` parámetros de la instantánea valen su versión.
+ */
+static bool consistent(const ParameterStore::Snapshot& snapshot, size_t n) {
+    const float expected = static_cast<float>(snapshot.version());
+    const float* p = snapshot.parameters();
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool consistencyTest(double seconds, int numReaders) {
+    // Red algo más ancha que la del vehículo para que copiar una versión lleve tiempo
+    const std::vector<int> topology = {16, 64, 16};
+    NeuralNetwork trainer(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    std::vector<std::vector<float>> weights, biases;
+    for (size_t l = 0; l + 1 < topology.size(); l++) {
+        weights.emplace_back(topology[l] * topology[l + 1], 0.0f);
+        biases.emplace_back(topology[l + 1], 0.0f);
+    }
+    trainer.setWeights(weights, biases);
+
+    ParameterStore store(trainer);
+    const size_t n = store.parameterCount();
+    std::vector<float> ones(n, 1.0f);
+
+    std::atomic<bool> stop{false};
+    std::vector<ReaderStats> stats(numReaders);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numReaders; r++) {
+        readers.emplace_back([&, r] {
+            NeuralNetwork net(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+            std::vector<float> input(topology.front(), 0.5f);
+            std::vector<float> output(topology.back());
+            ReaderStats& s = stats[r];
+            while (!stop.load(std::memory_order_relaxed)) {
+                ParameterStore::Snapshot snapshot = store.acquire();
+                bool ok = consistent(snapshot, n) && snapshot.version() >= s.lastVersion;
+                net.forward(input.data(), output.data(), snapshot.parameters());
+                // De vez en cuando se retiene la instantánea para agotar las copias libres
+                if ((s.reads & 63) == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+                ok = ok && consistent(snapshot, n);
+                s.errors += ok ? 0 : 1;
+                s.lastVersion = snapshot.version();
+                s.reads++;
+            }
+        });
+    }
+
+    uint64_t published = 0;
+    uint64_t retries = 0;
+    Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                              std::chrono::duration<double>(seconds));
+    // La versión k tiene todos los parámetros a k (exacto en float hasta 2^24)
+    while (Clock::now() < end && published < (1u << 24) - 1) {
+        trainer.addToParameters(ones.data());
+        while (!store.publish(trainer)) {
+            retries++;
+            std::this_thread::yield();
+        }
+        published++;
+    }
+    stop.store(true);
+    for (std::thread& t : readers) {
+        t.join();
+    }
+
+    uint64_t reads = 0;
+    uint64_t errors = 0;
+    for (const ReaderStats& s : stats) {
+        reads += s.reads;
+        errors += s.errors;
+    }
+    std::printf("Consistencia: %d lectores, %llu lecturas, %llu versiones publicadas, "
+                "%llu publicaciones sin copia libre, %llu errores\n",
+                numReaders, static_cast<unsigned long long>(reads),
+                static_cast<unsigned long long>(published), static_cast<unsigned long long>(retries),
+                static_cast<unsigned long long>(errors));
+    return errors == 0 && store.version() == published;
+}
+
+enum class Scenario { NO_TRAINER, SNAPSHOTS, MUTEX };
+
+static void latencyTest(Scenario scenario, double seconds) {
+    const std::vector<int> topology = {4, 8, 4};
+    NeuralNetwork trainer(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    NeuralNetwork reader(topology, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    ParameterStore store(trainer);
+    std::mutex mutex;
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> steps{0};
+    std::thread trainerThread;
+    if (scenario != Scenario::NO_TRAINER) {
+        trainerThread = std::thread([&] {
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> distance(2.0f, 400.0f);
+            float input[4];
+            float target[4] = {1.0f, 0.0f, 1.0f, 0.0f};
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (float& x : input) x = distance(rng);
+                if (scenario == Scenario::MUTEX) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    trainer.trainStep(input, target, 1e-4f);
+                } else {
+                    trainer.trainStep(input, target, 1e-4f);
+                    store.publish(trainer);
+                }
+                steps.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    const float input[4] = {35.0f, 120.0f, 0.5f, 0.0f};
+    float output[4];
+    std::vector<uint32_t> samples;
+    samples.reserve(1 << 22);
+    Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                              std::chrono::duration<double>(seconds));
+    while (samples.size() < samples.capacity()) {
+        Clock::time_point start = Clock::now();
+        if (start >= end) break;
+        if (scenario == Scenario::MUTEX) {
+            std::lock_guard<std::mutex> lock(mutex);
+            trainer.forward(input, output);
+        } else {
+            ParameterStore::Snapshot snapshot = store.acquire();
+            reader.forward(input, output, snapshot.parameters());
+        }
+        samples.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+    }
+    stop.store(true);
+    if (trainerThread.joinable()) {
+        trainerThread.join();
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+    };
+    const char* name = (scenario == Scenario::NO_TRAINER) ? "sin entrenador"
+                     : (scenario == Scenario::SNAPSHOTS)  ? "instantáneas"
+                                                          : "mutex";
+    std::printf("  %-16s %10zu %8u %8u %9u %10u %12llu\n", name, samples.size(),
+                percentile(0.5), percentile(0.99), percentile(0.999), samples.back(),
+                static_cast<unsigned long long>(steps.load()));
+}
+
+int main(int argc, char** argv) {
+    double seconds = 2.0;
+    int numReaders = std::max(2, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--segundos") && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--lectores") && hasValue) {
+            numReaders = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "Uso: %s [--segundos 2] [--lectores N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = consistencyTest(seconds, numReaders);
+
+    std::printf("Latencia de una inferencia {4,8,4} (ns):\n");
+    std::printf("  %-16s %10s %8s %8s %9s %10s %12s\n", "escenario", "muestras", "p50", "p99",
+                "p99.9", "max", "pasos entr.");
+    latencyTest(Scenario::NO_TRAINER, seconds);
+    latencyTest(Scenario::SNAPSHOTS, seconds);
+    latencyTest(Scenario::MUTEX, seconds);
+
+    std::printf("%s\n", ok ? "OK" : "FALLO: instantánea inconsistente");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// -----------------------------------------------------------------------------
+// Exportador disperso (herramienta de PC, no se compila para el ESP32)
+//
+// Poda por magnitud los pesos de 'pesos_red_neuronal.h', elimina las neuronas
+// muertas y escribe en stdout un encabezado con el modelo en formato CSR listo
+// para `SparseNetwork`. El informe de precisión va a stderr.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/sparse_export/sparse_export.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp src/SparseNetwork.cpp src/Actions.cpp -o sparse_export
+//
+// Uso:
+//   ./sparse_export [--poda 0.5] [evaluacion.csv]
+//       > lib/pesos_red_neuronal/pesos_red_neuronal_sparse.h
+//
+// `--poda` es la fracción de pesos de cada capa que se anula (0 por defecto: solo
+// se descartan los ceros exactos y las neuronas muertas). El CSV sigue el formato
+// de la salida serial (4 primeras columnas: distancias y duraciones); sin CSV se
+// usa la misma rejilla de entradas que `tools/activation_check`.
+// -----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Actions.h"
+#include "NeuralNetwork.h"
+#include "SparseNetwork.h"
+#include "pesos_red_neuronal.h"
+
+static std::vector<std::vector<float>> readCsv(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", path);
+        std::exit(1);
+    }
+
+    std::vector<std::vector<float>> rows;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<float> row;
+        while (row.size() < 4 && std::getline(ss, cell, ',')) {
+            char* end = nullptr;
+            float value = std::strtof(cell.c_str(), &end);
+            if (end == cell.c_str()) {
+                break; // Encabezado u otra línea no numérica
+            }
+            row.push_back(value);
+        }
+        if (row.size() == 4) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+static std::vector<std::vector<float>> sensorGrid() {
+    std::vector<float> distances = {-1.0f};
+    for (float d = 2.0f; d <= 400.0f; d += 6.0f) distances.push_back(d);
+    const float durations[] = {0.0f, 0.1f, 0.5f, 1.0f, 3.0f, 10.0f};
+
+    std::vector<std::vector<float>> rows;
+    for (float left : distances) {
+        for (float right : distances) {
+            for (float dl : durations) {
+                for (float dr : durations) {
+                    rows.push_back({left, right, dl, dr});
+                }
+            }
+        }
+    }
+    return rows;
+}
+
+static std::string formatFloat(float x) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", x);
+    std::string text = buf;
+    // "0f" o "-2f" no son literales válidos: los enteros necesitan el punto decimal
+    if (text.find_first_of(".eEn") == std::string::npos) {
+        text += ".0";
+    }
+    return text + "f";
+}
+
+template <typename T, typename F>
+static void writeArray(const char* type, const char* name, int index, const T* data, size_t n, F format) {
+    std::printf("static const %s %s_%d[] = {\n", type, name, index);
+    if (n == 0) {
+        // C++ no admite arreglos vacíos: un elemento de relleno que nunca se lee
+        std::printf("0\n");
+    }
+    for (size_t i = 0; i < n; i++) {
+        std::printf("%s%s", format(data[i]).c_str(), (i + 1 < n) ? ", " : "\n");
+    }
+    std::printf("};\n\n");
+}
+
+static std::string formatInt(long x) {
+    return std::to_string(x);
+}
+
+static const char* activationName(ActivationFunction act) {
+    switch (act) {
+        case ActivationFunction::RELU:    return "ActivationFunction::RELU";
+        case ActivationFunction::SIGMOID: return "ActivationFunction::SIGMOID";
+        case ActivationFunction::TANH:    return "ActivationFunction::TANH";
+        case ActivationFunction::LINEAR:
+        default:                          return "ActivationFunction::LINEAR";
+    }
+}
+
+static void writeHeader(const SparseModel& model, float sparsity) {
+    std::printf("#ifndef PESOS_RED_NEURONAL_SPARSE_H\n#define PESOS_RED_NEURONAL_SPARSE_H\n\n");
+    std::printf("// Generado por tools/sparse_export a partir de pesos_red_neuronal.h (poda %.2f)\n\n",
+                sparsity);
+    std::printf("#include \"SparseNetwork.h\"\n\n");
+
+    for (int l = 0; l < model.numLayers; l++) {
+        const SparseLayer& layer = model.layers[l];
+        const size_t nnz = layer.rowStart[layer.inSize];
+        std::printf("// Capa %d (%d -> %d, %zu pesos no nulos)\n", l, layer.inSize, layer.outSize, nnz);
+        writeArray("uint32_t", "FILAS_DISP_CAPA", l, layer.rowStart, layer.inSize + 1,
+                   [](uint32_t x) { return formatInt(static_cast<long>(x)); });
+        writeArray("uint16_t", "COLUMNAS_DISP_CAPA", l, layer.columns, nnz,
+                   [](uint16_t x) { return formatInt(static_cast<long>(x)); });
+        writeArray("float", "PESOS_DISP_CAPA", l, layer.values, nnz, formatFloat);
+        writeArray("float", "SESGOS_DISP_CAPA", l, layer.biases, layer.outSize, formatFloat);
+    }
+
+    std::printf("static const SparseLayer CAPAS_DISP[] = {\n");
+    for (int l = 0; l < model.numLayers; l++) {
+        const SparseLayer& layer = model.layers[l];
+        std::printf("    {%d, %d, %s, FILAS_DISP_CAPA_%d, COLUMNAS_DISP_CAPA_%d, PESOS_DISP_CAPA_%d, SESGOS_DISP_CAPA_%d},\n",
+                    layer.inSize, layer.outSize, activationName(layer.activation), l, l, l, l);
+    }
+    std::printf("};\n\n");
+    std::printf("static const SparseModel MODELO_DISP = {%d, CAPAS_DISP};\n\n", model.numLayers);
+    std::printf("#endif // PESOS_RED_NEURONAL_SPARSE_H\n");
+}
+
+int main(int argc, char** argv) {
+    const char* evaluationPath = nullptr;
+    float sparsity = 0.0f;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--poda") == 0 && i + 1 < argc) {
+            sparsity = std::strtof(argv[++i], nullptr);
+        } else {
+            evaluationPath = argv[i];
+        }
+    }
+    if (sparsity < 0.0f || sparsity > 1.0f) {
+        std::fprintf(stderr, "Uso: %s [--poda 0..1] [evaluacion.csv]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<float>> evaluation = evaluationPath ? readCsv(evaluationPath) : sensorGrid();
+    if (evaluation.empty()) {
+        std::fprintf(stderr, "El CSV no contiene filas válidas de 4 entradas.\n");
+        return 1;
+    }
+
+    // Misma red que en src/main.cpp
+    NeuralNetwork redNeuronal({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    redNeuronal.setWeights(
+        {std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+         std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))},
+        {std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+         std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))});
+
+    NeuralNetwork podada = redNeuronal;
+    size_t zeros = pruneByMagnitude(podada, sparsity);
+    SparseNetwork sparse = SparseNetwork::fromNetwork(podada);
+    writeHeader(sparse.model(), sparsity);
+
+    // Informe de precisión frente a la red densa original y a la podada
+    size_t actionMatches = 0;
+    size_t motorMatches = 0;
+    float maxAbsError = 0.0f;
+    float maxConversionError = 0.0f;
+    for (const std::vector<float>& input : evaluation) {
+        std::vector<float> denseOut = redNeuronal.forward(input);
+        std::vector<float> prunedOut = podada.forward(input);
+        std::vector<float> sparseOut = sparse.forward(input);
+        if (findClosestMatch(denseOut, targetOptions) == findClosestMatch(sparseOut, targetOptions)) {
+            actionMatches++;
+        }
+        for (size_t i = 0; i < denseOut.size(); i++) {
+            motorMatches += ((denseOut[i] > 0.5f) == (sparseOut[i] > 0.5f)) ? 1 : 0;
+            maxAbsError = std::max(maxAbsError, std::fabs(denseOut[i] - sparseOut[i]));
+            maxConversionError = std::max(maxConversionError, std::fabs(prunedOut[i] - sparseOut[i]));
+        }
+    }
+
+    size_t totalWeights = sizeof(PESOS_CAPA_0) / sizeof(float) + sizeof(PESOS_CAPA_1) / sizeof(float);
+    size_t floatBytes = sizeof(PESOS_CAPA_0) + sizeof(PESOS_CAPA_1) + sizeof(SESGOS_CAPA_0) + sizeof(SESGOS_CAPA_1);
+    const SparseModel& model = sparse.model();
+    std::fprintf(stderr, "Poda: %zu de %zu pesos nulos, %zu no nulos tras eliminar neuronas muertas\n",
+                 zeros, totalWeights, sparse.nonZeros());
+    std::fprintf(stderr, "Topología: %d", model.layers[0].inSize);
+    for (int l = 0; l < model.numLayers; l++) {
+        std::fprintf(stderr, " -> %d", model.layers[l].outSize);
+    }
+    std::fprintf(stderr, "\nEvaluación: %zu muestras (%s)\n", evaluation.size(),
+                 evaluationPath ? evaluationPath : "rejilla");
+    std::fprintf(stderr, "Acuerdo de findClosestMatch: %.2f %%\n", 100.0 * actionMatches / evaluation.size());
+    std::fprintf(stderr, "Acuerdo de motores (>0.5):   %.2f %%\n", 100.0 * motorMatches / (evaluation.size() * 4));
+    std::fprintf(stderr, "Error absoluto máximo:       %.6f (conversión: %.3g)\n", maxAbsError, maxConversionError);
+    std::fprintf(stderr, "Parámetros: %zu bytes densos -> %zu bytes dispersos\n", floatBytes, sparse.parameterBytes());
+    return 0;
+}
@@ -0,0 +1,145 @@
+// -----------------------------------------------------------------------------
+// Comprobación de StaticNetwork frente a NeuralNetwork (herramienta de PC, no se
+// compila para el ESP32)
+//
+// Instancia `StaticNetwork<4, 8, 4, RELU, SIGMOID>` sobre los arreglos de
+// 'pesos_red_neuronal.h' (como un `constexpr`, igual que se declararía en flash)
+// y compara su salida bit a bit con `NeuralNetwork::forward` de la red del
+// vehículo, con los pesos cargados por `setWeights` (como en main.cpp) y
+// prestados con `borrowWeights`:
+// - rejilla de distancias y duraciones, incluida la lectura sin eco (-1) del
+//   HCSR04 en una o ambas distancias,
+// - y entradas pseudoaleatorias dentro del rango de los sensores.
+//
+// Se compila con gnu++11, el estándar del ESP32, para que la plantilla se pruebe
+// con las mismas reglas de `constexpr` que en el vehículo.
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++11 -O2 -Iinclude -Ilib/pesos_red_neuronal
+//       tools/static_check/static_check.cpp src/NeuralNetwork.cpp src/Kernels.cpp
+//       src/Activations.cpp -o static_check
+//
+// Uso:
+//   ./static_check [aleatorias]     (por defecto 100000 entradas aleatorias)
+//
+// Devuelve 1 si alguna salida difiere.
+// -----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "NeuralNetwork.h"
+#include "StaticNetwork.h"
+#include "pesos_red_neuronal.h"
+
+typedef StaticNetwork<4, 8, 4, ActivationFunction::RELU, ActivationFunction::SIGMOID> VehicleNetwork;
+
+static constexpr VehicleNetwork g_static(PESOS_CAPA_0, SESGOS_CAPA_0, PESOS_CAPA_1, SESGOS_CAPA_1);
+
+static const float DISTANCES[] = {-1.0f, 0.0f, 2.0f, 5.5f, 17.0f, 60.0f, 150.0f, 399.9f};
+static const float DURATIONS[] = {0.0f, 0.001f, 0.25f, 1.53f, 3.47f, 10.0f, 60.0f};
+
+/**
+ * @brief Compara ambas redes sobre `input`; cuenta la discrepancia e imprime las
+ *        primeras.
+ */
+static void compare(const char* what, NeuralNetwork& network, const float* input,
+                    unsigned long& checked, unsigned long& mismatches) {
+    float expected[4];
+    float actual[4];
+    network.forward(input, expected);
+    g_static.forward(input, actual);
+    checked++;
+    if (std::memcmp(expected, actual, sizeof(expected)) != 0) {
+        if (mismatches < 5) {
+            std::printf("  %s: (%g, %g, %g, %g) -> NeuralNetwork (%.9g, %.9g, %.9g, %.9g), "
+                        "StaticNetwork (%.9g, %.9g, %.9g, %.9g)\n",
+                        what, input[0], input[1], input[2], input[3],
+                        expected[0], expected[1], expected[2], expected[3],
+                        actual[0], actual[1], actual[2], actual[3]);
+        }
+        mismatches++;
+    }
+}
+
+/**
+ * @brief Recorre la rejilla y las entradas aleatorias con `network`.
+ * @return Número de discrepancias.
+ */
+static unsigned long sweep(const char* what, NeuralNetwork& network, int randomInputs) {
+    const int numDistances = sizeof(DISTANCES) / sizeof(DISTANCES[0]);
+    const int numDurations = sizeof(DURATIONS) / sizeof(DURATIONS[0]);
+    unsigned long checked = 0;
+    unsigned long mismatches = 0;
+    unsigned long sentinel = 0;
+    float input[4];
+
+    for (int left = 0; left < numDistances; left++) {
+        for (int right = 0; right < numDistances; right++) {
+            for (int leftTime = 0; leftTime < numDurations; leftTime++) {
+                for (int rightTime = 0; rightTime < numDurations; rightTime++) {
+                    input[0] = DISTANCES[left];
+                    input[1] = DISTANCES[right];
+                    input[2] = DURATIONS[leftTime];
+                    input[3] = DURATIONS[rightTime];
+                    if (input[0] < 0.0f || input[1] < 0.0f) {
+                        sentinel++;
+                    }
+                    compare(what, network, input, checked, mismatches);
+                }
+            }
+        }
+    }
+
+    // Generador congruencial fijo: la comprobación es reproducible
+    uint32_t state = 0x2545F491u;
+    for (int n = 0; n < randomInputs; n++) {
+        for (int i = 0; i < 4; i++) {
+            state = state * 1664525u + 1013904223u;
+            float unit = static_cast<float>(state >> 8) / 16777216.0f;
+            input[i] = (i < 2) ? unit * 401.0f - 1.0f : unit * 60.0f;
+        }
+        // Una de cada ocho lecturas de distancia sin eco (bits altos: los bajos del
+        // generador tienen periodo corto)
+        if (((state >> 28) & 0x7u) == 0) {
+            input[(state >> 27) & 0x1u] = -1.0f;
+            sentinel++;
+        }
+        compare(what, network, input, checked, mismatches);
+    }
+
+    std::printf("  %-22s %10lu %10lu %12lu\n", what, checked, sentinel, mismatches);
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    int randomInputs = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    if (randomInputs < 0) randomInputs = 100000;
+
+    const std::vector<std::vector<float>> weights = {
+        std::vector<float>(PESOS_CAPA_0, PESOS_CAPA_0 + sizeof(PESOS_CAPA_0) / sizeof(float)),
+        std::vector<float>(PESOS_CAPA_1, PESOS_CAPA_1 + sizeof(PESOS_CAPA_1) / sizeof(float))
+    };
+    const std::vector<std::vector<float>> biases = {
+        std::vector<float>(SESGOS_CAPA_0, SESGOS_CAPA_0 + sizeof(SESGOS_CAPA_0) / sizeof(float)),
+        std::vector<float>(SESGOS_CAPA_1, SESGOS_CAPA_1 + sizeof(SESGOS_CAPA_1) / sizeof(float))
+    };
+
+    std::printf("StaticNetwork<4, 8, 4> frente a NeuralNetwork::forward (bit a bit):\n");
+    std::printf("  %-22s %10s %10s %12s\n", "pesos", "entradas", "con -1", "diferencias");
+
+    unsigned long mismatches = 0;
+
+    NeuralNetwork owned({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    owned.setWeights(weights, biases);
+    mismatches += sweep("setWeights", owned, randomInputs);
+
+    NeuralNetwork borrowed({4, 8, 4}, ActivationFunction::RELU, ActivationFunction::SIGMOID);
+    borrowed.borrowWeights({PESOS_CAPA_0, PESOS_CAPA_1}, {SESGOS_CAPA_0, SESGOS_CAPA_1});
+    mismatches += sweep("borrowWeights", borrowed, randomInputs);
+
+    std::printf("%s\n", mismatches == 0 ? "OK" : "FALLO: StaticNetwork no coincide con NeuralNetwork");
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// -----------------------------------------------------------------------------
+// Decodificador de telemetría (herramienta de PC, no se compila para el ESP32)
+//
+// Convierte la captura binaria del puerto serie (registros de Telemetry.h) al CSV
+// que usan los scripts de entrenamiento:
+//   distancia_izquierda,distancia_derecha,duracion_izquierda,duracion_derecha,IN1,IN2,IN3,IN4
+//
+// Compilación (desde la raíz del repositorio):
+//   g++ -std=gnu++17 -O2 -Iinclude tools/telemetry_decoder/decode_telemetry.cpp
+//       src/Crc32.cpp -o decode_telemetry
+//
+// Uso:
+//   ./decode_telemetry [captura.bin] [--extendido] > datos.csv
+//
+// Sin archivo lee de stdin. `--extendido` añade tiempo_ms, accion, las cuatro
+// salidas de la red y el error. Se resincroniza tras bytes corruptos o texto
+// (busca la palabra de sincronismo y valida el CRC); el resumen de registros,
+// errores de CRC y registros perdidos (huecos de secuencia) va a stderr.
+// -----------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Crc32.h"
+#include "Telemetry.h"
+
+static std::vector<uint8_t> readAll(FILE* file) {
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    return data;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool extended = false;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--extendido")) {
+            extended = true;
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            std::fprintf(stderr, "Uso: %s [captura.bin] [--extendido]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* file = (path != nullptr) ? std::fopen(path, "rb") : stdin;
+    if (file == nullptr) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> data = readAll(file);
+    if (file != stdin) std::fclose(file);
+
+    std::printf("distancia_izquierda,distancia_derecha,duracion_izquierda,duracion_derecha,IN1,IN2,IN3,IN4");
+    if (extended) std::printf(",tiempo_ms,accion,salida1,salida2,salida3,salida4,error");
+    std::printf("\n");
+
+    size_t records = 0, crcErrors = 0, skippedBytes = 0, lost = 0;
+    bool haveSequence = false;
+    uint32_t nextSequence = 0;
+
+    const uint8_t sync0 = TELEMETRY_SYNC & 0xFF;
+    const uint8_t sync1 = TELEMETRY_SYNC >> 8;
+    size_t pos = 0;
+    while (pos + sizeof(TelemetryRecord) <= data.size()) {
+        if (data[pos] != sync0 || data[pos + 1] != sync1 || data[pos + 2] != TELEMETRY_VERSION) {
+            pos++;
+            skippedBytes++;
+            continue;
+        }
+
+        TelemetryRecord record;
+        std::memcpy(&record, &data[pos], sizeof(record));
+        if (crc32(&record, TELEMETRY_CRC_OFFSET) != record.crc) {
+            crcErrors++;
+            pos++;
+            skippedBytes++;
+            continue;
+        }
+        pos += sizeof(TelemetryRecord);
+        records++;
+
+        if (haveSequence && record.sequence != nextSequence) {
+            lost += record.sequence - nextSequence;
+        }
+        haveSequence = true;
+        nextSequence = record.sequence + 1;
+
+        std::printf("%.2f,%.2f,%.2f,%.2f", record.inputs[0], record.inputs[1],
+                    record.inputs[2], record.inputs[3]);
+        for (int i = 0; i < 4; i++) {
+            std::printf(",%d", (record.motors >> i) & 1);
+        }
+        if (extended) {
+            std::printf(",%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f", record.timestampMs, record.action,
+                        record.outputs[0], record.outputs[1], record.outputs[2],
+                        record.outputs[3], record.loss);
+        }
+        std::printf("\n");
+    }
+    skippedBytes += data.size() - pos;
+
+    std::fprintf(stderr, "registros: %zu  errores CRC: %zu  bytes descartados: %zu  perdidos: %zu\n",
+                 records, crcErrors, skippedBytes, lost);
+    return 0;
+}